@@ -1,15 +1,24 @@
 #include "PandaAnalysis/Flat/interface/AnalyzerUtilities.h"
 #include "PandaAnalysis/Flat/interface/BTagTree.h"
 #include "PandaAnalysis/Flat/interface/BTagTreeBuilder.h"
+#include "PandaAnalysis/Flat/interface/ColumnReader.h"
+#include "PandaAnalysis/Flat/interface/Declustering.h"
+#include "PandaAnalysis/Flat/interface/DeltaRMatrix.h"
+#include "PandaAnalysis/Flat/interface/EnergyCorrelations.h"
+#include "PandaAnalysis/Flat/interface/FlavourLabeller.h"
 #include "PandaAnalysis/Flat/interface/GenAnalyzer.h"
 #include "PandaAnalysis/Flat/interface/GeneralTree.h"
 #include "PandaAnalysis/Flat/interface/GeneralLeptonicTree.h"
 #include "PandaAnalysis/Flat/interface/JetCorrector.h"
 #include "PandaAnalysis/Flat/interface/KFactorTree.h"
 #include "PandaAnalysis/Flat/interface/LimitTreeBuilder.h"
+#include "PandaAnalysis/Flat/interface/NumpyWriter.h"
 #include "PandaAnalysis/Flat/interface/PandaAnalyzer.h"
 #include "PandaAnalysis/Flat/interface/PandaLeptonicAnalyzer.h"
 #include "PandaAnalysis/Flat/interface/SFTreeBuilder.h"
+#include "PandaAnalysis/Flat/interface/TriggerMenu.h"
+#include "PandaAnalysis/Flat/interface/TriggerObjectMatcher.h"
+#include "PandaAnalysis/Flat/interface/LumiMask.h"
 #include "PandaAnalysis/Flat/interface/genericTree.h"
 
 
@@ -27,23 +36,36 @@
 #pragma link C++ enum PandaAnalyzer::PreselectionBit;
 #pragma link C++ enum PandaAnalyzer::ProcessType;
 #pragma link C++ enum PandaAnalyzer::TriggerBits;
+#pragma link C++ enum PandaAnalyzer::ReclusterMode;
 #pragma link C++ enum GeneralTree::BTagShift;
 #pragma link C++ enum GeneralTree::BTagJet;
 #pragma link C++ enum GeneralTree::BTagTags;
 
-#pragma link C++ class LumiRange;
+#pragma link C++ class LumiMask;
+#pragma link C++ class LumiEntryIndex;
 #pragma link C++ class THCorr;
 #pragma link C++ class btagcand;
 #pragma link C++ class JetCorrector;
+#pragma link C++ class ECFCalculator;
+#pragma link C++ class JetDeclusterer;
+#pragma link C++ class EtaPhiArrays;
+#pragma link C++ class BitMask;
+#pragma link C++ class DeltaRMatrix;
+#pragma link C++ class TriggerMenu;
+#pragma link C++ class TriggerObjectMatcher;
+#pragma link C++ class FlavourLabeller;
+#pragma link C++ class NumpyWriter;
+#pragma link C++ class ColumnReader;
 #pragma link C++ class PandaAnalyzer;
 #pragma link C++ class PandaLeptonicAnalyzer;
 #pragma link C++ class GenAnalyzer;
 #pragma link C++ class BTagTreeBuilder;
 #pragma link C++ class SFTreeBuilder;
 #pragma link C++ class BTagTree;
+#pragma link C++ class GeneralTreeBlock;
 #pragma link C++ class GeneralTree;
 #pragma link C++ class GeneralTree::ECFParams;
-#pragma link C++ class GeneralTree::BTagParams;
+#pragma link C++ class GeneralLeptonicTreeBlock;
 #pragma link C++ class GeneralLeptonicTree;
 #pragma link C++ class KFactorTree;
 #pragma link C++ class genericTree;
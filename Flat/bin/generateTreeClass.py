@@ -2,7 +2,8 @@
 
 from sys import argv,exit
 from os import system
-from re import sub
+from re import sub,findall,compile,match
+from itertools import product,groupby
 import argparse
 
 parser = argparse.ArgumentParser(description='build object from configuration')
@@ -14,51 +15,151 @@ suffixes = { 'float':'F',
              'int':'I',
              'uint':'i',
              'uint64':'l',
+             'ULong64_t':'l',
            }
 ctypes = {    
             'uint':'unsigned int',
             'float':'float',
             'int':'int',
-            'uint64':'ULong64_t'
+            'uint64':'ULong64_t',
+            'ULong64_t':'ULong64_t',
          }
 
+def reset_value(name,dtype):
+    if 'sf_' in name:
+        return '1'
+    elif dtype=='float':
+        return '-1'
+    else:
+        return '0'
+
 class Branch:
-    def __init__(self,name,dtype):
+    # a scalar, or with dtype[size] (e.g. scale float[6] =1) a fixed-size
+    # array, of which all size entries are written and reset
+    def __init__(self,name,dtype,default=None):
         self.name = name
-        self.dtype = dtype
-        self.suffix = ''
-        try:
-            self.suffix = '/'+suffixes[sub('\[.*\]','',dtype)]
-            if '[' in dtype:
-                self.suffix = '[%s]%s'%(counter,self.suffix)
-        except KeyError:
-            # must be a TObject
-            self.suffix = dtype
+        m = match('(\w+)\[(\w+)\]',dtype)
+        self.dtype,self.size = m.groups() if m else (dtype,None)
+        self.default = default if default is not None else reset_value(name,self.dtype)
+        self.suffix = '/'+suffixes[self.dtype]
     def create_def(self):
-        if '[' in self.dtype:
-            basedtype = sub('\[.*\]','',self.dtype)
-            basectype = ctypes[basedtype]
-            return '    %s %s;\n'%(self.dtype.replace(basedtype,basectype),self.name)
+        if self.size:
+            init = '' if self.default=='0' else ','.join([self.default]*resolve(self.size))
+            return '%s %s[%s] = {%s};\n'%(ctypes[self.dtype],self.name,self.size,init)
+        return '%s %s = %s;\n'%(ctypes[self.dtype],self.name,self.default)
+    def create_write(self):
+        if self.size:
+            return '    Book("{0}",{0},"{0}[{1}]{2}");\n'.format(self.name,resolve(self.size),self.suffix)
+        return '    Book("{0}",&{0},"{0}{1}");\n'.format(self.name,self.suffix)
+
+class Family:
+    # an indexed family of scalar branches, configured as
+    #   name[dim1:v0,v1,...][dim2:...] dtype branchpattern
+    # e.g. sf_btags[jet:,sj][tag:0,1,2,GT0] float sf_{jet}btag{tag}
+    # is stored as one flat array with a constexpr nameIndex(dim1,dim2,...),
+    # and each element is booked as the pattern filled with its values.
+    # a dimension written dim:@SIZE has SIZE slots whose values are only
+    # known at run time: the tree provides std::vector<TString> dimValues(),
+    # and only that many slots are booked. with an array dtype, e.g.
+    # float[nfj:NFATJET], every element is a counter-indexed array, which
+    # like Array is kept out of the reset block
+    def __init__(self,spec,dtype,pattern,default=None):
+        self.name = spec[:spec.index('[')]
+        self.dims = []
+        for d in findall('\[([^\]]*)\]',spec):
+            label,values = d.split(':')
+            if values[0]=='@':
+                self.dims.append((label,None,values[1:]))
+            else:
+                self.dims.append((label,values.split(','),str(len(values.split(',')))))
+        m = match('(\w+)\[(\w+):(\w+)\]',dtype)
+        if m:
+            self.dtype,self.counter,self.capacity = m.groups()
         else:
-            return '    %s %s = -1;\n'%(ctypes[self.dtype],self.name)
-    def create_constructor(self):
-        return '' # do we need anything here?
-    def create_reset(self):
-        # only handle singletons for now
-        if 'sf_' in self.name:
-            val = 1;
-        elif self.dtype=='float':
-            val = -1
+            self.dtype,self.counter,self.capacity = dtype,None,None
+        self.pattern = pattern
+        self.size = 1
+        for _,_,length in self.dims:
+            self.size *= resolve(length)
+        self.default = default if default is not None else reset_value(self.name,self.dtype)
+        self.suffix = '/'+suffixes[self.dtype]
+    def runtime(self):
+        return [l for l,v,_ in self.dims if v is None]
+    def elements(self):
+        # (index expression, name expression) of the elements booked for one
+        # set of runtime values, which are bound to the variables s<dim>
+        static = [(l,v) for l,v,_ in self.dims if v is not None]
+        for values in product(*[list(enumerate(v)) for _,v in static]):
+            fmt = dict([(l,'"+s%s+"'%l) for l in self.runtime()])
+            fmt.update(dict(zip([l for l,_ in static],[v for _,v in values])))
+            bname = ('"%s"'%self.pattern.format(**fmt)).replace('""+','').replace('+""','')
+            if not self.runtime():
+                i = 0
+                for (_,_,length),(pos,_) in zip(self.dims,values):
+                    i = i*int(length)+pos
+                yield str(i),bname
+            else:
+                pos = dict(zip([l for l,_ in static],[p for p,_ in values]))
+                args = [l if v is None else str(pos[l]) for l,v,_ in self.dims]
+                yield '%sIndex(%s)'%(self.name,','.join(args)),bname
+    def create_def(self):
+        index = self.dims[0][0]
+        for label,_,length in self.dims[1:]:
+            if '+' in index:
+                index = '(%s)'%index
+            index = '%s*%s+%s'%(index,length,label)
+        args = ', '.join(['int %s'%l for l,_,_ in self.dims])
+        if self.counter:
+            s = '%s %s[%i][%s];\n'%(ctypes[self.dtype],self.name,self.size,self.capacity)
         else:
-            val = 0
-        return '    %s = %i;\n'%(self.name,val)
-    def create_read(self):
-        return '' # not implemented anymore
+            s = '%s %s[%i] = {%s};\n'%(ctypes[self.dtype],self.name,self.size,
+                                       ','.join([self.default]*self.size))
+        return s + '    static constexpr int %sIndex(%s) { return %s; }\n'%(self.name,args,index)
+    def create_pad(self):
+        return '      std::fill(&%s[0][0],&%s[0][0]+%i*%s,%s);\n'%(self.name,self.name,self.size,
+                                                                 self.capacity,self.default)
+    def create_entry_reset(self):
+        return '      for (int e=0; e!=%i; ++e) %s[e][i] = %s;\n'%(self.size,self.name,self.default)
     def create_write(self):
-        if '[' in self.dtype:
-            return '' # now I'm just being lazy
-        else:
-            return '    Book("{0}",&{0},"{0}{1}");\n'.format(self.name,self.suffix)
+        s = ''
+        for i,bname in self.elements():
+            if not self.counter:
+                if self.runtime():
+                    s += '    Book({0},&{1}[{2}],{0}+"{3}");\n'.format(bname,self.name,i,self.suffix)
+                else:
+                    s += '    Book("{0}",&{1}[{2}],"{0}{3}");\n'.format(bname.strip('"'),self.name,i,self.suffix)
+            else:
+                s += ('    Book({0},{1}[{2}],TString({0})+(fixedArrays ? TString::Format("[%i]{3}",{4})'
+                      ' : TString("[{5}]{3}")));\n').format(bname,self.name,i,self.suffix,
+                                                            self.capacity,self.counter)
+        # one loop per runtime dimension, outermost first
+        for label in reversed(self.runtime()):
+            s = ('    for (int {0}=0; {0}!=int({0}Values().size()); ++{0}) {{\n'
+                 '      TString s{0} = {0}Values()[{0}];\n').format(label) + \
+                ''.join(['  '+l for l in s.splitlines(True)]) + '    }\n'
+        return s
+
+class Array:
+    # a counter-indexed array, configured as
+    #   name dtype[counter:capacity]
+    # e.g. jetPt float[nJotStored:NJET] =-99
+    # only the first counter entries are written, unless the tree sets
+    # fixedArrays, in which case all capacity entries are written and the
+    # unfilled ones hold the default. it is not part of the reset block
+    def __init__(self,name,dtype,default=None):
+        self.name = name
+        self.dtype,self.counter,self.capacity = match('(\w+)\[(\w+):(\w+)\]',dtype).groups()
+        self.default = default if default is not None else reset_value(name,self.dtype)
+        self.suffix = '/'+suffixes[self.dtype]
+    def create_def(self):
+        return '%s %s[%s];\n'%(ctypes[self.dtype],self.name,self.capacity)
+    def create_pad(self):
+        return '      std::fill(%s,%s+%s,%s);\n'%(self.name,self.name,self.capacity,self.default)
+    def create_entry_reset(self):
+        return '      %s[i] = %s;\n'%(self.name,self.default)
+    def create_write(self):
+        return ('    Book("{0}",{0},fixedArrays ? TString::Format("{0}[%i]{1}",{2})'
+                ' : TString("{0}[{3}]{1}"));\n').format(self.name,self.suffix,self.capacity,self.counter)
 
 def get_template(path):
     with open(path) as ftmpl:
@@ -69,6 +170,17 @@ def get_template(path):
 cfg_path = args.cfg
 header_path = cfg_path.replace('config','interface').replace('.cfg','.h')
 def_path = cfg_path.replace('config','src').replace('.cfg','.cc')
+class_name = header_path.split('/')[-1].replace('.h','')
+block_name = class_name+'Block'
+
+# integer #defines of the header, which size the runtime family dimensions
+defines = {}
+for line in get_template(header_path):
+    m = match('#define\s+(\w+)\s+(\d+)\s*$',line)
+    if m:
+        defines[m.group(1)] = int(m.group(2))
+def resolve(length):
+    return int(length) if length.isdigit() else defines[length]
 
 predefined = set([]) # if something is in CUSTOM, ignore it
 custom = False
@@ -77,6 +189,8 @@ for line in get_template(header_path):
     if 'STARTCUSTOMDEF' in line:
         custom = True
         continue
+    if 'ENDCUSTOMDEF' in line:
+        break
     if custom:
         members = line.strip()
         for pattern in repl:
@@ -85,42 +199,145 @@ for line in get_template(header_path):
         for m in members:
             predefined.add(m)
 
+custom_writes = set([]) # booked by hand, e.g. only for some analyses
+custom = False
+for line in get_template(def_path):
+    if 'STARTCUSTOMWRITE' in line:
+        custom = True
+    elif 'ENDCUSTOMWRITE' in line:
+        break
+    elif custom:
+        custom_writes.update(findall('Book\("(\w+)"',line))
+
 
+# every configured branch is stored in one trivially copyable block; its
+# default-constructed value is the reset image, so Reset() is a single copy.
+# the block is aligned on genericTree::blockAlignment, which genericTree's
+# operator new honours. branches matching an "@cold <regex>" line (e.g.
+# systematic variations) are placed after the others, from a new cache
+# line, so the per-event hot path touches fewer lines.
+# "@precision <regex> <bits>" (or <min>,<max>,<bits>) stores the matching
+# float branches as Float16_t; see genericTree::SetPrecision
 branches = []
+cold_patterns = []
+precisions = []
 for line in get_template(cfg_path):
     line = line.strip()
-    if line[0]=='#':
+    if not line or line[0]=='#':
+        continue
+    tokens = line.split()
+    if tokens[0]=='@cold':
+        cold_patterns.append(compile(tokens[1]))
         continue
-    name,dtype = line.split()
-    if name in predefined:
+    if tokens[0]=='@precision':
+        precisions.append((tokens[1],tokens[2].split(',')))
         continue
-    print 'Adding new variable %s %s'%(dtype,name)
-    branches.append( Branch(name,dtype) )
+    # optional trailing =default and if:flag, the latter booking only if the flag is set
+    default = None
+    guard = None
+    while tokens[-1][0]=='=' or tokens[-1].startswith('if:'):
+        t = tokens.pop()
+        if t[0]=='=':
+            default = t[1:]
+        else:
+            guard = t[3:]
+    name,dtype = tokens[:2]
+    if sub('\[.*\]','',name) in predefined:
+        continue
+    if len(tokens)>2:
+        b = Family(name,dtype,tokens[2],default)
+    elif ':' in dtype:
+        b = Array(name,dtype,default)
+    else:
+        b = Branch(name,dtype,default)
+    b.guard = guard
+    branches.append(b)
 
+# counter-indexed arrays, and families of them, are not part of the block
+is_array = lambda b : isinstance(b,Array) or (isinstance(b,Family) and b.counter)
+arrays = [b for b in branches if is_array(b)]
+branches = [b for b in branches if not is_array(b)]
+for a in arrays:
+    if a.counter not in [b.name for b in branches] and a.counter not in predefined:
+        print 'Counter %s of %s is not configured'%(a.counter,a.name)
 
-header_lines = get_template(header_path)
-def_lines = get_template(def_path)
+is_cold = lambda b : any([p.search(b.name) for p in cold_patterns])
+hot = [b for b in branches if not is_cold(b)]
+cold = [b for b in branches if is_cold(b)]
+print 'Generating %s with %i hot and %i cold members'%(block_name,len(hot),len(cold))
 
-for path in [header_path,def_path]:
-    system('cp {0} {0}.bkp'.format(path))
+def create_block():
+    s  = '// generated from %s\n'%cfg_path.split('/')[-1]
+    s += 'struct alignas(genericTree::blockAlignment) %s {\n'%block_name
+    for b in hot:
+        s += '    '+b.create_def()
+    if cold:
+        s += '    // filled only when their stage runs\n'
+        s += '    alignas(genericTree::blockAlignment) '+cold[0].create_def()
+        for b in cold[1:]:
+            s += '    '+b.create_def()
+    s += '};\n'
+    s += 'static_assert(std::is_trivially_copyable<%s>::value,"%s must be resettable by a copy");\n'%(block_name,block_name)
+    return s
 
-with open(header_path,'w') as fheader:
-    for line in header_lines:
-        fheader.write(line)
-        if '//ENDCUSTOMDEF' in line:
-            for b in branches:
-                fheader.write(b.create_def())
-
-with open(def_path,'w') as fdef:
-    for line in def_lines:
-        fdef.write(line)
-        if '//ENDCUSTOMCONST' in line:
-            for b in branches:
-                fdef.write(b.create_constructor())
-        elif '//ENDCUSTOMRESET' in line:
-            for b in branches:
-                fdef.write(b.create_reset())
-        elif '//ENDCUSTOMWRITE' in line:
-            for b in branches:
-                fdef.write(b.create_write())
+def create_precisions():
+    return ''.join(['    SetPrecision("%s",%s);\n'%(p,','.join(spec)) for p,spec in precisions])
+
+def create_reset():
+    s = ('    static const %s defaults{};\n'%block_name +
+         '    static_cast<%s&>(*this) = defaults;\n'%block_name)
+    if arrays:
+        s += '    if (fixedArrays) {\n'
+        s += ''.join([a.create_pad() for a in arrays])
+        s += '    }\n'
+    return s
+
+def create_arrays():
+    # the arrays are not reset with the block: an analyzer that does not set
+    # every array of an entry calls Reset<Counter>(i) before filling entry i
+    s = ''.join(['    '+a.create_def() for a in arrays])
+    counters = []
+    for a in arrays:
+        if a.counter not in counters:
+            counters.append(a.counter)
+    for c in counters:
+        s += '    //! the defaults of entry i of the arrays counted by %s\n'%c
+        s += '    void Reset%s(unsigned i) {\n'%(c[0].upper()+c[1:])
+        s += ''.join([a.create_entry_reset() for a in arrays if a.counter==c])
+        s += '    }\n'
+    return s
+
+def create_writes(bs):
+    # consecutive branches with the same guard share one if
+    s = ''
+    for guard,group in groupby(bs,lambda b : b.guard):
+        w = ''.join([b.create_write() for b in group])
+        if guard:
+            w = '    if (%s) {\n'%guard + ''.join(['  '+l for l in w.splitlines(True)]) + '    }\n'
+        s += w
+    return s
+
+# the generated regions are rewritten on every run, from the marker to the
+# end of the enclosing class or function
+def regenerate(path,regions):
+    lines = get_template(path)
+    system('cp {0} {0}.bkp'.format(path))
+    with open(path,'w') as fout:
+        skip_until = None
+        for line in lines:
+            if skip_until:
+                if not line.startswith(skip_until):
+                    continue
+                skip_until = None
+            fout.write(line)
+            for marker,text,end in regions:
+                if marker in line:
+                    fout.write(text)
+                    skip_until = end
 
+regenerate(header_path,[('//STARTGENERATEDBLOCK',create_block(),'//ENDGENERATEDBLOCK'),
+                        ('//ENDCUSTOMDEF',create_arrays(),'};')])
+regenerate(def_path,[('//ENDCUSTOMCONST',create_precisions(),'}'),
+                     ('//ENDCUSTOMRESET',create_reset(),'}'),
+                     ('//ENDCUSTOMWRITE',create_writes([b for b in branches+arrays
+                                                        if b.name not in custom_writes]),'}')])
@@ -0,0 +1,82 @@
+#include "PandaCore/Tools/interface/Common.h"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TString.h"
+#include "TStopwatch.h"
+#include "RVersion.h"
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,32,0)
+#if __has_include(<ROOT/RNTupleReader.hxx>)
+#include <ROOT/RNTupleReader.hxx>
+#else
+#include <ROOT/RNTuple.hxx>
+#endif
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,36,0)
+namespace rnt = ROOT;
+#else
+namespace rnt = ROOT::Experimental;
+#endif
+#endif
+
+#include <iostream>
+#include <vector>
+
+// reads a subset of the columns of every entry of the same output written
+// as a TTree and as an RNTuple, e.g. with and without ntupleOutput
+
+static void
+report(const char *backend, Long64_t n, TStopwatch &sw)
+{
+  PInfo("readBench",TString::Format("%-8s %lld entries in %.3f s real, %.3f s cpu (%.0f entries/s)",
+                                    backend,n,sw.RealTime(),sw.CpuTime(),
+                                    sw.RealTime()>0 ? n/sw.RealTime() : 0.));
+}
+
+int
+main(int argc, char const* argv[])
+{
+  if (argc < 5) {
+    std::cerr << "Usage: readBench tree.root ntuple.root name column [column ...]" << std::endl;
+    return 1;
+  }
+  TString name(argv[3]);
+  std::vector<TString> columns(argv+4,argv+argc);
+
+  TStopwatch sw;
+  TFile *fTree = TFile::Open(argv[1]);
+  TTree *t = fTree ? dynamic_cast<TTree*>(fTree->Get(name)) : 0;
+  if (!t) {
+    PError("readBench",TString("Could not read tree ")+name+" from "+argv[1]);
+    return 1;
+  }
+  t->SetBranchStatus("*",0);
+  for (auto &c : columns)
+    t->SetBranchStatus(c,1);
+  Long64_t nTree = t->GetEntries();
+  for (Long64_t iE=0; iE!=nTree; ++iE)
+    t->GetEntry(iE);
+  sw.Stop();
+  report("TTree",nTree,sw);
+  fTree->Close();
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,32,0)
+  sw.Start();
+  auto reader = rnt::RNTupleReader::Open(name.Data(),argv[2]);
+  std::vector<rnt::RNTupleView<void>> views;
+  for (auto &c : columns)
+    views.push_back(reader->GetView<void>(c.Data()));
+  Long64_t nNTuple = 0;
+  for (auto iE : reader->GetEntryRange()) {
+    for (auto &v : views)
+      v(iE);
+    ++nNTuple;
+  }
+  sw.Stop();
+  report("RNTuple",nNTuple,sw);
+#else
+  PError("readBench","Reading RNTuples needs ROOT 6.32 or later");
+#endif
+
+  return 0;
+}
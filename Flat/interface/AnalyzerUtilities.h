@@ -15,43 +15,102 @@
 #include "fastjet/GhostedAreaSpec.hh"
 #include "fastjet/AreaDefinition.hh"
 #include "fastjet/ClusterSequenceArea.hh"
+#include "fastjet/Selector.hh"
 #include "fastjet/contrib/SoftDrop.hh"
 #include "fastjet/contrib/MeasureDefinition.hh"
 
+#include <algorithm>
+#include <cmath>
+#include "TMath.h"
+#include "TVector2.h"
+
 ////////////////////////////////////////////////////////////////////////////////////
 typedef std::vector<fastjet::PseudoJet> VPseudoJet;
 
-inline VPseudoJet ConvertPFCands(std::vector<const panda::PFCand*> &incoll, bool puppi, double minPt=0.001) {
-  VPseudoJet vpj;
+// accessors so the same conversion works on collections, pointer lists and RefVectors
+inline const panda::PFCand *PFCandPtr(const panda::PFCand &incand) { return &incand; }
+inline const panda::PFCand *PFCandPtr(const panda::PFCand *incand) { return incand; }
+template <typename R>
+inline const panda::PFCand *PFCandPtr(const R &ref) { return ref.get(); }
+
+// fills a caller-owned buffer: no intermediate copies, and the buffer keeps its capacity
+template <typename C>
+inline void ConvertPFCands(C &incoll, bool puppi, VPseudoJet &vpj, double minPt=0.001) {
+  vpj.clear();
   vpj.reserve(incoll.size());
-  for (auto *incand : incoll) {
-    double factor = puppi ? incand->puppiW() : 1;
-    if (factor*incand->pt()<minPt)
+  for (auto &&incand : incoll) {
+    const panda::PFCand *pf = PFCandPtr(incand);
+    double factor = puppi ? pf->puppiW() : 1;
+    if (factor*pf->pt()<minPt)
       continue;
-    vpj.emplace_back(factor*incand->px(),factor*incand->py(),
-                     factor*incand->pz(),factor*incand->e());
+    vpj.emplace_back(factor*pf->px(),factor*pf->py(),
+                     factor*pf->pz(),factor*pf->e());
   }
+}
+
+inline VPseudoJet ConvertPFCands(std::vector<const panda::PFCand*> &incoll, bool puppi, double minPt=0.001) {
+  VPseudoJet vpj;
+  ConvertPFCands(incoll, puppi, vpj, minPt);
   return vpj;
 }
 
 inline VPseudoJet ConvertPFCands(panda::RefVector<panda::PFCand> &incoll, bool puppi, double minPt=0.001) {
-  std::vector<const panda::PFCand*> outcoll;
-  outcoll.reserve(incoll.size());
-  for (auto incand : incoll)
-    outcoll.push_back(incand.get());
-
-  return ConvertPFCands(outcoll, puppi, minPt);
+  VPseudoJet vpj;
+  ConvertPFCands(incoll, puppi, vpj, minPt);
+  return vpj;
 }
 
 inline VPseudoJet ConvertPFCands(panda::PFCandCollection &incoll, bool puppi, double minPt=0.001) {
-  std::vector<const panda::PFCand*> outcoll;
-  outcoll.reserve(incoll.size());
-  for (auto &incand : incoll)
-    outcoll.push_back(&incand);
+  VPseudoJet vpj;
+  ConvertPFCands(incoll, puppi, vpj, minPt);
+  return vpj;
+}
 
-  return ConvertPFCands(outcoll, puppi, minPt);
+// constituents of a jet, appended into a reused buffer when the jet 
+// belongs to a cluster sequence
+inline void FillConstituents(const fastjet::PseudoJet &jet, VPseudoJet &out) {
+  out.clear();
+  if (jet.has_valid_cluster_sequence() && jet.cluster_hist_index()>=0)
+    jet.validated_cs()->add_constituents(jet,out);
+  else
+    out = jet.constituents();
 }
 
+// energy fraction carried by the nLeading highest-pT constituents; 
+// partially reorders the input instead of making a sorted copy
+inline double LeadingEFraction(VPseudoJet &constituents, unsigned nLeading) {
+  if (constituents.size()>nLeading) {
+    std::nth_element(constituents.begin(),constituents.begin()+nLeading,constituents.end(),
+                     [](const fastjet::PseudoJet &a, const fastjet::PseudoJet &b)->bool {
+                       return a.perp2() > b.perp2();
+                     });
+  }
+  double eTot=0, eTrunc=0;
+  unsigned nC = constituents.size();
+  for (unsigned iC=0; iC!=nC; ++iC) {
+    double e = constituents[iC].E();
+    eTot += e;
+    if (iC<nLeading)
+      eTrunc += e;
+  }
+  return (eTot>0) ? eTrunc/eTot : 0;
+}
+
+// buffers for the PF candidate reclustering. They are cleared but never shrunk,
+// so after the first events the conversion and constituent lists do not allocate
+class ReclusterArena {
+public:
+  ReclusterArena(unsigned nReserve=4000) {
+    particles.reserve(nReserve);
+    cands.reserve(nReserve);
+    constituents.reserve(nReserve/4);
+    sdConstituents.reserve(nReserve/4);
+  }
+  ~ReclusterArena() {}
+  VPseudoJet particles, constituents, sdConstituents;
+  std::vector<const panda::PFCand*> cands;
+};
+
 ////////////////////////////////////////////////////////////////////////////////////
 
 inline double TTNLOToNNLO(double pt) {
@@ -64,23 +123,6 @@ inline double TTNLOToNNLO(double pt) {
                         a*TMath::Exp(-b*pow(pt,2)+1) + c*pt + d);
 }
 
-////////////////////////////////////////////////////////////////////////////////////
-
-class LumiRange {
-public:
-    LumiRange(int l0_,int l1_):
-        l0(l0_),
-        l1(l1_)
-     { }
-    ~LumiRange() {}
-    bool Contains(int l) {
-        return l0<=l && l<=l1;
-    }
-private:
-    int l0, l1;
-};
-
-
 ////////////////////////////////////////////////////////////////////////////////////
 template <typename T>
 class THCorr {
@@ -193,4 +235,105 @@ inline bool IsMatched(std::vector<panda::Particle*>*objects,
 
 ////////////////////////////////////////////////////////////////////////////////////
 
+// Binned eta-phi index for "which objects are within dR of (eta,phi)" queries.
+// Objects are added once per event with Add() and sorted into cells by Build().
+// Phi wraps around. Objects beyond etaMax go to the edge cells, so the results
+// are exact everywhere. Hits are returned in ascending id order, so callers see
+// the same order as a linear scan.
+class EtaPhiGrid {
+public:
+  EtaPhiGrid(double cellSize_=0.4, double etaMax_=5.0) : 
+    cellSize(cellSize_), etaMax(etaMax_) 
+  {
+    nEta = std::max(1,int(std::ceil(2*etaMax/cellSize)));
+    nPhi = std::max(1,int(2*TMath::Pi()/cellSize)); // cells are at least cellSize wide
+    phiSize = 2*TMath::Pi()/nPhi;
+    cellStart.resize(nEta*nPhi+1,0);
+  }
+  ~EtaPhiGrid() { }
+
+  void Clear() { etas.clear(); phis.clear(); ids.clear(); cells.clear(); order.clear(); }
+  void Add(double eta, double phi, unsigned id) {
+    etas.push_back(eta); phis.push_back(phi); ids.push_back(id);
+    cells.push_back(EtaCell(eta)*nPhi+PhiCell(phi));
+  }
+  // objects with pt<=0 are skipped, as in IsMatched
+  template <typename T>
+  void Fill(const std::vector<T*> &objects) {
+    Clear();
+    unsigned nO = objects.size();
+    for (unsigned iO=0; iO!=nO; ++iO) {
+      if (objects[iO]->pt()>0)
+        Add(objects[iO]->eta(),objects[iO]->phi(),iO);
+    }
+    Build();
+  }
+  void Build() {
+    // counting sort of the objects into their cells
+    std::fill(cellStart.begin(),cellStart.end(),0);
+    for (auto c : cells)
+      ++cellStart[c+1];
+    unsigned nCells = cellStart.size()-1;
+    for (unsigned iC=0; iC!=nCells; ++iC)
+      cellStart[iC+1] += cellStart[iC];
+    order.resize(cells.size());
+    cursor.assign(cellStart.begin(),cellStart.end()-1);
+    unsigned nO = cells.size();
+    for (unsigned iO=0; iO!=nO; ++iO)
+      order[cursor[cells[iO]]++] = iO;
+  }
+
+  void Query(double eta, double phi, double r2, std::vector<unsigned> &hits) const {
+    hits.clear();
+    Visit(eta,phi,r2,[&hits](unsigned id)->bool { hits.push_back(id); return false; });
+    std::sort(hits.begin(),hits.end());
+  }
+  bool Any(double eta, double phi, double r2) const {
+    return Visit(eta,phi,r2,[](unsigned id)->bool { return true; });
+  }
+  unsigned size() const { return ids.size(); }
+
+private:
+  int EtaCell(double eta) const { 
+    int iE = int(std::floor((eta+etaMax)/cellSize));
+    return std::min(std::max(iE,0),nEta-1);
+  }
+  int PhiCell(double phi) const {
+    int iP = int(TVector2::Phi_0_2pi(phi)/phiSize);
+    return std::min(std::max(iP,0),nPhi-1);
+  }
+  // calls f(id) for every object within r2, stops early if f returns true
+  template <typename F>
+  bool Visit(double eta, double phi, double r2, F f) const {
+    if (ids.size()==0)
+      return false;
+    double r = std::sqrt(r2);
+    int e0 = EtaCell(eta-r), e1 = EtaCell(eta+r);
+    int p = PhiCell(phi), dp = int(std::ceil(r/phiSize));
+    int p0 = p-dp, p1 = p+dp;
+    if (p1-p0+1>=nPhi) { 
+      p0 = 0; p1 = nPhi-1; 
+    }
+    for (int iE=e0; iE<=e1; ++iE) {
+      for (int iP=p0; iP<=p1; ++iP) {
+        unsigned cell = iE*nPhi + ((iP%nPhi)+nPhi)%nPhi;
+        for (unsigned k=cellStart[cell]; k!=cellStart[cell+1]; ++k) {
+          unsigned slot = order[k];
+          if (DeltaR2(eta,phi,etas[slot],phis[slot])<r2 && f(ids[slot]))
+            return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  double cellSize, etaMax, phiSize;
+  int nEta, nPhi;
+  std::vector<double> etas, phis;
+  std::vector<unsigned> ids, cells;
+  std::vector<unsigned> cellStart, cursor, order;
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+
 #endif
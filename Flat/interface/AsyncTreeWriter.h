@@ -0,0 +1,68 @@
+#ifndef PANDAANALYSIS_AsyncTreeWriter
+#define PANDAANALYSIS_AsyncTreeWriter
+
+#include "PandaCore/Tools/interface/Common.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * \brief Fills a tree from a background thread
+ *
+ * Once started, the branches of the tree read from staging buffers owned by
+ * the writer. Fill() copies the current values at the original addresses
+ * into one of a bounded number of rows, and the writer thread copies rows
+ * into the staging buffers and fills the tree, so basket compression and
+ * disk writes overlap with the event loop. Fill() only blocks when all
+ * rows are pending.
+ *
+ * Only leaf-list branches are supported; variable-length arrays need an
+ * Int_t counter. Until Finish() returns, the tree and its file must not be
+ * used by any other thread.
+ */
+class AsyncTreeWriter
+{
+public:
+	AsyncTreeWriter(TTree *t_, unsigned nRows_=256) : t(t_), nRows(nRows_) { }
+	~AsyncTreeWriter() { Finish(); }
+
+	/** call once all branches are booked; returns false, and the tree should be filled directly, if unsupported */
+	bool Start();
+	void Fill();
+	/** writes the pending rows and restores the branch addresses; the tree can then be written */
+	void Finish();
+
+	bool IsRunning() const { return running; }
+	Long64_t GetNFilled() const { return nFilled; }
+	Long64_t GetNStalls() const { return nStalls; }
+
+private:
+	struct Column {
+		TBranch *b=0;
+		char *src=0;
+		unsigned bytes=0;            // per entry, or per element if count is set
+		const Int_t *count=0;
+		std::vector<char> staging;
+	};
+	struct Row {
+		std::vector<char> data;
+		std::vector<unsigned> sizes;
+	};
+	void Loop();
+
+	TTree *t;
+	unsigned nRows;
+	std::vector<Column> columns;
+	std::vector<Row> rows;
+	unsigned head=0, nQueued=0;     // head is only moved by the writer
+	bool running=false, done=false;
+	Long64_t nFilled=0, nStalls=0;
+
+	std::thread thread;
+	std::mutex mtx;
+	std::condition_variable cvData, cvSpace;
+};
+#endif
@@ -31,6 +31,7 @@ public :
 	// public configuration
 	int firstEvent=-1;
 	int lastEvent=-1;													// max events to process; -1=>all
+	bool ntupleOutput=false;										// write the output tree as an RNTuple of the same name
 
 private:
 	// IO for the analyzer
@@ -0,0 +1,74 @@
+#ifndef PANDAANALYSIS_ColumnReader
+#define PANDAANALYSIS_ColumnReader
+
+#include "PandaCore/Tools/interface/Common.h"
+#include "TString.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include <vector>
+
+/**
+ * \brief Bulk reader of a few leaves of panda objects into columns
+ *
+ * Opens its own handle on the input tree, so the branch addresses of a
+ * panda::Event reading the same file are left alone. For a block of entries
+ * only the requested leaves are decoded, one branch at a time across the
+ * whole block, into one contiguous float column per leaf. Objects of event
+ * i of the block are [Begin(c,i),End(c,i)) in every column of c, with the
+ * offsets taken from the collection's size branch.
+ */
+class ColumnReader
+{
+public:
+	ColumnReader(TString fileName, TString treeName="events");
+	~ColumnReader();
+
+	bool IsOpen() const { return t!=0; }
+	Long64_t GetEntries() const { return t ? t->GetEntries() : 0; }
+
+	/** reads the leaves coll.leaf[i] of coll, with counter coll.size; returns the collection id, or -1 */
+	int AddCollection(TString coll, std::vector<TString> leaves) { return Add(coll,leaves,true); }
+	/** the pt_, eta_, phi_ columns and the given extra leaves */
+	int AddParticles(TString coll, std::vector<TString> extra={}) {
+		std::vector<TString> leaves = {"pt_","eta_","phi_"};
+		leaves.insert(leaves.end(),extra.begin(),extra.end());
+		return AddCollection(coll,leaves);
+	}
+	/** reads the leaves obj.leaf of a single object, one value per event, e.g. ("recoil",{"max"}) */
+	int AddObject(TString obj, std::vector<TString> leaves) { return Add(obj,leaves,false); }
+
+	/** decodes entries [first,last); returns the number of events read */
+	unsigned ReadBlock(Long64_t first, Long64_t last);
+
+	unsigned GetNEvents() const { return nEvents; }
+	Long64_t GetFirstEntry() const { return firstEntry; }
+	unsigned Begin(int iC, unsigned iEvt) const { return collections[iC].offsets[iEvt]; }
+	unsigned End(int iC, unsigned iEvt) const { return collections[iC].offsets[iEvt+1]; }
+	/** column iL of collection iC, in the order of the leaves passed when adding it */
+	const float *Column(int iC, unsigned iL) const { return collections[iC].columns[iL].data(); }
+	int ColumnIndex(int iC, TString leaf) const;
+
+private:
+	int Add(TString name, std::vector<TString> leaves, bool sized);
+
+	struct Collection {
+		TString name;
+		TBranch *sizeBranch=0;                // 0 for a single object
+		TLeaf *sizeLeaf=0;
+		std::vector<TString> leafNames;
+		std::vector<TBranch*> branches;
+		std::vector<TLeaf*> leaves;
+		std::vector<bool> isFloat;            // copied directly instead of converted
+		std::vector<std::vector<float>> columns;
+		std::vector<unsigned> offsets;        // nEvents+1
+	};
+
+	TFile *f=0;
+	TTree *t=0;
+	std::vector<Collection> collections;
+	unsigned nEvents=0;
+	Long64_t firstEntry=0;
+};
+#endif
@@ -0,0 +1,43 @@
+#ifndef PANDAANALYSIS_Declustering
+#define PANDAANALYSIS_Declustering
+
+#include "AnalyzerUtilities.h"
+#include <vector>
+
+/**
+ * \brief Cached primary declustering sequence of a C/A jet
+ *
+ * The jet is declustered once, always following the harder branch.
+ * Soft-drop grooming at any (beta, zcut) and the primary Lund plane are
+ * then read off the cached sequence without reclustering.
+ * Splittings off pure-ghost branches are not recorded.
+ */
+class JetDeclusterer
+{
+public:
+	struct Step {
+		double dR;  //!< opening angle of the splitting
+		double z;   //!< pt fraction of the softer branch
+		double kt;  //!< pt of the softer branch times dR
+	};
+
+	JetDeclusterer(double R0_=1.5) : R0(R0_) { steps.reserve(50); parents.reserve(50); }
+	~JetDeclusterer() {}
+
+	void Build(const fastjet::PseudoJet &jet); //!< jet must come from a C/A cluster sequence
+	/** index of the first step passing soft drop, or GetNSteps() if none does */
+	unsigned SoftDropStep(double beta, double zcut) const;
+	/** the soft-dropped jet, i.e. the parent of SoftDropStep() */
+	const fastjet::PseudoJet &SoftDrop(double beta, double zcut) const;
+
+	unsigned GetNSteps() const { return steps.size(); }
+	const Step &GetStep(unsigned i) const { return steps[i]; }
+	const fastjet::PseudoJet &GetParent(unsigned i) const { return (i<parents.size()) ? parents[i] : last; }
+
+private:
+	double R0;
+	std::vector<Step> steps;
+	VPseudoJet parents;      // jet being split at each step
+	fastjet::PseudoJet last; // hardest prong left at the end
+};
+#endif
@@ -0,0 +1,79 @@
+#ifndef PANDAANALYSIS_DeltaRMatrix
+#define PANDAANALYSIS_DeltaRMatrix
+
+#include "AnalyzerUtilities.h"
+#include <vector>
+#include <cstdint>
+
+/**
+ * \brief Eta and phi of one collection in contiguous arrays
+ *
+ * Index i is the i-th object of the collection it was filled from.
+ * As in IsMatched, objects with pt<=0 never match anything.
+ */
+class EtaPhiArrays
+{
+public:
+	EtaPhiArrays() {}
+	~EtaPhiArrays() {}
+
+	void Clear() { eta.clear(); phi.clear(); }
+	void Add(double pt, double eta_, double phi_);
+	template <typename C>
+	void Fill(C &objects) {
+		Clear();
+		for (auto &o : objects)
+			Add(AsPtr(o)->pt(),AsPtr(o)->eta(),AsPtr(o)->phi());
+	}
+	unsigned size() const { return eta.size(); }
+
+	std::vector<float> eta, phi; //!< phi is in [-pi,pi]
+
+private:
+	template <typename T>
+	static const T *AsPtr(const T &o) { return &o; }
+	template <typename T>
+	static const T *AsPtr(T *const &o) { return o; }
+};
+
+/**
+ * \brief Set of indices into a collection, one bit per object
+ */
+class BitMask
+{
+public:
+	void Reset(unsigned n) { bits.assign((n+63)/64,0); }
+	void Set(unsigned i) { bits[i>>6] |= (uint64_t(1)<<(i&63)); }
+	bool Test(unsigned i) const { return (bits[i>>6]>>(i&63))&1; }
+
+private:
+	std::vector<uint64_t> bits;
+};
+
+/**
+ * \brief Pairwise dR2 between two collections
+ *
+ * The whole |A|x|B| block is computed in one pass over the arrays, with
+ * branchless phi wrapping so the inner loop vectorizes.
+ */
+class DeltaRMatrix
+{
+public:
+	DeltaRMatrix() {}
+	~DeltaRMatrix() {}
+
+	void Compute(const EtaPhiArrays &a, const EtaPhiArrays &b);
+	float Get(unsigned ia, unsigned ib) const { return dr2[ia*nB+ib]; }
+	/** sets the bit of every a within dR2<r2 of any b; mask must already hold |A| bits */
+	void MatchMask(float r2, BitMask &mask) const;
+	/** Compute followed by MatchMask */
+	void Match(const EtaPhiArrays &a, const EtaPhiArrays &b, float r2, BitMask &mask) {
+		Compute(a,b);
+		MatchMask(r2,mask);
+	}
+
+private:
+	unsigned nA=0, nB=0;
+	std::vector<float> dr2; // row-major, a*nB+b
+};
+#endif
@@ -0,0 +1,52 @@
+#ifndef PANDAANALYSIS_EnergyCorrelations
+#define PANDAANALYSIS_EnergyCorrelations
+
+#include "AnalyzerUtilities.h"
+#include <vector>
+
+/**
+ * \brief Computes generalized energy correlation functions of a jet
+ *
+ * ECF(order,N,beta) is the sum over all N-tuples of constituents of the
+ * product of their pt fractions times the product of the `order` smallest
+ * pairwise angles dR^beta in the tuple (Moult, Necib, Thaler).
+ * If `order` exceeds the number of pairs in a tuple, all pairs are used.
+ *
+ * dR^beta is tabulated once per event for every beta, and the N-point sums
+ * run over contiguous matrix rows without branches. All buffers are kept
+ * between events.
+ */
+class ECFCalculator
+{
+public:
+	ECFCalculator(std::vector<double> betas_={0.5,1.,2.,4.}, int maxN_=4, int maxOrder_=3);
+	~ECFCalculator() {}
+
+	void Compute(const VPseudoJet &particles);
+	template <typename C>
+	void Compute(C &pfcands, bool puppi) { ConvertPFCands(pfcands,puppi,inputs,0); Compute(inputs); }
+	//! order, N are 1-indexed as in the branch names, ibeta indexes the beta list
+	float Get(int order, int N, int ibeta) const { return results[Index(order,N,ibeta)]; }
+
+	std::vector<double> GetBetas() const { return betas; }
+	void SetTopK(unsigned k) { topK = k; } //!< only use the k hardest constituents; 0 = all
+
+private:
+	unsigned Index(int order, int N, int ibeta) const { return ((order-1)*maxN + (N-1))*nBeta + ibeta; }
+	void SumN3(const double *A, unsigned ibeta);
+	void SumN4(const double *A, unsigned ibeta);
+
+	std::vector<double> betas;
+	unsigned nBeta;
+	int maxN, maxOrder;
+	unsigned topK=100;
+
+	VPseudoJet inputs;
+	std::vector<unsigned> order;     // constituent indices sorted by pt
+	std::vector<double> z, eta, phi; // SoA of the used constituents
+	std::vector<double> logDR;       // n*n, 0.5*log(dR2)
+	std::vector<double> angles;      // nBeta*n*n, dR^beta
+	unsigned n=0;
+	std::vector<float> results;
+};
+#endif
@@ -0,0 +1,125 @@
+#ifndef PANDAANALYSIS_FlavourLabeller
+#define PANDAANALYSIS_FlavourLabeller
+
+#include "AnalyzerUtilities.h"
+#include <vector>
+
+/**
+ * \brief Ghost-association flavour labels for a set of jets
+ *
+ * The last heavy-flavour hadrons and the last-copy partons of the event are
+ * scaled down to ghosts and clustered together with the constituents of the
+ * jets, using the jets' own algorithm and radius, so the ghosts cannot move
+ * the jets. A jet is b (c) if a b (c) hadron ghost ends up in it. If the gen
+ * record has no heavy-flavour hadrons at all, the parton ghosts decide
+ * instead. Every ghost is assigned to at most one jet.
+ *
+ * Jets without constituents (e.g. subjets, or when the PF candidates are not
+ * read) enter as their four-momentum, which is then the only constituent.
+ *
+ * Ghosts are collected once per event and can be reused for several sets of
+ * jets, e.g. AK4 jets and CA15 subjets.
+ */
+class FlavourLabeller
+{
+public:
+	FlavourLabeller(double ghostScale_=1e-18) : ghostScale(ghostScale_) { }
+	~FlavourLabeller() {}
+
+	template <typename C>
+	void SetGhosts(C &genParticles);
+
+	void ClearJets() { inputs.clear(); nJets=0; }
+	/** the jet is its own only constituent */
+	void AddJet(double pt, double eta, double phi);
+	/** the PF candidates of the jet; falls back to the four-momentum if there are none */
+	template <typename C>
+	void AddJet(double pt, double eta, double phi, C &constituents, bool puppi);
+	/** one clustering of the constituents of all added jets and the ghosts; R and algo should be those of the jets */
+	void Label(double R, fastjet::JetAlgorithm algo);
+
+	int GetFlavour(unsigned iJ) const { return labels[iJ].flavour; } //!< 5, 4 or 0
+	float GetGenPt(unsigned iJ) const { return labels[iJ].genPt; }   //!< pt of the parton ghost of the jet's flavour, else of the leading parton ghost
+
+	static int HadronFlavour(int pdgid); //!< heaviest of b, c in a hadron's pdgid, else 0
+	static int PartonFlavour(int pdgid); //!< 4 or 5 for c, b quarks, 0 for other quarks and gluons, -1 otherwise
+
+private:
+	struct Ghost {
+		double pt, eta, phi;
+		int flavour;
+		bool hadron;
+	};
+	struct JetLabel {
+		int flavour;
+		float genPt;
+		int hadronFlavour, partonFlavour;
+		float partonPt, leadingPartonPt;
+	};
+
+	double ghostScale;
+	bool hasHadrons=false;
+	std::vector<Ghost> ghosts;
+	std::vector<const void*> notLast; // particles with a daughter of the same kind
+	unsigned nJets=0;
+	VPseudoJet inputs, cands;     // constituents of the jets (user index = jet), then the ghosts
+	std::vector<JetLabel> labels;
+	std::vector<double> ptSums;
+	std::vector<unsigned> members;
+};
+
+template <typename C>
+void FlavourLabeller::AddJet(double pt, double eta, double phi, C &constituents, bool puppi)
+{
+	ConvertPFCands(constituents,puppi,cands);
+	if (cands.size()==0) {
+		AddJet(pt,eta,phi);
+		return;
+	}
+	for (auto &c : cands) {
+		inputs.push_back(c);
+		inputs.back().set_user_index(nJets);
+	}
+	++nJets;
+}
+
+template <typename C>
+void FlavourLabeller::SetGhosts(C &genParticles)
+{
+	ghosts.clear();
+	notLast.clear();
+	hasHadrons = false;
+
+	unsigned nGen = genParticles.size();
+	for (unsigned iG=0; iG!=nGen; ++iG) {
+		auto &gen = genParticles.at(iG);
+		if (!gen.parent.isValid())
+			continue;
+		int pdgid = gen.pdgid, parentPdgid = gen.parent->pdgid;
+		int hf = HadronFlavour(pdgid);
+		if ((hf>0 && HadronFlavour(parentPdgid)==hf) ||
+		    (PartonFlavour(pdgid)>=0 && parentPdgid==pdgid))
+			notLast.push_back(gen.parent.get());
+	}
+	std::sort(notLast.begin(),notLast.end());
+
+	for (unsigned iG=0; iG!=nGen; ++iG) {
+		auto &gen = genParticles.at(iG);
+		if (gen.pt()<=0)
+			continue;
+		Ghost g;
+		g.flavour = HadronFlavour(gen.pdgid);
+		g.hadron = (g.flavour>0);
+		if (!g.hadron) {
+			g.flavour = PartonFlavour(gen.pdgid);
+			if (g.flavour<0)
+				continue;
+		}
+		if (std::binary_search(notLast.begin(),notLast.end(),(const void*)&gen))
+			continue;
+		g.pt = gen.pt(); g.eta = gen.eta(); g.phi = gen.phi();
+		ghosts.push_back(g);
+		hasHadrons = hasHadrons || g.hadron;
+	}
+}
+#endif
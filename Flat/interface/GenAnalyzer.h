@@ -63,6 +63,7 @@ public :
 	void SetCut(TString cut) { scut = cut; }
 	int firstEvent=-1;
 	int lastEvent=-1;													// max events to process; -1=>all
+	bool ntupleOutput=false;										// write the output tree as an RNTuple of the same name
 	Process processType;						 // determine which leps to look for
 	Order order;												 // this determines the data format
 
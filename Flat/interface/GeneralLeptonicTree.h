@@ -9,103 +9,11 @@
 #include "TString.h"
 #include "genericTree.h"
 #include <map>
+#include <type_traits>
 
-class GeneralLeptonicTree : public genericTree {
-    public:
-      // public objects
-
-      enum BTagShift {
-        bCent=0,
-        bBUp,
-        bBDown,
-        bMUp,
-        bMDown,
-        bNShift
-      };
-      enum BTagJet {
-        bJet=0,
-        bSubJet,
-        bNJet
-      };
-      enum BTagTags {
-        b0=0,
-        b1,
-        b2,
-        bGT0,
-        bNTags
-      };
-        
-      struct BTagParams {
-        BTagJet jet;
-        BTagTags tag;
-        BTagShift shift=(BTagShift)0;
-        bool operator==(const BTagParams &o) const {
-          return jet==o.jet && tag==o.tag && shift==o.shift;
-        }
-        bool operator<(const BTagParams &o) const {
-          return ( jet<o.jet ||
-                   (jet==o.jet && tag<o.tag) ||
-                   (jet==o.jet && tag==o.tag && shift<o.shift) ); 
-        }
-        bool operator>(const BTagParams &o) const {
-          return ! operator<(o);
-        }
-      };
-        
-    private:
-        std::vector<BTagParams> btagParams;
-
-        TString makeBTagSFString(BTagParams p) {
-          TString s = "sf_";
-          if (p.jet==bSubJet)
-            s += "sj";
-          s += "btag";
-          switch (p.tag) {
-            case b0:
-              s += "0"; break;
-            case b1:
-              s += "1"; break;
-            case b2:
-              s += "2"; break;
-            case bGT0:
-              s += "GT0"; break;
-            default:
-              break;
-          }
-          if (p.shift==bCent)
-            return s;
-          switch (p.shift) {
-            case bBUp:
-              s += "BUp"; break;
-            case bBDown:
-              s += "BDown"; break;
-            case bMUp:
-              s += "MUp"; break;
-            case bMDown:
-              s += "MDown"; break;
-            default: break;
-          }
-          return s;
-        }
-    public:
-      GeneralLeptonicTree();
-      ~GeneralLeptonicTree();
-      void WriteTree(TTree *t);
-      void Fill() { treePtr->Fill(); }
-      void SetBranchStatus(const char *bname, bool status, UInt_t *ret=0) 
-      { 
-        treePtr->SetBranchStatus(bname,status,ret); 
-      }
-      void Reset();
-
-      // public config
-
-//STARTCUSTOMDEF
-      std::map<BTagParams,float> sf_btags;
-      std::map<TString,float> signal_weights;
-
-      float scale[6];
-//ENDCUSTOMDEF
+//STARTGENERATEDBLOCK
+// generated from GeneralLeptonicTree.cfg
+struct alignas(genericTree::blockAlignment) GeneralLeptonicTreeBlock {
     int runNumber = -1;
     int lumiNumber = -1;
     ULong64_t eventNumber = -1;
@@ -115,7 +23,6 @@ class GeneralLeptonicTree : public genericTree {
     int trigger = 0;
     int metFilter = 0;
     float zPos = 0;
-
     int nLooseLep = 0;
     int looseGenLep1PdgId = 0;
     int looseGenLep2PdgId = 0;
@@ -153,63 +60,41 @@ class GeneralLeptonicTree : public genericTree {
     float looseLep2SCEta = -1;
     float looseLep3SCEta = -1;
     float looseLep4SCEta = -1;
-
     int nJet = 0;
     int jetNLBtags = 0;
     int jetNMBtags = 0;
     int jetNTBtags = 0;
-
-    float jet1Pt    = -1;
-    float jet2Pt    = -1;
-    float jet3Pt    = -1;
-    float jet4Pt    = -1;
-    float jet1Eta   = -1;
-    float jet2Eta   = -1;
-    float jet3Eta   = -1;
-    float jet4Eta   = -1;
-    float jet1Phi   = -1;
-    float jet2Phi   = -1;
-    float jet3Phi   = -1;
-    float jet4Phi   = -1;
-    float jet1BTag  = -1;
-    float jet2BTag  = -1;
-    float jet3BTag  = -1;
-    float jet4BTag  = -1;
+    float jet1Pt = -1;
+    float jet2Pt = -1;
+    float jet3Pt = -1;
+    float jet4Pt = -1;
+    float jet1Eta = -1;
+    float jet2Eta = -1;
+    float jet3Eta = -1;
+    float jet4Eta = -1;
+    float jet1Phi = -1;
+    float jet2Phi = -1;
+    float jet3Phi = -1;
+    float jet4Phi = -1;
+    float jet1BTag = -1;
+    float jet2BTag = -1;
+    float jet3BTag = -1;
+    float jet4BTag = -1;
     float jet1GenPt = -1;
     float jet2GenPt = -1;
     float jet3GenPt = -1;
     float jet4GenPt = -1;
-    int jet1Flav    = -1;
-    int jet2Flav    = -1;
-    int jet3Flav    = -1;
-    int jet4Flav    = -1;
-    int jet1SelBit  = 0;
-    int jet2SelBit  = 0;
-    int jet3SelBit  = 0;
-    int jet4SelBit  = 0;
-
-    float jet1PtUp    = -1;
-    float jet2PtUp    = -1;
-    float jet3PtUp    = -1;
-    float jet4PtUp    = -1;
-    float jet1PtDown  = -1;
-    float jet2PtDown  = -1;
-    float jet3PtDown  = -1;
-    float jet4PtDown  = -1;
-    float jet1EtaUp   = -1;
-    float jet2EtaUp   = -1;
-    float jet3EtaUp   = -1;
-    float jet4EtaUp   = -1;
-    float jet1EtaDown = -1;
-    float jet2EtaDown = -1;
-    float jet3EtaDown = -1;
-    float jet4EtaDown = -1;
-
+    int jet1Flav = -1;
+    int jet2Flav = -1;
+    int jet3Flav = -1;
+    int jet4Flav = -1;
+    int jet1SelBit = 0;
+    int jet2SelBit = 0;
+    int jet3SelBit = 0;
+    int jet4SelBit = 0;
     float pfmet = -1;
     float pfmetphi = -1;
     float pfmetRaw = -1;
-    float pfmetUp = -1;
-    float pfmetDown = -1;
     float pfmetnomu = -1;
     float puppimet = -1;
     float puppimetphi = -1;
@@ -219,38 +104,101 @@ class GeneralLeptonicTree : public genericTree {
     float trkmetphi = -1;
     float dphipfmet = -1;
     float dphipuppimet = -1;
-
     float genLep1Pt = -1;
     float genLep2Pt = -1;
     float genLep1Eta = -1;
     float genLep2Eta = -1;
     float genLep1Phi = -1;
     float genLep2Phi = -1;
-    int genLep1PdgId = -1;
-    int genLep2PdgId = -1;
-
+    int genLep1PdgId = 0;
+    int genLep2PdgId = 0;
     int nTau = 0;
-    float pdfUp = 1;
-    float pdfDown = 1;
-
+    float scale[6] = {1,1,1,1,1,1};
     int nLoosePhoton = 0;
-    float loosePho1Pt  = -1;
+    float loosePho1Pt = -1;
     float loosePho1Eta = -1;
     float loosePho1Phi = -1;
-    
-    float sf_l1Prefire = 1.0;
-    float sf_l1PrefireUnc = 1.0;
-    float sf_pu = 1.0;
-    float sf_puUp = 1.0;
-    float sf_puDown = 1.0;
-    float sf_zz = 1.0;
-    float sf_zzUnc = 1.0;
-    float sf_wz = 1.0;
-    float sf_zh = 1.0;
-    float sf_zhUp = 1.0;
-    float sf_zhDown = 1.0;
-    float sf_tt = 1.0;
+    float sf_btags[40] = {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1};
+    static constexpr int sf_btagsIndex(int jet, int tag, int shift) { return (jet*4+tag)*5+shift; }
+    float sf_l1Prefire = 1;
+    float sf_pu = 1;
+    float sf_zz = 1;
+    float sf_wz = 1;
+    float sf_zh = 1;
+    float sf_tt = 1;
+    // filled only when their stage runs
+    alignas(genericTree::blockAlignment) float jet1PtUp = -1;
+    float jet2PtUp = -1;
+    float jet3PtUp = -1;
+    float jet4PtUp = -1;
+    float jet1PtDown = -1;
+    float jet2PtDown = -1;
+    float jet3PtDown = -1;
+    float jet4PtDown = -1;
+    float jet1EtaUp = -1;
+    float jet2EtaUp = -1;
+    float jet3EtaUp = -1;
+    float jet4EtaUp = -1;
+    float jet1EtaDown = -1;
+    float jet2EtaDown = -1;
+    float jet3EtaDown = -1;
+    float jet4EtaDown = -1;
+    float pfmetUp = -1;
+    float pfmetDown = -1;
+    float pdfUp = 1;
+    float pdfDown = 1;
+    float sf_l1PrefireUnc = 1;
+    float sf_puUp = 1;
+    float sf_puDown = 1;
+    float sf_zzUnc = 1;
+    float sf_zhUp = 1;
+    float sf_zhDown = 1;
+};
+static_assert(std::is_trivially_copyable<GeneralLeptonicTreeBlock>::value,"GeneralLeptonicTreeBlock must be resettable by a copy");
+//ENDGENERATEDBLOCK
 
+class GeneralLeptonicTree : public genericTree, public GeneralLeptonicTreeBlock {
+    public:
+      // public objects
+
+      enum BTagShift {
+        bCent=0,
+        bBUp,
+        bBDown,
+        bMUp,
+        bMDown,
+        bNShift
+      };
+      enum BTagJet {
+        bJet=0,
+        bSubJet,
+        bNJet
+      };
+      enum BTagTags {
+        b0=0,
+        b1,
+        b2,
+        bGT0,
+        bNTags
+      };
+        
+    public:
+      GeneralLeptonicTree();
+      ~GeneralLeptonicTree();
+      void WriteTree(TTree *t);
+      void Fill() { FillTree(); }
+      void SetBranchStatus(const char *bname, bool status, UInt_t *ret=0) 
+      { 
+        treePtr->SetBranchStatus(bname,status,ret); 
+      }
+      void Reset();
+
+      // public config
+
+//STARTCUSTOMDEF
+      //! set to 1 by the analyzer before WriteTree and rewritten in every MC event, so Reset leaves them alone
+      std::map<TString,float> signal_weights;
+//ENDCUSTOMDEF
 };
 
 #endif
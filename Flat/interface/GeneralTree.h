@@ -9,241 +9,60 @@
 #include "TString.h"
 #include "genericTree.h"
 #include <map>
+#include <type_traits>
+#include <array>
 
 #define NJET 20
 #define NSUBJET 2
+#define NFATJET 4
+#define NGROOM 8
+#define NLUND 32
+#define NCONST 100
+#define NECFORDER 3
+#define NECFN 4
+#define NECFBETA 8
+#define NECF (NECFORDER*NECFN*NECFBETA)
 
-class GeneralTree : public genericTree {
-    public:
-      // public objects
-      struct ECFParams {
-        int ibeta;
-        int N;
-        int order;
-        bool operator==(const ECFParams &o) const {
-          return ibeta==o.ibeta && N==o.N && order==o.order;
-        }
-        bool operator<(const ECFParams &o) const {
-          return ( N<o.N ||
-                   (N==o.N && order<o.order) ||
-                   (N==o.N && order==o.order && ibeta<o.ibeta) );
-        }
-        bool operator>(const ECFParams &o) const {
-          return ! operator<(o);
-        }
-      };
-
-      enum BTagShift {
-        bCent=0,
-        bBUp,
-        bBDown,
-        bMUp,
-        bMDown,
-        bNShift
-      };
-      enum BTagJet {
-        bJet=0,
-        bSubJet,
-        bNJet
-      };
-      enum BTagTags {
-        b0=0,
-        b1,
-        b2,
-        bGT0,
-        bNTags
-      };
-        
-      struct BTagParams {
-        BTagJet jet;
-        BTagTags tag;
-        BTagShift shift=(BTagShift)0;
-        bool operator==(const BTagParams &o) const {
-          return jet==o.jet && tag==o.tag && shift==o.shift;
-        }
-        bool operator<(const BTagParams &o) const {
-          return ( jet<o.jet ||
-                   (jet==o.jet && tag<o.tag) ||
-                   (jet==o.jet && tag==o.tag && shift<o.shift) ); 
-        }
-        bool operator>(const BTagParams &o) const {
-          return ! operator<(o);
-        }
-      };
-        
-    private:
-        std::vector<double> betas = {0.5, 1.0, 2.0, 4.0};
-        std::vector<int> ibetas = {0,1,2,3};
-        std::vector<int> Ns = {1,2,3,4}; 
-        std::vector<int> orders = {1,2,3};
-        std::vector<ECFParams> ecfParams;
-        std::vector<BTagParams> btagParams;
-
-        TString makeECFString(ECFParams p) {
-            return TString::Format("ECFN_%i_%i_%.2i",p.order,p.N,int(10*betas.at(p.ibeta)));
-        }
-        TString makeBTagSFString(BTagParams p) {
-          TString s = "sf_";
-          if (p.jet==bSubJet)
-            s += "sj";
-          s += "btag";
-          switch (p.tag) {
-            case b0:
-              s += "0"; break;
-            case b1:
-              s += "1"; break;
-            case b2:
-              s += "2"; break;
-            case bGT0:
-              s += "GT0"; break;
-            default:
-              break;
-          }
-          if (p.shift==bCent)
-            return s;
-          switch (p.shift) {
-            case bBUp:
-              s += "BUp"; break;
-            case bBDown:
-              s += "BDown"; break;
-            case bMUp:
-              s += "MUp"; break;
-            case bMDown:
-              s += "MDown"; break;
-            default: break;
-          }
-          return s;
-        }
-    public:
-      GeneralTree();
-      ~GeneralTree();
-      void WriteTree(TTree *t);
-      void Fill() { treePtr->Fill(); }
-      void SetBranchStatus(const char *bname, bool status, UInt_t *ret=0) 
-      { 
-        treePtr->SetBranchStatus(bname,status,ret); 
-      }
-      void Reset();
-
-      std::vector<double> get_betas() const { return betas; }
-      std::vector<int> get_ibetas() const { return ibetas; }
-      std::vector<int> get_Ns() const { return Ns; }
-      std::vector<int> get_orders() const { return orders; }
-        
-      // public config
-      bool monohiggs=false, vbf=false, fatjet=true;
-
-//STARTCUSTOMDEF
-      std::map<ECFParams,float> fj1ECFNs;
-      std::map<BTagParams,float> sf_btags;
-      std::map<BTagParams,float> sf_alt_btags;
-      std::map<TString,float> signal_weights;
-
-      float fj1sjPt[NSUBJET];
-      float fj1sjEta[NSUBJET];
-      float fj1sjPhi[NSUBJET];
-      float fj1sjM[NSUBJET];
-      float fj1sjCSV[NSUBJET];
-      float fj1sjQGL[NSUBJET];
-
-      float jetPt[NJET];
-      float jetEta[NJET];
-      float jetPhi[NJET];
-      float jetE[NJET];
-      float jetCSV[NJET];
-      float jetIso[NJET];
-      float jetQGL[NJET];
-
-      int hbbjtidx[2];
-
-      float scale[6];
-//ENDCUSTOMDEF
-    int jot1VBFID = -1;
-    float sf_metTrigZmm = -1;
-    float sf_qcdV_VBF = -1;
-    int jetNMBtags = -1;
-    float pfmetRaw = -1;
-    int nB = -1;
-    float fj1MSDScaleUp_sj = -1;
-    float fj1MSDScaleDown_sj = -1;
-    float fj1MSDSmeared_sj = -1;
-    float fj1MSDSmearedUp_sj = -1;
-    float fj1MSDSmearedDown_sj = -1;
-    float fj1PtScaleUp_sj = -1;
-    float fj1PtScaleDown_sj = -1;
-    float fj1PtSmeared_sj = -1;
-    float fj1PtSmearedUp_sj = -1;
-    float fj1PtSmearedDown_sj = -1;
-    float jot2EtaUp = -1;
-    float jot2EtaDown = -1;
-    float jot1EtaUp = -1;
-    float jot1EtaDown = -1;
-    float jot1PtUp = -1;
-    float jot1PtDown = -1;
-    float jot2PtUp = -1;
-    float jot2PtDown = -1;
-    float jot12MassUp = -1;
-    float jot12DEtaUp = -1;
-    float jot12DPhiUp = -1;
-    float jot12MassDown = -1;
-    float jot12DEtaDown = -1;
-    float jot12DPhiDown = -1;
-    float pfmetUp = -1;
-    float pfmetDown = -1;
-    float pfUWmagUp = -1;
-    float pfUZmagUp = -1;
-    float pfUAmagUp = -1;
-    float pfUmagUp = -1;
-    float pfUWmagDown = -1;
-    float pfUZmagDown = -1;
-    float pfUAmagDown = -1;
-    float pfUmagDown = -1;
-    int nJot = -1;
-    float jot1Phi = -1;
-    float jot1Pt = -1;
-    float jot1GenPt = -1;
-    float jot1Eta = -1;
-    float jot2Phi = -1;
-    float jot2Pt = -1;
-    float jot2GenPt = -1;
-    float jot2Eta = -1;
-    float jot12DPhi = -1;
-    int isGS = -1;
-    float fj1SubMaxCSV = -1;
-    int looseLep1IsHLTSafe = -1;
-    int looseLep2IsHLTSafe = -1;
-    int runNumber = -1;
-    int lumiNumber = -1;
-    ULong64_t eventNumber = -1;
-    int npv = -1;
-    int pu = -1;
+//STARTGENERATEDBLOCK
+// generated from GeneralTree.cfg
+struct alignas(genericTree::blockAlignment) GeneralTreeBlock {
+    int runNumber = 0;
+    int lumiNumber = 0;
+    ULong64_t eventNumber = 0;
+    int npv = 0;
+    int pu = 0;
     float mcWeight = -1;
-    int trigger = -1;
-    int metFilter = -1;
-    int egmFilter = -1;
+    int trigger = 0;
+    int metFilter = 0;
+    int egmFilter = 0;
     float filter_maxRecoil = -1;
     float filter_whichRecoil = -1;
-    float sf_ewkV = -1;
-    float sf_qcdV = -1;
-    float sf_ewkV2j = -1;
-    float sf_qcdV2j = -1;
-    float sf_qcdTT = -1;
-    float sf_lepID = -1;
-    float sf_lepIso = -1;
-    float sf_lepTrack = -1;
-    float sf_pho = -1;
-    float sf_eleTrig = -1;
-    float sf_phoTrig = -1;
-    float sf_metTrig = -1;
-    float sf_pu = -1;
-    float sf_npv = -1;
-    float sf_tt = -1;
-    float sf_tt_ext = -1;
-    float sf_tt_bound = -1;
-    float sf_tt8TeV = -1;
-    float sf_tt8TeV_ext = -1;
-    float sf_tt8TeV_bound = -1;
-    float sf_phoPurity = -1;
+    float sf_ewkV = 1;
+    float sf_qcdV = 1;
+    float sf_ewkV2j = 1;
+    float sf_qcdV2j = 1;
+    float sf_qcdV_VBF = 1;
+    float sf_qcdTT = 1;
+    float sf_lepID = 1;
+    float sf_lepIso = 1;
+    float sf_lepTrack = 1;
+    float sf_pho = 1;
+    float sf_btags[40] = {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1};
+    static constexpr int sf_btagsIndex(int jet, int tag, int shift) { return (jet*4+tag)*5+shift; }
+    float sf_eleTrig = 1;
+    float sf_phoTrig = 1;
+    float sf_metTrig = 1;
+    float sf_metTrigZmm = 1;
+    float sf_pu = 1;
+    float sf_npv = 1;
+    float sf_tt = 1;
+    float sf_tt_ext = 1;
+    float sf_tt_bound = 1;
+    float sf_tt8TeV = 1;
+    float sf_tt8TeV_ext = 1;
+    float sf_tt8TeV_bound = 1;
+    float sf_phoPurity = 1;
+    float pfmetRaw = -1;
     float pfmet = -1;
     float pfmetphi = -1;
     float pfmetnomu = -1;
@@ -294,100 +113,112 @@ class GeneralTree : public genericTree {
     float genWPlusEta = -1;
     float genWMinusEta = -1;
     float genTopPt = -1;
-    int genTopIsHad = -1;
+    int genTopIsHad = 0;
     float genTopEta = -1;
     float genAntiTopPt = -1;
-    int genAntiTopIsHad = -1;
+    int genAntiTopIsHad = 0;
     float genAntiTopEta = -1;
     float genTTPt = -1;
     float genTTEta = -1;
-    int nJet = -1;
-    int nIsoJet = -1;
-    int jet1Flav = -1;
+    int nJet = 0;
+    int nIsoJet = 0;
+    int jet1Flav = 0;
     float jet1Phi = -1;
     float jet1Pt = -1;
     float jet1GenPt = -1;
     float jet1Eta = -1;
     float jet1CSV = -1;
-    int jet1IsTight = -1;
-    int jet2Flav = -1;
+    int jet1IsTight = 0;
+    int jet2Flav = 0;
     float jet2Phi = -1;
     float jet2Pt = -1;
     float jet2GenPt = -1;
     float jet2Eta = -1;
     float jet2CSV = -1;
+    int nJot = 0;
+    float jot1Phi = -1;
+    float jot1Pt = -1;
+    float jot1GenPt = -1;
+    float jot1Eta = -1;
+    float jot2Phi = -1;
+    float jot2Pt = -1;
+    float jot2GenPt = -1;
+    float jot2Eta = -1;
+    float jot12Mass = -1;
+    float jot12DEta = -1;
+    float jot12DPhi = -1;
+    int jot1VBFID = 0;
     float isojet1Pt = -1;
     float isojet1CSV = -1;
-    int isojet1Flav = -1;
+    int isojet1Flav = 0;
     float isojet2Pt = -1;
     float isojet2CSV = -1;
-    int isojet2Flav = -1;
-    float jot12Mass = -1;
-    float jot12DEta = -1;
-    int jetNBtags = -1;
-    int isojetNBtags = -1;
-    int nFatjet = -1;
+    int isojet2Flav = 0;
+    int jetNBtags = 0;
+    int jetNMBtags = 0;
+    int isojetNBtags = 0;
+    int nFatjet = 0;
     float fj1Tau32 = -1;
     float fj1Tau21 = -1;
     float fj1Tau32SD = -1;
     float fj1Tau21SD = -1;
     float fj1MSD = -1;
-    float fj1MSDScaleUp = -1;
-    float fj1MSDScaleDown = -1;
-    float fj1MSDSmeared = -1;
-    float fj1MSDSmearedUp = -1;
-    float fj1MSDSmearedDown = -1;
     float fj1MSD_corr = -1;
     float fj1Pt = -1;
-    float fj1PtScaleUp = -1;
-    float fj1PtScaleDown = -1;
-    float fj1PtSmeared = -1;
-    float fj1PtSmearedUp = -1;
-    float fj1PtSmearedDown = -1;
     float fj1Phi = -1;
     float fj1Eta = -1;
     float fj1M = -1;
     float fj1MaxCSV = -1;
+    float fj1SubMaxCSV = -1;
     float fj1MinCSV = -1;
     float fj1DoubleCSV = -1;
-    int fj1Nbs = -1;
-    int fj1gbb = -1;
+    int fj1gbb = 0;
+    int fj1Nbs = 0;
     float fj1GenPt = -1;
     float fj1GenSize = -1;
-    int fj1IsMatched = -1;
+    int fj1IsMatched = 0;
     float fj1GenWPt = -1;
     float fj1GenWSize = -1;
-    int fj1IsWMatched = -1;
-    int fj1HighestPtGen = -1;
+    int fj1IsWMatched = 0;
+    int fj1HighestPtGen = 0;
     float fj1HighestPtGenPt = -1;
-    int fj1IsTight = -1;
-    int fj1IsLoose = -1;
+    int fj1IsTight = 0;
+    int fj1IsLoose = 0;
     float fj1RawPt = -1;
-    int fj1NHF = -1;
+    int fj1NHF = 0;
     float fj1HTTMass = -1;
     float fj1HTTFRec = -1;
-    int fj1IsClean = -1;
-    int fj1NConst = -1;
-    int fj1NSDConst = -1;
+    int fj1IsClean = 0;
+    int fj1NConst = 0;
+    int fj1NSDConst = 0;
     float fj1EFrac100 = -1;
     float fj1SDEFrac100 = -1;
-    int nHF = -1;
-    int nLoosePhoton = -1;
-    int nTightPhoton = -1;
-    int loosePho1IsTight = -1;
+    float fj1ECFNs[96] = {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1};
+    static constexpr int fj1ECFNsIndex(int beta, int N, int order) { return (beta*4+N)*3+order; }
+    int nfj1Groom = 0;
+    int nfj1Lund = 0;
+    int nfj = 0;
+    int nfj1Const = 0;
+    int nHF = 0;
+    int nB = 0;
+    int nLoosePhoton = 0;
+    int nTightPhoton = 0;
+    int loosePho1IsTight = 0;
     float loosePho1Pt = -1;
     float loosePho1Eta = -1;
     float loosePho1Phi = -1;
-    int nLooseLep = -1;
-    int nLooseElectron = -1;
-    int nLooseMuon = -1;
-    int nTightLep = -1;
-    int nTightElectron = -1;
-    int nTightMuon = -1;
-    int looseLep1PdgId = -1;
-    int looseLep2PdgId = -1;
-    int looseLep1IsTight = -1;
-    int looseLep2IsTight = -1;
+    int nLooseLep = 0;
+    int nLooseElectron = 0;
+    int nLooseMuon = 0;
+    int nTightLep = 0;
+    int nTightElectron = 0;
+    int nTightMuon = 0;
+    int looseLep1PdgId = 0;
+    int looseLep2PdgId = 0;
+    int looseLep1IsTight = 0;
+    int looseLep2IsTight = 0;
+    int looseLep1IsHLTSafe = 0;
+    int looseLep2IsHLTSafe = 0;
     float looseLep1Pt = -1;
     float looseLep1Eta = -1;
     float looseLep1Phi = -1;
@@ -395,16 +226,308 @@ class GeneralTree : public genericTree {
     float looseLep2Eta = -1;
     float looseLep2Phi = -1;
     float diLepMass = -1;
-    int nTau = -1;
+    int nTau = 0;
     float mT = -1;
     float hbbpt = -1;
     float hbbeta = -1;
     float hbbphi = -1;
     float hbbm = -1;
+    int hbbjtidx[2] = {-1,-1};
+    float scale[6] = {1,1,1,1,1,1};
+    int isGS = 0;
+    int nJotStored = 0;
+    int nfj1sj = 0;
+    // filled only when their stage runs
+    alignas(genericTree::blockAlignment) float pfmetUp = -1;
+    float pfmetDown = -1;
+    float pfUWmagUp = -1;
+    float pfUZmagUp = -1;
+    float pfUAmagUp = -1;
+    float pfUmagUp = -1;
+    float pfUWmagDown = -1;
+    float pfUZmagDown = -1;
+    float pfUAmagDown = -1;
+    float pfUmagDown = -1;
+    float pfmetSmeared = -1;
+    float pfmetSmearedUp = -1;
+    float pfmetSmearedDown = -1;
+    float pfUWmagSmeared = -1;
+    float pfUZmagSmeared = -1;
+    float pfUAmagSmeared = -1;
+    float pfUmagSmeared = -1;
+    float pfUWmagSmearedUp = -1;
+    float pfUZmagSmearedUp = -1;
+    float pfUAmagSmearedUp = -1;
+    float pfUmagSmearedUp = -1;
+    float pfUWmagSmearedDown = -1;
+    float pfUZmagSmearedDown = -1;
+    float pfUAmagSmearedDown = -1;
+    float pfUmagSmearedDown = -1;
+    float jot1PtUp = -1;
+    float jot1PtDown = -1;
+    float jot1EtaUp = -1;
+    float jot1EtaDown = -1;
+    float jot2PtUp = -1;
+    float jot2PtDown = -1;
+    float jot2EtaUp = -1;
+    float jot2EtaDown = -1;
+    float jot12MassUp = -1;
+    float jot12DEtaUp = -1;
+    float jot12DPhiUp = -1;
+    float jot12MassDown = -1;
+    float jot12DEtaDown = -1;
+    float jot12DPhiDown = -1;
+    float fj1MSDScaleUp = -1;
+    float fj1MSDScaleDown = -1;
+    float fj1MSDSmeared = -1;
+    float fj1MSDSmearedUp = -1;
+    float fj1MSDSmearedDown = -1;
+    float fj1MSDScaleUp_sj = -1;
+    float fj1MSDScaleDown_sj = -1;
+    float fj1MSDSmeared_sj = -1;
+    float fj1MSDSmearedUp_sj = -1;
+    float fj1MSDSmearedDown_sj = -1;
+    float fj1PtScaleUp = -1;
+    float fj1PtScaleDown = -1;
+    float fj1PtSmeared = -1;
+    float fj1PtSmearedUp = -1;
+    float fj1PtSmearedDown = -1;
+    float fj1PtScaleUp_sj = -1;
+    float fj1PtScaleDown_sj = -1;
+    float fj1PtSmeared_sj = -1;
+    float fj1PtSmearedUp_sj = -1;
+    float fj1PtSmearedDown_sj = -1;
+    float fj1ConstPtFrac[NCONST] = {};
+    float fj1ConstDEta[NCONST] = {};
+    float fj1ConstDPhi[NCONST] = {};
+    float fj1ConstPuppiW[NCONST] = {};
+    int fj1ConstCharge[NCONST] = {};
+    int fj1ConstPdgId[NCONST] = {};
     float scaleUp = -1;
     float scaleDown = -1;
     float pdfUp = -1;
     float pdfDown = -1;
 };
+static_assert(std::is_trivially_copyable<GeneralTreeBlock>::value,"GeneralTreeBlock must be resettable by a copy");
+//ENDGENERATEDBLOCK
+
+class GeneralTree : public genericTree, public GeneralTreeBlock {
+    public:
+      // public objects
+      struct ECFParams {
+        int ibeta;
+        int N;
+        int order;
+        bool operator==(const ECFParams &o) const {
+          return ibeta==o.ibeta && N==o.N && order==o.order;
+        }
+        bool operator<(const ECFParams &o) const {
+          return ( N<o.N ||
+                   (N==o.N && order<o.order) ||
+                   (N==o.N && order==o.order && ibeta<o.ibeta) );
+        }
+        bool operator>(const ECFParams &o) const {
+          return ! operator<(o);
+        }
+      };
+
+      enum BTagShift {
+        bCent=0,
+        bBUp,
+        bBDown,
+        bMUp,
+        bMDown,
+        bNShift
+      };
+      enum BTagJet {
+        bJet=0,
+        bSubJet,
+        bNJet
+      };
+      enum BTagTags {
+        b0=0,
+        b1,
+        b2,
+        bGT0,
+        bNTags
+      };
+        
+      // betas are outermost, so the ECFs of the configured betas are [0,GetNECF())
+      static constexpr int ECFIndex(int order, int N, int ibeta) {
+        return fj1ECFNsIndex(ibeta,N-1,order-1);
+      }
+      static int ECFIndex(const ECFParams &p) { return ECFIndex(p.order,p.N,p.ibeta); }
+
+    private:
+        std::vector<double> betas = {0.5, 1.0, 2.0, 4.0};
+        std::vector<int> ibetas = {0,1,2,3};
+        std::vector<int> Ns = {1,2,3,4}; 
+        std::vector<int> orders = {1,2,3};
+        std::vector<ECFParams> ecfParams;
+
+        //! labels of the configured betas, the runtime axis of the ECF families
+        std::vector<TString> betaValues() const;
+    public:
+      GeneralTree();
+      ~GeneralTree();
+      void WriteTree(TTree *t);
+      void Fill() { FillTree(); }
+      void SetBranchStatus(const char *bname, bool status, UInt_t *ret=0) 
+      { 
+        treePtr->SetBranchStatus(bname,status,ret); 
+      }
+      void Reset();
+
+      std::vector<double> get_betas() const { return betas; }
+      std::vector<int> get_ibetas() const { return ibetas; }
+      std::vector<int> get_Ns() const { return Ns; }
+      std::vector<int> get_orders() const { return orders; }
+      unsigned GetNECF() const { return ecfParams.size(); }
+      void SetECFBetas(std::vector<double> betas_); //!< must be called before WriteTree
+        
+      // public config
+      bool monohiggs=false, vbf=false, fatjet=true;
+      bool fixedArrays=false; //!< book the counter-indexed arrays at full capacity, padded with their default
+      bool constituents=false, halfConstituents=false; //!< fj1Const arrays, optionally as Float16_t (ROOT>=6.20, else Float_t)
+
+//STARTCUSTOMDEF
+      //! set to 1 by the analyzer before WriteTree and rewritten in every MC event, so Reset leaves them alone
+      std::map<TString,float> signal_weights;
+//ENDCUSTOMDEF
+    float fjECFNs[96][NFATJET];
+    static constexpr int fjECFNsIndex(int beta, int N, int order) { return (beta*4+N)*3+order; }
+    float fj1GroomM[NGROOM];
+    float fj1GroomPt[NGROOM];
+    float fj1GroomZg[NGROOM];
+    float fj1GroomRg[NGROOM];
+    float fj1LundLnInvDR[NLUND];
+    float fj1LundLnKt[NLUND];
+    float fj1LundZ[NLUND];
+    float fjPt[NFATJET];
+    float fjEta[NFATJET];
+    float fjPhi[NFATJET];
+    float fjM[NFATJET];
+    float fjMSD[NFATJET];
+    float fjMSD_corr[NFATJET];
+    float fjRawPt[NFATJET];
+    float fjPtScaleUp[NFATJET];
+    float fjPtScaleDown[NFATJET];
+    float fjPtSmeared[NFATJET];
+    float fjPtSmearedUp[NFATJET];
+    float fjPtSmearedDown[NFATJET];
+    float fjMSDScaleUp[NFATJET];
+    float fjMSDScaleDown[NFATJET];
+    float fjMSDSmeared[NFATJET];
+    float fjMSDSmearedUp[NFATJET];
+    float fjMSDSmearedDown[NFATJET];
+    float fjPtScaleUp_sj[NFATJET];
+    float fjPtScaleDown_sj[NFATJET];
+    float fjPtSmeared_sj[NFATJET];
+    float fjMSDScaleUp_sj[NFATJET];
+    float fjMSDScaleDown_sj[NFATJET];
+    float fjMSDSmeared_sj[NFATJET];
+    float fjTau32[NFATJET];
+    float fjTau21[NFATJET];
+    float fjTau32SD[NFATJET];
+    float fjTau21SD[NFATJET];
+    float fjMaxCSV[NFATJET];
+    float fjMinCSV[NFATJET];
+    float fjSubMaxCSV[NFATJET];
+    float fjDoubleCSV[NFATJET];
+    float fjHTTMass[NFATJET];
+    float fjHTTFRec[NFATJET];
+    float fjEFrac100[NFATJET];
+    float fjSDEFrac100[NFATJET];
+    int fjIsClean[NFATJET];
+    int fjNConst[NFATJET];
+    int fjNSDConst[NFATJET];
+    float jetPt[NJET];
+    float jetEta[NJET];
+    float jetPhi[NJET];
+    float jetE[NJET];
+    float jetCSV[NJET];
+    float jetIso[NJET];
+    float jetQGL[NJET];
+    float fj1sjPt[NSUBJET];
+    float fj1sjPhi[NSUBJET];
+    float fj1sjEta[NSUBJET];
+    float fj1sjM[NSUBJET];
+    float fj1sjCSV[NSUBJET];
+    float fj1sjQGL[NSUBJET];
+    //! the defaults of entry i of the arrays counted by nfj
+    void ResetNfj(unsigned i) {
+      for (int e=0; e!=96; ++e) fjECFNs[e][i] = -1;
+      fjPt[i] = -1;
+      fjEta[i] = -1;
+      fjPhi[i] = -1;
+      fjM[i] = -1;
+      fjMSD[i] = -1;
+      fjMSD_corr[i] = -1;
+      fjRawPt[i] = -1;
+      fjPtScaleUp[i] = -1;
+      fjPtScaleDown[i] = -1;
+      fjPtSmeared[i] = -1;
+      fjPtSmearedUp[i] = -1;
+      fjPtSmearedDown[i] = -1;
+      fjMSDScaleUp[i] = -1;
+      fjMSDScaleDown[i] = -1;
+      fjMSDSmeared[i] = -1;
+      fjMSDSmearedUp[i] = -1;
+      fjMSDSmearedDown[i] = -1;
+      fjPtScaleUp_sj[i] = -1;
+      fjPtScaleDown_sj[i] = -1;
+      fjPtSmeared_sj[i] = -1;
+      fjMSDScaleUp_sj[i] = -1;
+      fjMSDScaleDown_sj[i] = -1;
+      fjMSDSmeared_sj[i] = -1;
+      fjTau32[i] = -1;
+      fjTau21[i] = -1;
+      fjTau32SD[i] = -1;
+      fjTau21SD[i] = -1;
+      fjMaxCSV[i] = -1;
+      fjMinCSV[i] = -1;
+      fjSubMaxCSV[i] = -1;
+      fjDoubleCSV[i] = -1;
+      fjHTTMass[i] = -1;
+      fjHTTFRec[i] = -1;
+      fjEFrac100[i] = -1;
+      fjSDEFrac100[i] = -1;
+      fjIsClean[i] = 0;
+      fjNConst[i] = 0;
+      fjNSDConst[i] = 0;
+    }
+    //! the defaults of entry i of the arrays counted by nfj1Groom
+    void ResetNfj1Groom(unsigned i) {
+      fj1GroomM[i] = -99;
+      fj1GroomPt[i] = -99;
+      fj1GroomZg[i] = -99;
+      fj1GroomRg[i] = -99;
+    }
+    //! the defaults of entry i of the arrays counted by nfj1Lund
+    void ResetNfj1Lund(unsigned i) {
+      fj1LundLnInvDR[i] = -99;
+      fj1LundLnKt[i] = -99;
+      fj1LundZ[i] = -99;
+    }
+    //! the defaults of entry i of the arrays counted by nJotStored
+    void ResetNJotStored(unsigned i) {
+      jetPt[i] = -99;
+      jetEta[i] = -99;
+      jetPhi[i] = -99;
+      jetE[i] = -99;
+      jetCSV[i] = -99;
+      jetIso[i] = -99;
+      jetQGL[i] = -99;
+    }
+    //! the defaults of entry i of the arrays counted by nfj1sj
+    void ResetNfj1sj(unsigned i) {
+      fj1sjPt[i] = -99;
+      fj1sjPhi[i] = -99;
+      fj1sjEta[i] = -99;
+      fj1sjM[i] = -99;
+      fj1sjCSV[i] = -99;
+      fj1sjQGL[i] = -99;
+    }
+};
 
 #endif
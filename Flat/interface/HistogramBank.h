@@ -0,0 +1,40 @@
+#ifndef PANDAANALYSIS_HistogramBank
+#define PANDAANALYSIS_HistogramBank
+
+#include "PandaCore/Tools/interface/Common.h"
+#include "TH1D.h"
+#include <vector>
+
+/**
+ * \brief Accumulates one observable for several weight variations at once
+ *
+ * The histograms of a bank, e.g. the nominal, PDF and QCD scale variations
+ * of a differential distribution, must share one binning. The bin of an
+ * entry is found once, and the weights of all variations are added to one
+ * contiguous row of a (bin x variation) matrix. The histograms are not
+ * touched until Unload(), typically at Terminate.
+ */
+class HistogramBank
+{
+public:
+	HistogramBank(std::vector<TH1D*> hists_);
+
+	/** TH1::FindFixBin of the shared axis: 0 is the underflow and nBins+1 the overflow */
+	int FindBin(double x) const { return axis->FindFixBin(x); }
+	/** adds weight*factors[iV] to the bin of histogram iV, for every histogram */
+	void Fill(int bin, double weight, const double *factors);
+	void Fill(double x, double weight, const double *factors) { Fill(FindBin(x),weight,factors); }
+	/** adds the accumulated weights and entries to the histograms and clears the matrix */
+	void Unload();
+
+	unsigned GetNVariations() const { return nVariations; }
+	Long64_t GetEntries() const { return nEntries; }
+
+private:
+	std::vector<TH1D*> hists;
+	const TAxis *axis;
+	unsigned nVariations;
+	std::vector<double> sumw, sumw2;  // (nBins+2) rows of nVariations
+	Long64_t nEntries=0;
+};
+#endif
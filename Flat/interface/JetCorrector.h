@@ -3,38 +3,64 @@
 
 #include "PandaCore/Tools/interface/Common.h"
 #include "PandaCore/Tools/interface/DataTools.h"
+#include "PandaCore/Tools/interface/JERReader.h"
 #include <map>
 #include <string>
 #include "TString.h"
+#include "TVector2.h"
 #include "PandaTree/Objects/interface/Jet.h"
 #include "PandaTree/Objects/interface/Met.h"
 #include "CondFormats/JetMETObjects/interface/JetCorrectorParameters.h"
 #include "CondFormats/JetMETObjects/interface/FactorizedJetCorrector.h"
+#include "CondFormats/JetMETObjects/interface/JetCorrectionUncertainty.h"
 
 /**
- * \brief Corrects a jet collection and optionally propagates to Met 
+ * \brief Corrects a jet collection and optionally propagates to Met
  *
+ * All Met variations (JES up/down, JER smearing) are accumulated in the
+ * same loop over the jets as the nominal correction.
+ * If no JEC has been configured, the correction stored in the input jets is used.
  */
 class JetCorrector
 {
 public:
+	enum METShift {
+		kNominal=0,
+		kJESUp,
+		kJESDown,
+		kJER,
+		kJERUp,
+		kJERDown,
+		nMETShift
+	};
+
 	JetCorrector();
 	~JetCorrector();
 
 	void RunCorrection(bool isData, float rho, panda::JetCollection *injets_, panda::Met *rawmet_=0, int runNumber = 0);
 	panda::JetCollection *GetCorrectedJets();
 	panda::Met *GetCorrectedMet();
+	TVector2 GetCorrectedMetVector(METShift shift=kNominal) const { return outmets[shift]; }
 
 	void SetMCCorrector(TString fpath);
 	void SetDataCorrector(TString fpath, TString iov = "all");
+	void SetUncertainty(JetCorrectionUncertainty *unc) { uncReader = unc; } //!< not owned; if unset, use jet.ptCorrUp/Down
+	void SetJER(JERReader *jer) { jerReader = jer; }                        //!< not owned; if unset, no smearing
+
+	// public configuration
+	bool makeJets=true;     //!< build the corrected jet collection, not only the Met
+	float minMetJetPt=0;    //!< only jets above this (shifted) pt are propagated to the Met
 
 private:
-		FactorizedJetCorrector *mMCJetCorrector;	 
+		FactorizedJetCorrector *mMCJetCorrector=0;
 		std::map<TString,FactorizedJetCorrector *> mDataJetCorrectors;	// map from era to corrector
+		JetCorrectionUncertainty *uncReader=0;
+		JERReader *jerReader=0;
 
 		panda::JetCollection *outjets = 0;
 		panda::Met *outmet = 0;
+		TVector2 outmets[nMETShift];
 
-		EraHandler *era = 0;	
+		EraHandler *era = 0;
 };
 #endif
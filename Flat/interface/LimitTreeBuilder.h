@@ -43,7 +43,7 @@ class Process {
 public:
 	Process(TString n, TTree *in, VariableMap *vPtr, TString sel, TString w);
 	~Process();
-	void Run();
+	void Run(unsigned nWriterRows=0); // fill from a background thread if nWriterRows>0
 	TTree *GetTree() { return limitTree; }
 	TTree *GetInput() { return inputTree; }
 	TString name;
@@ -63,10 +63,10 @@ public:
 	~Region() {}
 	void AddProcess(Process *p) { ps.push_back(p); }
 	std::vector<Process*> GetProcesses() { return ps; }
-	void Run() { 
+	void Run(unsigned nWriterRows=0) { 
 		for (auto p : ps) { 
 			PInfo("LimitTreeBuilder::Region::Run",TString::Format("%s",name.Data())); 
-			p->Run(); 
+			p->Run(nWriterRows); 
 		} 
 	}
 	TString name;
@@ -82,8 +82,17 @@ public :
 	void SetOutFile(TString f) { fOut = new TFile(f,"RECREATE"); }
 	void AddRegion(Region *r) { regions.push_back(r); }
 	void cd() { fOut->cd(); }
-	void Run() { for (auto r : regions) { fOut->cd(); r->Run(); } }
+	void Run() { 
+		for (auto r : regions) { 
+			fOut->cd(); 
+			// the baskets go to the output file even if a process was made before SetOutFile
+			for (auto p : r->GetProcesses())
+				p->GetTree()->SetDirectory(fOut);
+			r->Run(nWriterRows); 
+		} 
+	}
 	void Output();
+	unsigned nWriterRows=0; // rows buffered for a background writer thread; 0=>fill inline
 private:
 	std::vector<Region*> regions;
 	TFile *fOut=0;
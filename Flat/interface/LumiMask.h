@@ -0,0 +1,73 @@
+#ifndef PANDAANALYSIS_LumiMask
+#define PANDAANALYSIS_LumiMask
+
+#include "PandaCore/Tools/interface/Common.h"
+#include "TString.h"
+#include "TTree.h"
+#include <vector>
+
+/**
+ * \brief Certified (run, lumi) ranges as a flat sorted table
+ *
+ * Ranges are read directly from a golden JSON file or added one at a time,
+ * then sorted and merged on first use. A lookup is one binary search, and
+ * consecutive events from the same lumi range or the same (run, lumi)
+ * are answered from a cache.
+ */
+class LumiMask
+{
+public:
+	LumiMask() {}
+	~LumiMask() {}
+
+	/** reads {"run": [[l0, l1], ...], ...}; returns false and keeps nothing on a parse error */
+	bool LoadJSON(TString path);
+	void AddRange(int run, int l0, int l1);
+	bool Pass(int run, int lumi);
+	unsigned GetNRanges() { Sort(); return ranges.size(); }
+	bool IsEmpty() const { return ranges.empty(); }
+
+private:
+	struct Range {
+		int run, l0, l1;
+	};
+	void Sort();
+
+	std::vector<Range> ranges;
+	bool sorted=true;
+
+	int lastRun=-1, lastLumi=-1;
+	bool lastPass=false;
+	int lastRange=-1; // index of the range that passed last
+};
+
+/**
+ * \brief (run, lumi) of contiguous blocks of entries of a tree
+ *
+ * Built by reading only the run and lumi branches, so the entries of a lumi
+ * that fails a LumiMask can be skipped before any other branch is read.
+ */
+class LumiEntryIndex
+{
+public:
+	LumiEntryIndex() {}
+	~LumiEntryIndex() {}
+
+	/** indexes entries [first,last) of t; returns false if the branches are missing */
+	bool Build(TTree *t, Long64_t first, Long64_t last,
+	           const char *runBranch="runNumber", const char *lumiBranch="lumiNumber");
+	/** first entry >= iE that is not in a lumi failing mask; entries must be asked in increasing order */
+	Long64_t NextGood(Long64_t iE, LumiMask &mask);
+	Long64_t GetNSkipped() const { return nSkipped; }
+	unsigned GetNBlocks() const { return blocks.size(); }
+
+private:
+	struct Block {
+		int run, lumi;
+		Long64_t first, end;
+	};
+	std::vector<Block> blocks;
+	unsigned cursor=0;
+	Long64_t nSkipped=0;
+};
+#endif
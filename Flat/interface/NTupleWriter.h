@@ -0,0 +1,44 @@
+#ifndef PANDAANALYSIS_NTupleWriter
+#define PANDAANALYSIS_NTupleWriter
+
+#include "PandaCore/Tools/interface/Common.h"
+#include "TFile.h"
+#include "TTree.h"
+
+/**
+ * \brief Writes the branches of a tree as an RNTuple
+ *
+ * The leaf-list branches booked on a tree are used as the schema: each
+ * becomes a field of the same name, read from the branch address at every
+ * Fill(). Scalars and fixed-size arrays are written in place, while
+ * variable-length arrays are copied into a std::vector using their counter.
+ * The tree itself is never filled.
+ *
+ * Needs ROOT 6.32 or later; with older releases Open() fails.
+ */
+class NTupleWriter
+{
+public:
+	NTupleWriter(TTree *schema_, TFile *f_, TString name_="") :
+		schema(schema_), f(f_), name(name_=="" ? TString(schema_->GetName()) : name_) { }
+	~NTupleWriter();
+
+	/** builds the model from the branches of the schema; returns false if a branch is unsupported */
+	bool Open();
+	void Fill();
+	/** commits the pending clusters; called by the destructor */
+	void Close();
+
+	bool IsOpen() const { return impl!=0; }
+	Long64_t GetNFilled() const { return nFilled; }
+
+private:
+	struct Impl;
+
+	TTree *schema;
+	TFile *f;
+	TString name;
+	Impl *impl=0;
+	Long64_t nFilled=0;
+};
+#endif
@@ -0,0 +1,40 @@
+#ifndef PANDAANALYSIS_NumpyWriter
+#define PANDAANALYSIS_NumpyWriter
+
+#include "PandaCore/Tools/interface/Common.h"
+#include <cstdio>
+#include <vector>
+#include "TString.h"
+
+/**
+ * \brief Streams fixed-shape float records into a .npy file
+ *
+ * Each call to Write appends one record of the shape given at Open, so the
+ * result loads with numpy.load as an (nRecords, shape...) array without
+ * going through ROOT. The header is rewritten with the final record count
+ * in Close. Records can be stored as float16 to halve the size.
+ */
+class NumpyWriter
+{
+public:
+	NumpyWriter() {}
+	~NumpyWriter() { Close(); }
+
+	bool Open(TString path, std::vector<unsigned> shape_, bool half_=false);
+	void Write(const float *record); //!< record holds the product of the shape
+	void Close();
+	unsigned long GetNRecords() const { return nRecords; }
+
+	static unsigned short FloatToHalf(float f);
+
+private:
+	void WriteHeader();
+
+	FILE *fout=0;
+	std::vector<unsigned> shape;
+	unsigned recordSize=0;
+	bool half=false;
+	unsigned long nRecords=0;
+	std::vector<unsigned short> halfBuffer;
+};
+#endif
@@ -14,9 +14,20 @@
 #include <TH1D.h>
 #include <TH2F.h>
 #include <TLorentzVector.h>
+#include <TVector2.h>
 
 #include "AnalyzerUtilities.h"
 #include "GeneralTree.h"
+#include "JetCorrector.h"
+#include "EnergyCorrelations.h"
+#include "Declustering.h"
+#include "FlavourLabeller.h"
+#include "DeltaRMatrix.h"
+#include "TriggerMenu.h"
+#include "LumiMask.h"
+#include "ColumnReader.h"
+#include "NumpyWriter.h"
+#include "WorkerPool.h"
 
 // btag
 #include "CondFormats/BTauObjects/interface/BTagEntry.h"
@@ -62,6 +73,12 @@ public :
         kSignal,
     };
 
+    enum ReclusterMode {
+        kReclusterEvent,        // all PF candidates in the event
+        kReclusterCone,         // PF candidates within reclusterConeDR of fj1
+        kReclusterConstituents  // constituents stored in fj1
+    };
+
     enum TriggerBits {
         kMETTrig       =(1<<0),
         kSingleEleTrig =(1<<1),
@@ -74,7 +91,10 @@ public :
     PandaAnalyzer(int debug_=0);
     ~PandaAnalyzer();
     int Init(TTree *tree, TH1D *hweights, TTree *weightNames=0);
-    void SetOutputFile(TString fOutName);
+    void SetOutputFile(TString fOutName, TString profile="default"); // see genericTree::SetOutputProfile
+    void AddCompressionOverride(TString pattern, TString algorithm, int level) {
+      gt->AddCompressionOverride(pattern,genericTree::CompressionSettings(algorithm,level));
+    }
     void ResetBranches();
     void Run();
     void Terminate();
@@ -86,13 +106,24 @@ public :
             preselBits &= ~b;
     }
     void AddGoodLumiRange(int run, int l0, int l1);
+    bool LoadGoodLumis(TString jsonPath) { return goodLumis.LoadJSON(jsonPath); } // golden JSON
+    void SetECFBetas(std::vector<double> betas); // recompute fj1 ECFs for these betas
+    void AddGroomingPoint(double beta, double zcut) { groomPoints.push_back(std::make_pair(beta,zcut)); }
 
     // public configuration
     void SetFlag(TString flag, bool b=true) { flags[flag]=b; }
     bool isData=false;                                                 // to do gen matching, etc
     int firstEvent=-1;
     int lastEvent=-1;                                                    // max events to process; -1=>all
+    unsigned nWriterRows=0;                                // rows buffered for a background writer thread; 0=>fill inline
+    bool ntupleOutput=false;                               // write the output tree as an RNTuple of the same name
     ProcessType processType=kNone;                         // determine what to do the jet matching to
+    ReclusterMode reclusterMode=kReclusterEvent;           // which PF candidates are reclustered for fj1
+    double reclusterConeDR=2.0;                            // size of the region around fj1 (candidates and ghosts)
+    double subjetRadius=0.4;                               // C/A radius of the fj1 subjets in the flavour ghost association
+    unsigned ecfTopK=100;                                  // hardest constituents used by recalcECF; 0=>all
+    int nThreads=1;                                        // threads for the per-fatjet substructure; 1 in kReclusterEvent mode
+    TString constituentFile="";                            // with the constituents flag, also stream fj1 constituents to this .npy
 
 private:
     enum CorrectionType { //!< enum listing relevant corrections applied to MC
@@ -157,21 +188,85 @@ private:
                     GeneralTree::BTagShift shift,GeneralTree::BTagJet jettype, bool do2=false);
     void OpenCorrection(CorrectionType,TString,TString,int);
     double GetCorr(CorrectionType ct,double x, double y=0);
-    void RegisterTrigger(TString path, std::vector<unsigned> &idxs); 
+    void SetMETShifts(TVector2 *shifts, float &up, float &down, 
+                      float &smeared, float &smearedUp, float &smearedDown);
+    void RegisterTrigger(TString path, unsigned groupBit); //!< adds path to the triggerMenu group with this TriggerBits flag
+    void FatjetBasics(unsigned iFJ, panda::FatJet &fj, 
+                      FactorizedJetCorrector *scaleReaderAK4, JetCorrectionUncertainty *uncReaderAK4);
+    void RunFatjetSubstructure(std::vector<panda::FatJet*> &selFatjets);
+    void FillConstituentArrays(panda::FatJet &fj);
+    void WriteConstituentRecord();
+    void LoadKFactors(TString dirPath);
+    unsigned int FindGenObjects(); //!< fills genObjects and returns the target pdgid
+    void FillTTbarGen();
+    void FillBosonSFs(float genBosonPtMin, float genBosonPtMax);
+    void FillSignalGen();
+    void FillGenWeights();
+    void RunGenOnly(unsigned int nZero, unsigned int nEvents, float genBosonPtMin, float genBosonPtMax);
+    void ConfigureStages(); //!< decides which optional stages have surviving outputs
+    bool SetupColumnPreselection(); //!< columns for the necessary conditions of the preselection, if any
+    bool PassColumnPreselection(unsigned int iE, unsigned int nEvents);
+
+    // optional stages, skipped if RemoveBranches dropped everything they fill
+    bool doSubjetJES=true, doECFs=true, doRecoilShifts=true;
+    bool doBTagShifts=true, doSubjetBTagShifts=true;
 
     int DEBUG = 0; //!< debug verbosity level
     std::map<TString,bool> flags;
 
     std::map<panda::GenParticle const*,float> genObjects;                 //!< particles we want to match the jets to, and the 'size' of the daughters
     panda::GenParticle const* MatchToGen(double eta, double phi, double r2, int pdgid=0);        //!< private function to match a jet; returns NULL if not found
-    std::map<int,std::vector<LumiRange>> goodLumis;
+    void BuildGenGrids();
+    std::vector<panda::GenParticle const*> genObjList;       //!< genObjects, indexed by genObjGrid
+    EtaPhiGrid genObjGrid;                                   //!< spatial index over genObjects
+    FlavourLabeller flavourLabeller;                         //!< ghost-association flavor of AK4 jets and subjets
+    EtaPhiArrays lepArrays, phoArrays, objArrays;            //!< matchLeps, matchPhos, and the collection being cleaned
+    DeltaRMatrix drMatrix;
+    BitMask cleanMask;                                       //!< set for objects overlapping a lepton or photon
+    template <typename C>
+    void CleaningMask(C &objects, float r2, bool photons) {
+      objArrays.Fill(objects);
+      cleanMask.Reset(objArrays.size());
+      drMatrix.Match(objArrays,lepArrays,r2,cleanMask);
+      if (photons)
+        drMatrix.Match(objArrays,phoArrays,r2,cleanMask);
+    }
+    std::vector<unsigned> gridHits;
+    LumiMask goodLumis;                                      //!< certified lumis, if applyJSON
+    LumiEntryIndex lumiIndex;                                //!< input entries by (run, lumi), to skip failing lumis
+    ColumnReader *columns=0;                                 //!< recoil and fatjet columns, if columnPreselection
+    int cRecoil=-1, cFatjets=-1;
+    std::vector<char> colPass;                               //!< entries of the current block passing the columns
+    static const unsigned int colBlockSize = 1024;
+    TriggerMenu triggerMenu;                                 //!< HLT paths by TriggerBits group
     std::vector<panda::Particle*> matchPhos, matchEles, matchLeps;
     
     // fastjet reclustering
     fastjet::JetDefinition *jetDef=0;
-    fastjet::contrib::SoftDrop *softDrop=0;
     fastjet::AreaDefinition *areaDef=0;
     fastjet::GhostedAreaSpec *activeArea=0;
+    int activeAreaRepeats=1;
+    double ghostArea=0.01;
+    std::vector<std::pair<double,double>> groomPoints = {{0.,0.1},{1.,0.1},{2.,0.1}}; //!< (beta,zcut) on top of the default soft drop
+
+    // per-thread scratch for the fatjet substructure
+    struct FatjetWorker {
+      FatjetWorker(double R0, unsigned nReserve) : arena(nReserve), declust(R0) { }
+      ~FatjetWorker() { delete ecfCalc; }
+      ReclusterArena arena;      //!< buffers reused across events
+      JetDeclusterer declust;    //!< declustering shared by all grooming points
+      ECFCalculator *ecfCalc=0;  //!< in-skim ECFs, only with recalcECF
+    };
+    std::vector<FatjetWorker*> fjWorkers;
+    WorkerPool *fjPool=0;        //!< runs fjWorkers[1..] if there is more than one
+    void FatjetSubstructure(unsigned iFJ, panda::FatJet &fj, FatjetWorker &w,
+                            const fastjet::ClusterSequence *eventSeq, bool puppi, bool recluster);
+
+    // constituent arrays for training
+    static const unsigned nConstFeatures = 6; //!< ptFrac, dEta, dPhi, puppiW, charge, pdgId
+    std::vector<std::pair<float,const panda::PFCand*>> constSort;
+    std::vector<float> constRecord;
+    NumpyWriter *constWriter=0;
 
     // CMSSW-provided utilities
 
@@ -181,10 +276,12 @@ private:
     std::vector<BTagCalibrationReader*> btagReaders = std::vector<BTagCalibrationReader*>(bN,0); //!< maps BTagType to a reader 
     
     std::map<TString,JetCorrectionUncertainty*> ak8UncReader; //!< calculate JES unc on the fly
-    JERReader *ak8JERReader; //!< fatjet jet energy resolution reader
+    JERReader *ak8JERReader=0; //!< fatjet jet energy resolution reader
     std::map<TString,JetCorrectionUncertainty*> ak4UncReader; //!< calculate JES unc on the fly
     std::map<TString,FactorizedJetCorrector*> ak4ScaleReader; //!< calculate JES on the fly
-    JERReader *ak4JERReader; //!< fatjet jet energy resolution reader
+    JERReader *ak4JERReader=0; //!< fatjet jet energy resolution reader
+    JERReader *ak4chsJERReader=0; //!< CHS jet energy resolution reader, for the pf met shifts
+    JetCorrector *jetCorr=0; //!< propagates AK4 JES/JER variations to MET
     EraHandler eras = EraHandler(2016); //!< determining data-taking era, to be used for era-dependent JEC
 
     // files and histograms containing weights
@@ -17,6 +17,12 @@
 
 #include "AnalyzerUtilities.h"
 #include "GeneralLeptonicTree.h"
+#include "FlavourLabeller.h"
+#include "DeltaRMatrix.h"
+#include "TriggerMenu.h"
+#include "LumiMask.h"
+#include "TriggerObjectMatcher.h"
+#include "HistogramBank.h"
 
 // btag
 #include "CondFormats/BTauObjects/interface/BTagEntry.h"
@@ -87,7 +93,10 @@ public :
     PandaLeptonicAnalyzer(int debug_=0);
     ~PandaLeptonicAnalyzer();
     int Init(TTree *tree, TH1D *hweights, TTree *weightNames=0);
-    void SetOutputFile(TString fOutName);
+    void SetOutputFile(TString fOutName, TString profile="default"); // see genericTree::SetOutputProfile
+    void AddCompressionOverride(TString pattern, TString algorithm, int level) {
+      gt->AddCompressionOverride(pattern,genericTree::CompressionSettings(algorithm,level));
+    }
     void ResetBranches();
     void Run();
     void Terminate();
@@ -100,12 +109,15 @@ public :
             preselBits &= ~b;
     }
     void AddGoodLumiRange(int run, int l0, int l1);
+    bool LoadGoodLumis(TString jsonPath) { return goodLumis.LoadJSON(jsonPath); } // golden JSON
 
     // public configuration
     void SetFlag(TString flag, bool b=true) { flags[flag]=b; }
     bool isData=false;                                                 // to do gen matching, etc
     int firstEvent=-1;
     int lastEvent=-1;                                                    // max events to process; -1=>all
+    unsigned nWriterRows=0;                                // rows buffered for a background writer thread; 0=>fill inline
+    bool ntupleOutput=false;                               // write the output tree as an RNTuple of the same name
     ProcessType processType=kNone;                         // determine what to do the jet matching to
 
 private:
@@ -196,15 +208,24 @@ private:
     void OpenCorrection(CorrectionType,TString,TString,int);
     double GetCorr(CorrectionType ct,double x, double y=0);
     double GetError(CorrectionType ct,double x, double y=0);
-    void RegisterTrigger(TString path, std::vector<unsigned> &idxs); 
+    void RegisterTrigger(TString path, unsigned groupBit); //!< adds path to the triggerMenu group with this TriggerBits flag
 
     int DEBUG = 0; //!< debug verbosity level
     std::map<TString,bool> flags;
 
     std::map<panda::GenParticle const*,float> genObjects;                 //!< particles we want to match the jets to, and the 'size' of the daughters
     panda::GenParticle const* MatchToGen(double eta, double phi, double r2, int pdgid=0);        //!< private function to match a jet; returns NULL if not found
-    std::map<int,std::vector<LumiRange>> goodLumis;
+    LumiMask goodLumis;                                      //!< certified lumis, if applyJSON
+    LumiEntryIndex lumiIndex;                                //!< input entries by (run, lumi), to skip failing lumis
+    TriggerMenu triggerMenu;                                 //!< HLT paths by TriggerBits group
+    TriggerObjectMatcher trigObjMatcher;                     //!< HLT filter objects, indexed once per event
+    uint64_t muTrigFilters=0, muFakeTrigFilters=0;           //!< trigObjMatcher masks
+    uint64_t eleTrigFilters=0, eleFakeTrigFilters=0;
     std::vector<panda::Particle*> matchVeryLoosePhos, matchPhos, matchEles, matchLeps;
+    EtaPhiArrays lepArrays, phoArrays, objArrays;            //!< matchLeps, matchVeryLoosePhos, and the collection being cleaned
+    DeltaRMatrix drMatrix;
+    BitMask lepMask, phoMask;                                //!< set for objects overlapping a lepton, photon
+    FlavourLabeller flavourLabeller;                         //!< ghost-association flavor of AK4 jets
     
     // CMSSW-provided utilities
 
@@ -292,6 +313,20 @@ private:
     TH1D *hDWWPTLL0JET;  TH1D *hDWWPTLL0JET_PDF;  TH1D *hDWWPTLL0JET_QCD;  TH1D *hDWWPTLL0JET_QCDPart[6];  TH1D *hDWWPTLL0JET_NNLO;  TH1D *hDWWPTLL0JET_NNLOPart[4];
     TH1D *hDWWN0JET;     TH1D *hDWWN0JET_PDF;	  TH1D *hDWWN0JET_QCD;	   TH1D *hDWWN0JET_QCDPart[6];	   TH1D *hDWWN0JET_NNLO;     TH1D *hDWWN0JET_NNLOPart[4];
     TH1D *hDWWNJET;      TH1D *hDWWNJET_PDF;	  TH1D *hDWWNJET_QCD;	   TH1D *hDWWNJET_QCDPart[6];	   TH1D *hDWWNJET_NNLO;      TH1D *hDWWNJET_NNLOPart[4];
+    // the nominal, PDF, QCD and NNLO parts of each family above are filled through one bank;
+    // hDWWNJET is filled directly, since its parts are binned differently
+    HistogramBank *bDDilPtMM=0, *bDDilPtEE=0, *bDDilHighPtIncMM=0, *bDDilHighPtIncEE=0,
+                  *bDDilHighPtMM=0, *bDDilHighPtEE=0, *bDDilHighPtNN=0, *bDFidHighPtNN=0,
+                  *bDDilRapMM=0, *bDDilRapEE=0, *bDDilPhiStarMM=0, *bDDilPhiStarEE=0,
+                  *bDDilPtRap0MM=0, *bDDilPtRap0EE=0, *bDDilPtRap1MM=0, *bDDilPtRap1EE=0,
+                  *bDDilPtRap2MM=0, *bDDilPtRap2EE=0, *bDDilPtRap3MM=0, *bDDilPtRap3EE=0,
+                  *bDDilPtRap4MM=0, *bDDilPtRap4EE=0, *bDSSWWMJJQCD=0, *bDSSWWMJJ=0, *bDSSWWMLL=0,
+                  *bDSSWWPTL1=0, *bDNoEWKCorrSSWWMJJ=0, *bDNoEWKCorrSSWWMLL=0,
+                  *bDNoEWKCorrSSWWPTL1=0, *bDWZMJJ=0, *bDNoEWKCorrWZMJJ=0, *bDWWMLL=0,
+                  *bDWWDPHILL=0, *bDWWPTL1=0, *bDWWPTL2=0, *bDWWPTLL=0, *bDWWMLL0JET=0,
+                  *bDWWDPHILL0JET=0, *bDWWPTL10JET=0, *bDWWPTL20JET=0, *bDWWPTLL0JET=0,
+                  *bDWWN0JET=0;
+    std::vector<HistogramBank*> banks; //! not streamed
     TTree *tIn=0;    // input tree to read
     unsigned int preselBits=0;
 
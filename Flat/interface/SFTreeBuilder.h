@@ -16,6 +16,7 @@
 
 #include "PandaCore/Tools/interface/Common.h"
 #include "PandaCore/Tools/interface/TreeTools.h"
+#include "AsyncTreeWriter.h"
 /////////////////////////////////////////////////////////////////////////////
 // some misc definitions
 
@@ -39,6 +40,7 @@ public :
   TString inTreeName="events";
   int firstEvent=-1;
   int lastEvent=-1;                          // max events to process; -1=>all
+  unsigned nWriterRows=0;                    // rows buffered for a background writer thread; 0=>fill inline
 
 private:
 
@@ -63,6 +65,7 @@ private:
   // IO for the analyzer
   TFile *fOut;   // output file is owned by SFTreeBuilder
   TTree *tOut;
+  AsyncTreeWriter *writer=0; //! not streamed
 
 };
 
@@ -0,0 +1,85 @@
+#ifndef PANDAANALYSIS_TriggerMenu
+#define PANDAANALYSIS_TriggerMenu
+
+#include "TString.h"
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * \brief Groups of HLT paths compiled into bitmasks
+ *
+ * Every distinct path gets one bit, however many groups it belongs to, and
+ * each group is a mask over those bits. Per event every path is evaluated
+ * once and each group is one AND against the fired word.
+ * Groups are identified by their flag in the output trigger word.
+ *
+ * The paths that fired are accumulated per run, so paths that never fire
+ * in a run, or in the whole job, can be listed and dropped.
+ */
+class TriggerMenu
+{
+public:
+	TriggerMenu() {}
+	~TriggerMenu() {}
+
+	/** adds path to the group with output flag groupBit; token is from Event::registerTrigger */
+	void AddPath(unsigned groupBit, TString path, unsigned token);
+	unsigned GetNPaths() const { return paths.size(); }
+
+	/** returns the OR of the flags of all groups with a path that fired */
+	template <typename E>
+	unsigned Evaluate(E &event, int run);
+
+	/** paths that never fired in this run, or in any run if run<0 */
+	std::vector<TString> GetDeadPaths(int run=-1) const;
+	std::vector<int> GetRuns() const;
+
+private:
+	void Compile();
+	void NewRun(int run);
+	bool Test(const std::vector<uint64_t> &w, unsigned iP) const { return (w[iP>>6]>>(iP&63))&1; }
+
+	std::vector<TString> paths;
+	std::vector<unsigned> tokens;
+	std::vector<std::pair<unsigned,std::vector<unsigned>>> groupPaths; // flag, path bits
+	std::vector<std::pair<unsigned,std::vector<uint64_t>>> groupMasks; // flag, mask
+
+	bool compiled=false;
+	unsigned nWords=0;
+	std::vector<uint64_t> fired;
+	int currentRun=-1;
+	std::map<int,std::vector<uint64_t>> firedPerRun;
+};
+
+template <typename E>
+unsigned TriggerMenu::Evaluate(E &event, int run)
+{
+	if (!compiled)
+		Compile();
+	if (run!=currentRun)
+		NewRun(run);
+
+	std::fill(fired.begin(),fired.end(),0);
+	unsigned nP = paths.size();
+	for (unsigned iP=0; iP!=nP; ++iP) {
+		if (event.triggerFired(tokens[iP]))
+			fired[iP>>6] |= (uint64_t(1)<<(iP&63));
+	}
+
+	std::vector<uint64_t> &runFired = firedPerRun[currentRun];
+	unsigned result = 0;
+	for (unsigned iW=0; iW!=nWords; ++iW)
+		runFired[iW] |= fired[iW];
+	for (auto &g : groupMasks) {
+		for (unsigned iW=0; iW!=nWords; ++iW) {
+			if (fired[iW] & g.second[iW]) {
+				result |= g.first;
+				break;
+			}
+		}
+	}
+	return result;
+}
+#endif
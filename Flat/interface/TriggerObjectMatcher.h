@@ -0,0 +1,79 @@
+#ifndef PANDAANALYSIS_TriggerObjectMatcher
+#define PANDAANALYSIS_TriggerObjectMatcher
+
+#include "AnalyzerUtilities.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/**
+ * \brief dR matching of reco objects to HLT filter objects
+ *
+ * Filter names are resolved to ids (bits) once at configuration. Each event
+ * the objects of every filter are looked up once and stored as one span per
+ * filter, so matching an object returns the bitmask of filters it passed
+ * without any string handling.
+ */
+class TriggerObjectMatcher
+{
+public:
+	static const unsigned maxFilters = 64;
+
+	TriggerObjectMatcher() {}
+	~TriggerObjectMatcher() {}
+
+	/** returns the id of the filter, registering it if needed */
+	unsigned AddFilter(TString name);
+	static uint64_t Bit(unsigned id) { return uint64_t(1)<<id; }
+	/** mask of the given filters, registering them if needed */
+	uint64_t AddFilters(std::vector<TString> names);
+
+	template <typename C>
+	void Index(C &triggerObjects);
+	/** bitmask of the filters with an object within dR2<r2 of p */
+	template <typename P>
+	uint64_t Match(const P &p, double r2=0.01) const;
+
+private:
+	std::vector<std::string> names;
+	std::vector<unsigned> spanStart; // objects of filter i are [spanStart[i],spanStart[i+1])
+	std::vector<float> eta, phi;
+};
+
+template <typename C>
+void TriggerObjectMatcher::Index(C &triggerObjects)
+{
+	eta.clear(); phi.clear();
+	unsigned nF = names.size();
+	spanStart.resize(nF+1);
+	for (unsigned iF=0; iF!=nF; ++iF) {
+		spanStart[iF] = eta.size();
+		for (auto &obj : triggerObjects.filterObjects(names[iF])) {
+			if (obj->pt()<=0)
+				continue;
+			eta.push_back(obj->eta());
+			phi.push_back(obj->phi());
+		}
+	}
+	spanStart[nF] = eta.size();
+}
+
+template <typename P>
+uint64_t TriggerObjectMatcher::Match(const P &p, double r2) const
+{
+	uint64_t passed = 0;
+	if (p.pt()<=0)
+		return passed;
+	double pEta = p.eta(), pPhi = p.phi();
+	unsigned nF = names.size();
+	for (unsigned iF=0; iF!=nF; ++iF) {
+		for (unsigned iO=spanStart[iF]; iO!=spanStart[iF+1]; ++iO) {
+			if (DeltaR2(pEta,pPhi,eta[iO],phi[iO])<r2) {
+				passed |= Bit(iF);
+				break;
+			}
+		}
+	}
+	return passed;
+}
+#endif
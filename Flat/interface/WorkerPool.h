@@ -0,0 +1,40 @@
+#ifndef PANDAANALYSIS_WorkerPool
+#define PANDAANALYSIS_WorkerPool
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * \brief A fixed set of threads that run one job per worker index
+ *
+ * The threads are started once and sleep between calls to Run(), so a
+ * per-event job does not pay for thread creation. The calling thread is
+ * worker 0; workers 1 to nWorkers-1 are background threads.
+ */
+class WorkerPool
+{
+public:
+	WorkerPool(unsigned nWorkers_);
+	~WorkerPool();
+
+	/** runs job(iW) for every iW < n (at most nWorkers) and returns when all are done */
+	void Run(unsigned n, std::function<void(unsigned)> job);
+	unsigned GetNWorkers() const { return nWorkers; }
+
+private:
+	void Loop(unsigned iW);
+
+	unsigned nWorkers;
+	std::vector<std::thread> threads;
+	std::function<void(unsigned)> current;
+	unsigned nActive=0, nPending=0;
+	unsigned long generation=0;     // incremented by every Run()
+	bool stop=false;
+
+	std::mutex mtx;
+	std::condition_variable cvStart, cvDone;
+};
+#endif
@@ -13,19 +13,102 @@
 #define NMAX 8
 #define NGENMAX 100
 
+class AsyncTreeWriter;
+class NTupleWriter;
+
 class genericTree {
   public:
     genericTree() {};
-    virtual ~genericTree() {};
+    virtual ~genericTree();
+    //! trees are allocated on this boundary, which the generated blocks are aligned to;
+    //! plain new does not honour over-aligned types before C++17
+    static const size_t blockAlignment = 64;
+    static void *operator new(size_t size);
+    static void *operator new(size_t, void *p) { return p; }
+    static void operator delete(void *p);
+    static void operator delete(void *, void *) {}
     TTree *treePtr{0};
     virtual void WriteTree(TTree *t)=0;
     virtual void RemoveBranches(std::vector<TString> droppable,
                                 std::vector<TString> keeppable={}) final;
+    //! true if a booked branch matches any of the patterns; valid once WriteTree has been called
+    bool IsActive(std::vector<TString> patterns) const;
+
+    // output profile, to be set before WriteTree
+    //! ROOT compression settings, 100*algorithm+level, for "zlib", "lzma", "lz4" (ROOT>=6.14) or "zstd" (ROOT>=6.20); else zlib
+    static int CompressionSettings(TString algorithm, int level);
+    //! compression of all booked branches; -1 keeps the setting of the output file
+    void SetCompression(int settings) { compression = settings; }
+    int GetCompression() const { return compression; }
+    //! "default" keeps the file's setting; "fast" (LZ4, ROOT>=6.14, else zlib with a warning) for skims
+    //! that are read again; "archive" (LZMA, any ROOT) for final trees
+    bool SetOutputProfile(TString profile);
+    //! compression of the branches matching pattern; the first matching override wins
+    void AddCompressionOverride(TString pattern, int settings);
+    //! share this many bytes of baskets among the booked branches by entry size, within [minBasket,maxBasket]; 0 keeps ROOT's default
+    void SetBasketBudget(Long64_t bytes) { basketBudget = bytes; }
+    //! compressed and uncompressed bytes of every booked branch, largest first
+    void PrintBranchSizes() const;
+
+    // reduced precision, to be set before WriteTree; the rules only apply once enabled
+    //! store float branches matching pattern as Float16_t, truncated to 2-14 mantissa bits
+    void SetPrecision(TString pattern, int mantissaBits);
+    //! store float branches matching pattern as Float16_t, packed into [min,max] with this many bits
+    void SetPrecision(TString pattern, double min, double max, int bits);
+    //! apply the SetPrecision rules; needs ROOT 6.20 for Float16_t leaves, else everything stays full precision
+    void EnablePrecision(bool on=true);
+    //! true if this ROOT can book Float16_t ("/f") leaves, i.e. ROOT>=6.20
+    static bool HasFloat16();
+    //! measure the rounding error of every filled value of a reduced scalar or fixed-size array
+    void SetPrecisionValidation(bool on) { validatePrecision = on; }
+    //! per SetPrecision: branches, bytes, and the measured rounding error if validated
+    void PrintPrecisionReport() const;
+    //! the value ROOT reads back after storing x as Float16_t [min,max,bits]
+    static float Quantize(float x, double min, double max, int bits);
+
+    //! fill treePtr from a background thread, buffering up to nRows rows; call after WriteTree
+    bool StartAsyncWriter(unsigned nRows=256);
+    //! write the booked branches as an RNTuple in f instead of filling treePtr; call after WriteTree
+    bool StartNTupleOutput(TFile *f, TString name="");
+    bool HasNTuple() const { return ntuple!=0; }
+    //! waits for the buffered rows and commits the RNTuple; must be called before treePtr is written
+    void FinishWriting();
+    //! fills treePtr, or the writer thread or RNTuple if one was started
+    void FillTree();
+
+    static const Int_t minBasket = 8*1024;
+    static const Int_t maxBasket = 512*1024;
+    static const Long64_t defaultBasketBudget = 32*1024*1024;
   protected: 
     virtual bool Book(TString bname, void *address, TString leafs) final;
+    void SizeBaskets();
 
   private:
     std::vector<TRegexp> r_droppable, r_keeppable;
+    std::vector<TString> booked;
+    int compression{-1};
+    std::vector<std::pair<TRegexp,int>> r_compression;
+    Long64_t basketBudget{0};
+    bool basketsSized{false};
+    struct Precision {
+      TString pattern;
+      TRegexp r;
+      double min, max;
+      int bits;
+      std::vector<TString> branches;
+      Long64_t nValues;
+      double maxAbsErr, maxRelErr;
+    };
+    std::vector<Precision> precisions;
+    bool precisionEnabled{false}, validatePrecision{false};
+    struct Reduced {
+      float *address;
+      unsigned n;
+      unsigned iP;
+    };
+    std::vector<Reduced> reduced;
+    AsyncTreeWriter *writer{0}; //! not streamed
+    NTupleWriter *ntuple{0}; //! not streamed
 };
 
 #endif
@@ -0,0 +1,147 @@
+#include "../interface/AsyncTreeWriter.h"
+#include "TROOT.h"
+#include "TLeaf.h"
+#include <algorithm>
+#include <cstring>
+
+bool AsyncTreeWriter::Start()
+{
+	if (running || !t)
+		return running;
+
+	// all source addresses, including those of the counters, are taken
+	// before any branch is pointed at its staging buffer
+	std::vector<Column> cols;
+	TObjArray *branches = t->GetListOfBranches();
+	for (int iB=0; iB!=branches->GetEntriesFast(); ++iB) {
+		TBranch *b = static_cast<TBranch*>(branches->At(iB));
+		Column c;
+		c.b = b;
+		c.src = b->GetAddress();
+		if (b->IsA()!=TBranch::Class() || !c.src) {
+			PError("AsyncTreeWriter::Start",TString("Cannot buffer branch ")+b->GetName());
+			return false;
+		}
+		TObjArray *leaves = b->GetListOfLeaves();
+		for (int iL=0; iL!=leaves->GetEntriesFast(); ++iL) {
+			TLeaf *l = static_cast<TLeaf*>(leaves->At(iL));
+			unsigned bytes = l->GetLenType()*l->GetLenStatic();
+			TLeaf *lc = l->GetLeafCount();
+			if (lc) {
+				if (leaves->GetEntriesFast()!=1 || TString(lc->GetTypeName())!="Int_t") {
+					PError("AsyncTreeWriter::Start",TString("Cannot buffer variable-length branch ")+b->GetName());
+					return false;
+				}
+				c.count = reinterpret_cast<const Int_t*>(lc->GetBranch()->GetAddress()+lc->GetOffset());
+				c.bytes = bytes;
+			} else {
+				c.bytes = std::max(c.bytes,(unsigned)l->GetOffset()+bytes);
+			}
+		}
+		c.staging.resize(c.count ? 16*c.bytes : c.bytes);
+		cols.push_back(c);
+	}
+
+	columns.swap(cols);
+	for (auto &c : columns)
+		c.b->SetAddress(c.staging.data());
+
+	ROOT::EnableThreadSafety();
+	rows.assign(nRows,Row());
+	head = 0; nQueued = 0; done = false;
+	running = true;
+	thread = std::thread(&AsyncTreeWriter::Loop,this);
+	return true;
+}
+
+void AsyncTreeWriter::Fill()
+{
+	if (!running) {
+		t->Fill();
+		return;
+	}
+
+	unsigned tail;
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		if (nQueued==nRows) {
+			++nStalls;
+			cvSpace.wait(lock,[this]{ return nQueued<nRows; });
+		}
+		tail = (head+nQueued)%nRows;
+	}
+
+	// the writer does not touch this row until it is queued
+	Row &r = rows[tail];
+	r.data.clear();
+	r.sizes.resize(columns.size());
+	for (unsigned iC=0; iC!=columns.size(); ++iC) {
+		const Column &c = columns[iC];
+		unsigned n = c.count ? c.bytes*std::max(*(c.count),0) : c.bytes;
+		r.sizes[iC] = n;
+		r.data.insert(r.data.end(),c.src,c.src+n);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		++nQueued;
+	}
+	cvData.notify_one();
+	++nFilled;
+}
+
+void AsyncTreeWriter::Loop()
+{
+	while (true) {
+		unsigned iR;
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			cvData.wait(lock,[this]{ return nQueued>0 || done; });
+			if (nQueued==0)
+				break;
+			iR = head;
+		}
+
+		const Row &r = rows[iR];
+		const char *p = r.data.data();
+		for (unsigned iC=0; iC!=columns.size(); ++iC) {
+			Column &c = columns[iC];
+			unsigned n = r.sizes[iC];
+			if (n>c.staging.size()) {
+				c.staging.resize(2*n);
+				c.b->SetAddress(c.staging.data());
+			}
+			std::memcpy(c.staging.data(),p,n);
+			p += n;
+		}
+		t->Fill();
+
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			head = (head+1)%nRows;
+			--nQueued;
+		}
+		cvSpace.notify_one();
+	}
+}
+
+void AsyncTreeWriter::Finish()
+{
+	if (!running)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		done = true;
+	}
+	cvData.notify_one();
+	thread.join();
+
+	for (auto &c : columns)
+		c.b->SetAddress(c.src);
+	running = false;
+
+	PInfo("AsyncTreeWriter::Finish",
+	      TString::Format("Filled %lld entries of %s; the event loop waited for the writer %lld times",
+	                      nFilled,t->GetName(),nStalls));
+}
@@ -25,6 +25,8 @@ void BTagTreeBuilder::SetOutputPath(TString fOutName) {
 
 	bt->Reset();
 	bt->WriteTree(tOut);
+	if (ntupleOutput)
+		ntupleOutput = bt->StartNTupleOutput(fOut);
 
 }
 
@@ -34,7 +36,9 @@ void BTagTreeBuilder::SetInput(TString fInName) {
 }
 
 void BTagTreeBuilder::Terminate() {
-	fOut->WriteTObject(tOut);
+	bt->FinishWriting();
+	if (!bt->HasNTuple())
+		fOut->WriteTObject(tOut);
 	fOut->Close();
 
 	fIn->Close();
@@ -104,7 +108,7 @@ void BTagTreeBuilder::Run() {
 			bt->flavor     = int(jet1Flav);
 			bt->csv        = jet1CSV;
 			bt->idx        = 1;
-			tOut->Fill();
+			bt->FillTree();
 		}
 		if (jet2Pt>20) {
 			bt->pt         = jet2Pt;
@@ -113,7 +117,7 @@ void BTagTreeBuilder::Run() {
 			bt->flavor     = int(jet2Flav);
 			bt->csv        = jet2CSV;
 			bt->idx        = 2;
-			tOut->Fill();
+			bt->FillTree();
 		}
 
 	}
@@ -0,0 +1,107 @@
+#include "../interface/ColumnReader.h"
+#include <cstring>
+
+ColumnReader::ColumnReader(TString fileName, TString treeName)
+{
+	f = TFile::Open(fileName);
+	if (f && !f->IsZombie())
+		t = dynamic_cast<TTree*>(f->FindObjectAny(treeName));
+	if (!t)
+		PError("ColumnReader::ColumnReader","Could not read "+treeName+" from "+fileName);
+}
+
+ColumnReader::~ColumnReader()
+{
+	if (f)
+		f->Close();
+	delete f;
+}
+
+int ColumnReader::Add(TString name, std::vector<TString> leaves, bool sized)
+{
+	if (!t)
+		return -1;
+
+	Collection c;
+	c.name = name;
+	if (sized) {
+		c.sizeBranch = t->GetBranch(name+".size");
+		if (!c.sizeBranch) {
+			PError("ColumnReader::Add","Could not find "+name+".size");
+			return -1;
+		}
+		c.sizeLeaf = static_cast<TLeaf*>(c.sizeBranch->GetListOfLeaves()->At(0));
+	}
+
+	for (auto &leaf : leaves) {
+		TBranch *b = t->GetBranch(name+"."+leaf);
+		if (!b) {
+			PError("ColumnReader::Add","Could not find "+name+"."+leaf);
+			return -1;
+		}
+		TLeaf *l = static_cast<TLeaf*>(b->GetListOfLeaves()->At(0));
+		c.leafNames.push_back(leaf);
+		c.branches.push_back(b);
+		c.leaves.push_back(l);
+		c.isFloat.push_back(TString(l->GetTypeName())=="Float_t");
+	}
+	c.columns.resize(leaves.size());
+
+	collections.push_back(c);
+	return collections.size()-1;
+}
+
+unsigned ColumnReader::ReadBlock(Long64_t first, Long64_t last)
+{
+	if (!t)
+		return 0;
+	if (last>t->GetEntries())
+		last = t->GetEntries();
+	firstEntry = first;
+	nEvents = (last>first) ? last-first : 0;
+
+	for (auto &c : collections) {
+		// the offsets come from one pass over the size branch...
+		c.offsets.resize(nEvents+1);
+		c.offsets[0] = 0;
+		for (unsigned iEvt=0; iEvt!=nEvents; ++iEvt) {
+			unsigned n = 1;
+			if (c.sizeBranch) {
+				c.sizeBranch->GetEntry(first+iEvt);
+				n = c.sizeLeaf->GetValue();
+			}
+			c.offsets[iEvt+1] = c.offsets[iEvt]+n;
+		}
+
+		// ...then each leaf is read across the whole block, so its baskets are unpacked in order
+		for (unsigned iL=0; iL!=c.leaves.size(); ++iL) {
+			TBranch *b = c.branches[iL];
+			TLeaf *l = c.leaves[iL];
+			std::vector<float> &col = c.columns[iL];
+			col.resize(c.offsets[nEvents]);
+			for (unsigned iEvt=0; iEvt!=nEvents; ++iEvt) {
+				unsigned start = c.offsets[iEvt], n = c.offsets[iEvt+1]-start;
+				if (n==0)
+					continue;
+				b->GetEntry(first+iEvt);
+				if (c.isFloat[iL]) {
+					std::memcpy(col.data()+start,l->GetValuePointer(),n*sizeof(float));
+				} else {
+					for (unsigned i=0; i!=n; ++i)
+						col[start+i] = l->GetValue(i);
+				}
+			}
+		}
+	}
+	return nEvents;
+}
+
+int ColumnReader::ColumnIndex(int iC, TString leaf) const
+{
+	const std::vector<TString> &names = collections[iC].leafNames;
+	for (unsigned iL=0; iL!=names.size(); ++iL) {
+		if (names[iL]==leaf)
+			return iL;
+	}
+	return -1;
+}
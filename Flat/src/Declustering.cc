@@ -0,0 +1,44 @@
+#include "../interface/Declustering.h"
+#include <cmath>
+
+// explicit ghosts are generated with pt ~ 1e-100
+static const double ghostPt = 1e-50;
+
+void JetDeclusterer::Build(const fastjet::PseudoJet &jet)
+{
+	steps.clear();
+	parents.clear();
+
+	fastjet::PseudoJet j = jet, j1, j2;
+	while (j.has_parents(j1,j2)) {
+		if (j1.perp2()<j2.perp2())
+			std::swap(j1,j2);
+		double pt2 = j2.perp();
+		if (pt2>ghostPt) {
+			Step s;
+			s.dR = j1.delta_R(j2);
+			s.z = pt2/(j1.perp()+pt2);
+			s.kt = pt2*s.dR;
+			steps.push_back(s);
+			parents.push_back(j);
+		}
+		j = j1;
+	}
+	last = j;
+}
+
+unsigned JetDeclusterer::SoftDropStep(double beta, double zcut) const
+{
+	unsigned nS = steps.size();
+	for (unsigned iS=0; iS!=nS; ++iS) {
+		const Step &s = steps[iS];
+		if (s.z > zcut*std::pow(s.dR/R0,beta))
+			return iS;
+	}
+	return nS;
+}
+
+const fastjet::PseudoJet &JetDeclusterer::SoftDrop(double beta, double zcut) const
+{
+	return GetParent(SoftDropStep(beta,zcut));
+}
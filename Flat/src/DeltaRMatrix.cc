@@ -0,0 +1,41 @@
+#include "../interface/DeltaRMatrix.h"
+#include <cmath>
+#include <limits>
+
+void EtaPhiArrays::Add(double pt, double eta_, double phi_)
+{
+	// an infinite eta keeps the index but can never be within any dR
+	eta.push_back((pt>0) ? eta_ : std::numeric_limits<float>::infinity());
+	phi.push_back(TVector2::Phi_mpi_pi(phi_));
+}
+
+void DeltaRMatrix::Compute(const EtaPhiArrays &a, const EtaPhiArrays &b)
+{
+	nA = a.size(); nB = b.size();
+	dr2.resize(nA*nB);
+
+	const float twoPi = 2*TMath::Pi();
+	const float *etaB = b.eta.data(), *phiB = b.phi.data();
+	for (unsigned iA=0; iA!=nA; ++iA) {
+		float etaA = a.eta[iA], phiA = a.phi[iA];
+		float *row = dr2.data()+iA*nB;
+		for (unsigned iB=0; iB<nB; ++iB) {
+			float dEta = etaA-etaB[iB];
+			float dPhi = std::fabs(phiA-phiB[iB]);
+			dPhi = std::min(dPhi,twoPi-dPhi);
+			row[iB] = dEta*dEta + dPhi*dPhi;
+		}
+	}
+}
+
+void DeltaRMatrix::MatchMask(float r2, BitMask &mask) const
+{
+	for (unsigned iA=0; iA!=nA; ++iA) {
+		const float *row = dr2.data()+iA*nB;
+		bool matched = false;
+		for (unsigned iB=0; iB<nB; ++iB)
+			matched |= (row[iB]<r2);
+		if (matched)
+			mask.Set(iA);
+	}
+}
@@ -0,0 +1,165 @@
+#include "../interface/EnergyCorrelations.h"
+#include <algorithm>
+#include <cmath>
+
+ECFCalculator::ECFCalculator(std::vector<double> betas_, int maxN_, int maxOrder_) :
+	betas(betas_),
+	nBeta(betas_.size()),
+	maxN(maxN_),
+	maxOrder(maxOrder_)
+{
+	if (maxN<1 || maxN>4) {
+		PError("ECFCalculator::ECFCalculator",TString::Format("N=%i is not supported, using N<=4",maxN));
+		maxN = 4;
+	}
+	if (maxOrder<1 || maxOrder>3) {
+		PError("ECFCalculator::ECFCalculator",TString::Format("order=%i is not supported, using order<=3",maxOrder));
+		maxOrder = 3;
+	}
+	results.resize(maxOrder*maxN*nBeta,0);
+}
+
+void ECFCalculator::Compute(const VPseudoJet &particles)
+{
+	std::fill(results.begin(),results.end(),0);
+
+	// pick the constituents, normalizing to the pt of all of them
+	double ptSum = 0;
+	order.clear();
+	unsigned nAll = particles.size();
+	for (unsigned iP=0; iP!=nAll; ++iP) {
+		if (particles[iP].perp2()<=0)
+			continue;
+		order.push_back(iP);
+		ptSum += particles[iP].perp();
+	}
+	n = order.size();
+	if (n==0)
+		return;
+	if (topK>0 && n>topK) {
+		std::nth_element(order.begin(),order.begin()+topK,order.end(),
+		                 [&particles](unsigned a, unsigned b)->bool {
+		                   return particles[a].perp2() > particles[b].perp2();
+		                 });
+		n = topK;
+	}
+
+	z.resize(n); eta.resize(n); phi.resize(n);
+	for (unsigned i=0; i!=n; ++i) {
+		const fastjet::PseudoJet &p = particles[order[i]];
+		z[i] = p.perp()/ptSum;
+		eta[i] = p.eta();
+		phi[i] = p.phi_std();
+	}
+
+	// the angular part is computed once and only exponentiated per beta
+	unsigned n2 = n*n;
+	logDR.resize(n2);
+	for (unsigned i=0; i!=n; ++i) {
+		logDR[i*n+i] = -HUGE_VAL;
+		for (unsigned j=i+1; j!=n; ++j) {
+			double l = 0.5*std::log(DeltaR2(eta[i],phi[i],eta[j],phi[j]));
+			logDR[i*n+j] = l;
+			logDR[j*n+i] = l;
+		}
+	}
+	angles.resize(nBeta*n2);
+	for (unsigned iB=0; iB!=nBeta; ++iB) {
+		double beta = betas[iB];
+		double *A = angles.data()+iB*n2;
+		for (unsigned ij=0; ij!=n2; ++ij)
+			A[ij] = std::exp(beta*logDR[ij]);
+	}
+
+	double zSum = 0;
+	for (unsigned i=0; i!=n; ++i)
+		zSum += z[i];
+
+	for (unsigned iB=0; iB!=nBeta; ++iB) {
+		const double *A = angles.data()+iB*n2;
+		for (int o=1; o<=maxOrder; ++o)
+			results[Index(o,1,iB)] = zSum;
+		if (maxN<2)
+			continue;
+
+		// N=2 has a single angle, so every order is the same
+		double s = 0;
+		for (unsigned i=0; i!=n; ++i) {
+			const double *Ai = A+i*n;
+			double t = 0;
+			for (unsigned j=i+1; j<n; ++j)
+				t += z[j]*Ai[j];
+			s += z[i]*t;
+		}
+		for (int o=1; o<=maxOrder; ++o)
+			results[Index(o,2,iB)] = s;
+
+		if (maxN>=3)
+			SumN3(A,iB);
+		if (maxN>=4)
+			SumN4(A,iB);
+	}
+}
+
+void ECFCalculator::SumN3(const double *A, unsigned ibeta)
+{
+	double s[3] = {0,0,0};
+	for (unsigned i=0; i!=n; ++i) {
+		const double *Ai = A+i*n;
+		for (unsigned j=i+1; j<n; ++j) {
+			const double *Aj = A+j*n;
+			double a = Ai[j];
+			double t1=0, t2=0, t3=0;
+			for (unsigned k=j+1; k<n; ++k) {
+				double b = Ai[k], c = Aj[k];
+				double lo = std::min(a,std::min(b,c));
+				double mid = std::max(std::min(a,b),std::min(std::max(a,b),c));
+				t1 += z[k]*lo;
+				t2 += z[k]*lo*mid;
+				t3 += z[k]*a*b*c;
+			}
+			double zij = z[i]*z[j];
+			s[0] += zij*t1; s[1] += zij*t2; s[2] += zij*t3;
+		}
+	}
+	for (int o=1; o<=maxOrder; ++o)
+		results[Index(o,3,ibeta)] = s[o-1];
+}
+
+void ECFCalculator::SumN4(const double *A, unsigned ibeta)
+{
+	double s[3] = {0,0,0};
+	for (unsigned i=0; i!=n; ++i) {
+		const double *Ai = A+i*n;
+		for (unsigned j=i+1; j<n; ++j) {
+			const double *Aj = A+j*n;
+			for (unsigned k=j+1; k<n; ++k) {
+				const double *Ak = A+k*n;
+				// the three angles within (i,j,k), sorted
+				double a = Ai[j], b = Ai[k], c = Aj[k];
+				double s1 = std::min(a,std::min(b,c));
+				double s2 = std::max(std::min(a,b),std::min(std::max(a,b),c));
+				double s3 = std::max(a,std::max(b,c));
+				double t1=0, t2=0, t3=0;
+				for (unsigned l=k+1; l<n; ++l) {
+					// the three angles to l, sorted
+					double d = Ai[l], e = Aj[l], f = Ak[l];
+					double u1 = std::min(d,std::min(e,f));
+					double u2 = std::max(std::min(d,e),std::min(std::max(d,e),f));
+					double u3 = std::max(d,std::max(e,f));
+					// three smallest of the merged lists
+					double m1 = std::min(s1,u1);
+					double m2 = std::min(std::max(s1,u1),std::min(s2,u2));
+					double m3 = std::min(std::min(s3,u3),std::min(std::max(s1,u2),std::max(s2,u1)));
+					t1 += z[l]*m1;
+					t2 += z[l]*m1*m2;
+					t3 += z[l]*m1*m2*m3;
+				}
+				double zijk = z[i]*z[j]*z[k];
+				s[0] += zijk*t1; s[1] += zijk*t2; s[2] += zijk*t3;
+			}
+		}
+	}
+	for (int o=1; o<=maxOrder; ++o)
+		results[Index(o,4,ibeta)] = s[o-1];
+}
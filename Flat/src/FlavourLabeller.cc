@@ -0,0 +1,102 @@
+#include "../interface/FlavourLabeller.h"
+#include <cmath>
+
+int FlavourLabeller::HadronFlavour(int pdgid)
+{
+	int a = std::abs(pdgid);
+	if (a<100 || a>=1000000 || (a/10)%10==0) // not a hadron, or a diquark
+		return 0;
+	int q1 = (a/1000)%10, q2 = (a/100)%10;
+	if (q1==5 || q2==5)
+		return 5;
+	if (q1==4 || q2==4)
+		return 4;
+	return 0;
+}
+
+int FlavourLabeller::PartonFlavour(int pdgid)
+{
+	int a = std::abs(pdgid);
+	if (a==4 || a==5)
+		return a;
+	if ((a>=1 && a<=3) || a==21)
+		return 0;
+	return -1;
+}
+
+void FlavourLabeller::AddJet(double pt, double eta, double phi)
+{
+	inputs.push_back(fastjet::PtYPhiM(pt,eta,phi,0));
+	inputs.back().set_user_index(nJets);
+	++nJets;
+}
+
+void FlavourLabeller::Label(double R, fastjet::JetAlgorithm algo)
+{
+	unsigned nJ = nJets, nG = ghosts.size();
+	labels.assign(nJ,JetLabel{0,0,0,0,0,0});
+	if (nJ==0 || nG==0)
+		return;
+
+	unsigned nParts = inputs.size();
+	for (unsigned iG=0; iG!=nG; ++iG) {
+		const Ghost &g = ghosts[iG];
+		inputs.push_back(fastjet::PtYPhiM(g.pt*ghostScale,g.eta,g.phi,0));
+		inputs.back().set_user_index(-1-(int)iG);
+	}
+
+	ptSums.assign(nJ,0);
+	fastjet::ClusterSequence seq(inputs,fastjet::JetDefinition(algo,R));
+	inputs.resize(nParts);
+	VPseudoJet clusters = seq.inclusive_jets(0);
+	for (auto &cluster : clusters) {
+		VPseudoJet constituents = cluster.constituents();
+		// the constituents of a jet normally come back as one cluster; if
+		// several jets share a cluster, its ghosts go to the one with most pt
+		members.clear();
+		for (auto &c : constituents) {
+			int iJ = c.user_index();
+			if (iJ<0)
+				continue;
+			if (ptSums[iJ]==0)
+				members.push_back(iJ);
+			ptSums[iJ] += c.perp();
+		}
+		if (members.size()==0)
+			continue;
+		unsigned owner = members[0];
+		for (auto iJ : members) {
+			if (ptSums[iJ]>ptSums[owner])
+				owner = iJ;
+		}
+		for (auto iJ : members)
+			ptSums[iJ] = 0;
+
+		JetLabel &l = labels[owner];
+		for (auto &c : constituents) {
+			if (c.user_index()>=0)
+				continue;
+			const Ghost &g = ghosts[-1-c.user_index()];
+			if (g.hadron) {
+				l.hadronFlavour = std::max(l.hadronFlavour,g.flavour);
+			} else {
+				if (g.flavour>l.partonFlavour || (g.flavour==l.partonFlavour && g.pt>l.partonPt)) {
+					l.partonFlavour = g.flavour; l.partonPt = g.pt;
+				}
+				l.leadingPartonPt = std::max(l.leadingPartonPt,(float)g.pt);
+			}
+		}
+	}
+
+	// genPt is always a parton pt, also when a hadron sets the flavour
+	for (auto &l : labels) {
+		if (hasHadrons)
+			l.flavour = l.hadronFlavour;
+		else
+			l.flavour = l.partonFlavour;
+		if (l.flavour>0 && l.partonFlavour==l.flavour)
+			l.genPt = l.partonPt;
+		else
+			l.genPt = l.leadingPartonPt;
+	}
+}
@@ -35,6 +35,8 @@ void GenAnalyzer::SetOutputPath(TString fOutName, TString fOutFileName) {
 
   kt->Reset();
   kt->WriteTree(tOut);
+  if (ntupleOutput)
+    ntupleOutput = kt->StartNTupleOutput(fOut);
 
 }
 
@@ -49,7 +51,9 @@ void GenAnalyzer::AddInput(TTree *t, double xsec, TString label)
 }
 
 void GenAnalyzer::Terminate() {
-  fOut->WriteTObject(tOut);
+  kt->FinishWriting();
+  if (!kt->HasNTuple())
+    fOut->WriteTObject(tOut);
   fOut->Close();
 }
 
@@ -177,7 +181,7 @@ void GenAnalyzer::RunLO() {
       kt->jjdphi = vj1.DeltaPhi(vj2);
       kt->mjj    = (vj1+vj2).M();
 
-      tOut->Fill();
+      kt->FillTree();
     }
   }
 }
@@ -357,7 +361,7 @@ void GenAnalyzer::RunNLO() {
       kt->jjdphi = vj1.DeltaPhi(vj2);
       kt->mjj    = (vj1+vj2).M();
 
-      tOut->Fill();
+      kt->FillTree();
     }
   }
 }
@@ -1,14 +1,39 @@
 #include "../interface/GeneralTree.h"
+#include "PandaCore/Tools/interface/Common.h"
+#include <algorithm>
 
 #define NJET 20
 #define NSUBJET 2
+#define NFATJET 4
+#define NGROOM 8
+#define NLUND 32
+#define NCONST 100
 
 GeneralTree::GeneralTree() {
 //STARTCUSTOMCONST
-  for (unsigned iS=0; iS!=6; ++iS) {
-    scale[iS] = 1;
+  SetECFBetas(betas);
+//ENDCUSTOMCONST
+    SetPrecision("ECFN_",10);
+    SetPrecision("^fj1PtS",12);
+    SetPrecision("^fj1MSDS",12);
+}
+
+GeneralTree::~GeneralTree() {
+//STARTCUSTOMDEST
+//ENDCUSTOMDEST
+}
+
+void GeneralTree::SetECFBetas(std::vector<double> betas_) {
+  if (betas_.size()>NECFBETA) {
+    PError("GeneralTree::SetECFBetas",TString::Format("Only %i betas are supported, dropping the rest",NECFBETA));
+    betas_.resize(NECFBETA);
   }
-  
+  betas = betas_;
+  ibetas.clear();
+  for (unsigned iB=0; iB!=betas.size(); ++iB)
+    ibetas.push_back(iB);
+
+  ecfParams.clear();
   for (auto ibeta : ibetas) {
     for (auto N : Ns) {
       for (auto order : orders) {
@@ -17,334 +42,84 @@ GeneralTree::GeneralTree() {
         p.N = N;
         p.order = order;
         ecfParams.push_back(p);
-        fj1ECFNs[p] = -1;
       }
     }
   }
-
-  for (unsigned iShift=0; iShift!=bNShift; ++iShift) {
-    for (unsigned iJet=0; iJet!=bNJet; ++iJet) {
-      for (unsigned iTags=0; iTags!=bNTags; ++iTags) {
-        BTagParams p;
-        p.jet = (BTagJet)iJet;
-        p.tag = (BTagTags)iTags;
-        p.shift = (BTagShift)iShift;
-        btagParams.push_back(p);
-        sf_btags[p] = 1;
-      }
-    }
-  }
-
-  for (unsigned int iSJ=0; iSJ!=NSUBJET; ++iSJ) {
-    fj1sjPt[iSJ] = -1;
-    fj1sjEta[iSJ] = -1;
-    fj1sjPhi[iSJ] = -1;
-    fj1sjM[iSJ] = -1;
-    fj1sjCSV[iSJ] = -1;
-    fj1sjQGL[iSJ] = -1;
-  }
-  for (unsigned int iJ=0; iJ!=NJET; ++iJ) {
-    jetPt[iJ] = -1;
-    jetEta[iJ] = -1;
-    jetPhi[iJ] = -1;
-    jetE[iJ] = -1;
-    jetCSV[iJ] = -1;
-    jetIso[iJ] = -1;
-    jetQGL[iJ] = -1;
-  }
-
-//ENDCUSTOMCONST
 }
 
-GeneralTree::~GeneralTree() {
-//STARTCUSTOMDEST
-//ENDCUSTOMDEST
+std::vector<TString> GeneralTree::betaValues() const {
+  std::vector<TString> values;
+  for (auto beta : betas)
+    values.push_back(TString::Format("%.2i",int(10*beta)));
+  return values;
 }
 
 void GeneralTree::Reset() {
 //STARTCUSTOMRESET
-  for (unsigned iS=0; iS!=6; ++iS) {
-    scale[iS] = 1;
-  }
-
-  for (auto p : ecfParams) { 
-    fj1ECFNs[p] = -1;
-  }
-
-  for (auto p : btagParams) { 
-    sf_btags[p] = 1;
-  }
-
-  for (unsigned int iSJ=0; iSJ!=NSUBJET; ++iSJ) {
-    fj1sjPt[iSJ] = -99;
-    fj1sjEta[iSJ] = -99;
-    fj1sjPhi[iSJ] = -99;
-    fj1sjM[iSJ] = -99;
-    fj1sjCSV[iSJ] = -99;
-    fj1sjQGL[iSJ] = -99;
-  }
-  for (unsigned int iJ=0; iJ!=NJET; ++iJ) {
-    jetPt[iJ] = -99;
-    jetEta[iJ] = -99;
-    jetPhi[iJ] = -99;
-    jetE[iJ] = -99;
-    jetCSV[iJ] = -99;
-    jetIso[iJ] = -99;
-    jetQGL[iJ] = -99;
-  }
-
-  for (auto iter=signal_weights.begin(); iter!=signal_weights.end(); ++iter) {
-    signal_weights[iter->first] = 1; // does pair::second return a reference?
-  }
-
 //ENDCUSTOMRESET
-    jot1VBFID = 0;
-    sf_metTrigZmm = 1;
-    sf_qcdV_VBF = 1;
-    jetNMBtags = 0;
-    pfmetRaw = -1;
-    nB = 0;
-    fj1MSDScaleUp_sj = -1;
-    fj1MSDScaleDown_sj = -1;
-    fj1MSDSmeared_sj = -1;
-    fj1MSDSmearedUp_sj = -1;
-    fj1MSDSmearedDown_sj = -1;
-    fj1PtScaleUp_sj = -1;
-    fj1PtScaleDown_sj = -1;
-    fj1PtSmeared_sj = -1;
-    fj1PtSmearedUp_sj = -1;
-    fj1PtSmearedDown_sj = -1;
-    jot2EtaUp = -1;
-    jot2EtaDown = -1;
-    jot1EtaUp = -1;
-    jot1EtaDown = -1;
-    jot1PtUp = -1;
-    jot1PtDown = -1;
-    jot2PtUp = -1;
-    jot2PtDown = -1;
-    jot12MassUp = -1;
-    jot12DEtaUp = -1;
-    jot12DPhiUp = -1;
-    jot12MassDown = -1;
-    jot12DEtaDown = -1;
-    jot12DPhiDown = -1;
-    pfmetUp = -1;
-    pfmetDown = -1;
-    pfUWmagUp = -1;
-    pfUZmagUp = -1;
-    pfUAmagUp = -1;
-    pfUmagUp = -1;
-    pfUWmagDown = -1;
-    pfUZmagDown = -1;
-    pfUAmagDown = -1;
-    pfUmagDown = -1;
-    nJot = 0;
-    jot1Phi = -1;
-    jot1Pt = -1;
-    jot1GenPt = -1;
-    jot1Eta = -1;
-    jot2Phi = -1;
-    jot2Pt = -1;
-    jot2GenPt = -1;
-    jot2Eta = -1;
-    jot12DPhi = -1;
-    isGS = 0;
-    fj1SubMaxCSV = -1;
-    looseLep1IsHLTSafe = 0;
-    looseLep2IsHLTSafe = 0;
-    runNumber = 0;
-    lumiNumber = 0;
-    eventNumber = 0;
-    npv = 0;
-    pu = 0;
-    mcWeight = -1;
-    trigger = 0;
-    metFilter = 0;
-    egmFilter = 0;
-    filter_maxRecoil = -1;
-    filter_whichRecoil = -1;
-    sf_ewkV = 1;
-    sf_qcdV = 1;
-    sf_ewkV2j = 1;
-    sf_qcdV2j = 1;
-    sf_qcdTT = 1;
-    sf_lepID = 1;
-    sf_lepIso = 1;
-    sf_lepTrack = 1;
-    sf_pho = 1;
-    sf_eleTrig = 1;
-    sf_phoTrig = 1;
-    sf_metTrig = 1;
-    sf_pu = 1;
-    sf_npv = 1;
-    sf_tt = 1;
-    sf_tt_ext = 1;
-    sf_tt_bound = 1;
-    sf_tt8TeV = 1;
-    sf_tt8TeV_ext = 1;
-    sf_tt8TeV_bound = 1;
-    sf_phoPurity = 1;
-    pfmet = -1;
-    pfmetphi = -1;
-    pfmetnomu = -1;
-    puppimet = -1;
-    puppimetphi = -1;
-    calomet = -1;
-    calometphi = -1;
-    pfcalobalance = -1;
-    sumET = -1;
-    trkmet = -1;
-    puppiUWmag = -1;
-    puppiUWphi = -1;
-    puppiUZmag = -1;
-    puppiUZphi = -1;
-    puppiUAmag = -1;
-    puppiUAphi = -1;
-    puppiUperp = -1;
-    puppiUpara = -1;
-    puppiUmag = -1;
-    puppiUphi = -1;
-    pfUWmag = -1;
-    pfUWphi = -1;
-    pfUZmag = -1;
-    pfUZphi = -1;
-    pfUAmag = -1;
-    pfUAphi = -1;
-    pfUperp = -1;
-    pfUpara = -1;
-    pfUmag = -1;
-    pfUphi = -1;
-    dphipfmet = -1;
-    dphipuppimet = -1;
-    dphipuppiUW = -1;
-    dphipuppiUZ = -1;
-    dphipuppiUA = -1;
-    dphipfUW = -1;
-    dphipfUZ = -1;
-    dphipfUA = -1;
-    dphipuppiU = -1;
-    dphipfU = -1;
-    trueGenBosonPt = -1;
-    genBosonPt = -1;
-    genBosonEta = -1;
-    genBosonMass = -1;
-    genBosonPhi = -1;
-    genWPlusPt = -1;
-    genWMinusPt = -1;
-    genWPlusEta = -1;
-    genWMinusEta = -1;
-    genTopPt = -1;
-    genTopIsHad = 0;
-    genTopEta = -1;
-    genAntiTopPt = -1;
-    genAntiTopIsHad = 0;
-    genAntiTopEta = -1;
-    genTTPt = -1;
-    genTTEta = -1;
-    nJet = 0;
-    nIsoJet = 0;
-    jet1Flav = 0;
-    jet1Phi = -1;
-    jet1Pt = -1;
-    jet1GenPt = -1;
-    jet1Eta = -1;
-    jet1CSV = -1;
-    jet1IsTight = 0;
-    jet2Flav = 0;
-    jet2Phi = -1;
-    jet2Pt = -1;
-    jet2GenPt = -1;
-    jet2Eta = -1;
-    jet2CSV = -1;
-    isojet1Pt = -1;
-    isojet1CSV = -1;
-    isojet1Flav = 0;
-    isojet2Pt = -1;
-    isojet2CSV = -1;
-    isojet2Flav = 0;
-    jot12Mass = -1;
-    jot12DEta = -1;
-    jetNBtags = 0;
-    isojetNBtags = 0;
-    nFatjet = 0;
-    fj1Tau32 = -1;
-    fj1Tau21 = -1;
-    fj1Tau32SD = -1;
-    fj1Tau21SD = -1;
-    fj1MSD = -1;
-    fj1MSDScaleUp = -1;
-    fj1MSDScaleDown = -1;
-    fj1MSDSmeared = -1;
-    fj1MSDSmearedUp = -1;
-    fj1MSDSmearedDown = -1;
-    fj1MSD_corr = -1;
-    fj1Pt = -1;
-    fj1PtScaleUp = -1;
-    fj1PtScaleDown = -1;
-    fj1PtSmeared = -1;
-    fj1PtSmearedUp = -1;
-    fj1PtSmearedDown = -1;
-    fj1Phi = -1;
-    fj1Eta = -1;
-    fj1M = -1;
-    fj1MaxCSV = -1;
-    fj1MinCSV = -1;
-    fj1DoubleCSV = -1;
-    fj1Nbs = 0;
-    fj1gbb = 0;
-    fj1GenPt = -1;
-    fj1GenSize = -1;
-    fj1IsMatched = 0;
-    fj1GenWPt = -1;
-    fj1GenWSize = -1;
-    fj1IsWMatched = 0;
-    fj1HighestPtGen = 0;
-    fj1HighestPtGenPt = -1;
-    fj1IsTight = 0;
-    fj1IsLoose = 0;
-    fj1RawPt = -1;
-    fj1NHF = 0;
-    fj1HTTMass = -1;
-    fj1HTTFRec = -1;
-    fj1IsClean = 0;
-    fj1NConst = 0;
-    fj1NSDConst = 0;
-    fj1EFrac100 = -1;
-    fj1SDEFrac100 = -1;
-    nHF = 0;
-    nLoosePhoton = 0;
-    nTightPhoton = 0;
-    loosePho1IsTight = 0;
-    loosePho1Pt = -1;
-    loosePho1Eta = -1;
-    loosePho1Phi = -1;
-    nLooseLep = 0;
-    nLooseElectron = 0;
-    nLooseMuon = 0;
-    nTightLep = 0;
-    nTightElectron = 0;
-    nTightMuon = 0;
-    looseLep1PdgId = 0;
-    looseLep2PdgId = 0;
-    looseLep1IsTight = 0;
-    looseLep2IsTight = 0;
-    looseLep1Pt = -1;
-    looseLep1Eta = -1;
-    looseLep1Phi = -1;
-    looseLep2Pt = -1;
-    looseLep2Eta = -1;
-    looseLep2Phi = -1;
-    diLepMass = -1;
-    nTau = 0;
-    mT = -1;
-    hbbpt = -1;
-    hbbeta = -1;
-    hbbphi = -1;
-    hbbm = -1;
-    scaleUp = -1;
-    scaleDown = -1;
-    pdfUp = -1;
-    pdfDown = -1;
+    static const GeneralTreeBlock defaults{};
+    static_cast<GeneralTreeBlock&>(*this) = defaults;
+    if (fixedArrays) {
+      std::fill(&fjECFNs[0][0],&fjECFNs[0][0]+96*NFATJET,-1);
+      std::fill(fj1GroomM,fj1GroomM+NGROOM,-99);
+      std::fill(fj1GroomPt,fj1GroomPt+NGROOM,-99);
+      std::fill(fj1GroomZg,fj1GroomZg+NGROOM,-99);
+      std::fill(fj1GroomRg,fj1GroomRg+NGROOM,-99);
+      std::fill(fj1LundLnInvDR,fj1LundLnInvDR+NLUND,-99);
+      std::fill(fj1LundLnKt,fj1LundLnKt+NLUND,-99);
+      std::fill(fj1LundZ,fj1LundZ+NLUND,-99);
+      std::fill(fjPt,fjPt+NFATJET,-1);
+      std::fill(fjEta,fjEta+NFATJET,-1);
+      std::fill(fjPhi,fjPhi+NFATJET,-1);
+      std::fill(fjM,fjM+NFATJET,-1);
+      std::fill(fjMSD,fjMSD+NFATJET,-1);
+      std::fill(fjMSD_corr,fjMSD_corr+NFATJET,-1);
+      std::fill(fjRawPt,fjRawPt+NFATJET,-1);
+      std::fill(fjPtScaleUp,fjPtScaleUp+NFATJET,-1);
+      std::fill(fjPtScaleDown,fjPtScaleDown+NFATJET,-1);
+      std::fill(fjPtSmeared,fjPtSmeared+NFATJET,-1);
+      std::fill(fjPtSmearedUp,fjPtSmearedUp+NFATJET,-1);
+      std::fill(fjPtSmearedDown,fjPtSmearedDown+NFATJET,-1);
+      std::fill(fjMSDScaleUp,fjMSDScaleUp+NFATJET,-1);
+      std::fill(fjMSDScaleDown,fjMSDScaleDown+NFATJET,-1);
+      std::fill(fjMSDSmeared,fjMSDSmeared+NFATJET,-1);
+      std::fill(fjMSDSmearedUp,fjMSDSmearedUp+NFATJET,-1);
+      std::fill(fjMSDSmearedDown,fjMSDSmearedDown+NFATJET,-1);
+      std::fill(fjPtScaleUp_sj,fjPtScaleUp_sj+NFATJET,-1);
+      std::fill(fjPtScaleDown_sj,fjPtScaleDown_sj+NFATJET,-1);
+      std::fill(fjPtSmeared_sj,fjPtSmeared_sj+NFATJET,-1);
+      std::fill(fjMSDScaleUp_sj,fjMSDScaleUp_sj+NFATJET,-1);
+      std::fill(fjMSDScaleDown_sj,fjMSDScaleDown_sj+NFATJET,-1);
+      std::fill(fjMSDSmeared_sj,fjMSDSmeared_sj+NFATJET,-1);
+      std::fill(fjTau32,fjTau32+NFATJET,-1);
+      std::fill(fjTau21,fjTau21+NFATJET,-1);
+      std::fill(fjTau32SD,fjTau32SD+NFATJET,-1);
+      std::fill(fjTau21SD,fjTau21SD+NFATJET,-1);
+      std::fill(fjMaxCSV,fjMaxCSV+NFATJET,-1);
+      std::fill(fjMinCSV,fjMinCSV+NFATJET,-1);
+      std::fill(fjSubMaxCSV,fjSubMaxCSV+NFATJET,-1);
+      std::fill(fjDoubleCSV,fjDoubleCSV+NFATJET,-1);
+      std::fill(fjHTTMass,fjHTTMass+NFATJET,-1);
+      std::fill(fjHTTFRec,fjHTTFRec+NFATJET,-1);
+      std::fill(fjEFrac100,fjEFrac100+NFATJET,-1);
+      std::fill(fjSDEFrac100,fjSDEFrac100+NFATJET,-1);
+      std::fill(fjIsClean,fjIsClean+NFATJET,0);
+      std::fill(fjNConst,fjNConst+NFATJET,0);
+      std::fill(fjNSDConst,fjNSDConst+NFATJET,0);
+      std::fill(jetPt,jetPt+NJET,-99);
+      std::fill(jetEta,jetEta+NJET,-99);
+      std::fill(jetPhi,jetPhi+NJET,-99);
+      std::fill(jetE,jetE+NJET,-99);
+      std::fill(jetCSV,jetCSV+NJET,-99);
+      std::fill(jetIso,jetIso+NJET,-99);
+      std::fill(jetQGL,jetQGL+NJET,-99);
+      std::fill(fj1sjPt,fj1sjPt+NSUBJET,-99);
+      std::fill(fj1sjPhi,fj1sjPhi+NSUBJET,-99);
+      std::fill(fj1sjEta,fj1sjEta+NSUBJET,-99);
+      std::fill(fj1sjM,fj1sjM+NSUBJET,-99);
+      std::fill(fj1sjCSV,fj1sjCSV+NSUBJET,-99);
+      std::fill(fj1sjQGL,fj1sjQGL+NSUBJET,-99);
+    }
 }
 
 void GeneralTree::WriteTree(TTree *t) {
@@ -356,19 +131,6 @@ void GeneralTree::WriteTree(TTree *t) {
 
   Book("nJet",&nJet,"nJet/I");
   if (monohiggs) {
-    Book("jetPt",jetPt,"jetPt[nJet]/F");
-    Book("jetEta",jetEta,"jetEta[nJet]/F");
-    Book("jetPhi",jetPhi,"jetPhi[nJet]/F");
-    Book("jetE",jetE,"jetE[nJet]/F");
-    Book("jetCSV",jetCSV,"jetCSV[nJet]/F");
-    Book("jetIso",jetIso,"jetIso[nJet]/F");
-    Book("jetQGL",jetQGL,"jetQGL[nJet]/F");
-    Book("fj1sjPt",fj1sjPt,"fj1sjPt[2]/F");
-    Book("fj1sjPhi",fj1sjPhi,"fj1sjPhi[2]/F");
-    Book("fj1sjEta",fj1sjEta,"fj1sjEta[2]/F");
-    Book("fj1sjM",fj1sjM,"fj1sjM[2]/F");
-    Book("fj1sjCSV",fj1sjCSV,"fj1sjCSV[2]/F");
-    Book("fj1sjQGL",fj1sjQGL,"fj1sjQGL[2]/F");
     Book("fj1Nbs",&fj1Nbs,"fj1Nbs/I");
     Book("fj1gbb",&fj1gbb,"fj1gbb/I");
     Book("hbbpt",&hbbpt,"hbbpt/F");
@@ -401,6 +163,21 @@ void GeneralTree::WriteTree(TTree *t) {
     Book("pfUZmagDown",&pfUZmagDown,"pfUZmagDown/F");
     Book("pfUAmagDown",&pfUAmagDown,"pfUAmagDown/F");
     Book("pfUmagDown",&pfUmagDown,"pfUmagDown/F");
+    Book("pfmetSmeared",&pfmetSmeared,"pfmetSmeared/F");
+    Book("pfmetSmearedUp",&pfmetSmearedUp,"pfmetSmearedUp/F");
+    Book("pfmetSmearedDown",&pfmetSmearedDown,"pfmetSmearedDown/F");
+    Book("pfUWmagSmeared",&pfUWmagSmeared,"pfUWmagSmeared/F");
+    Book("pfUZmagSmeared",&pfUZmagSmeared,"pfUZmagSmeared/F");
+    Book("pfUAmagSmeared",&pfUAmagSmeared,"pfUAmagSmeared/F");
+    Book("pfUmagSmeared",&pfUmagSmeared,"pfUmagSmeared/F");
+    Book("pfUWmagSmearedUp",&pfUWmagSmearedUp,"pfUWmagSmearedUp/F");
+    Book("pfUZmagSmearedUp",&pfUZmagSmearedUp,"pfUZmagSmearedUp/F");
+    Book("pfUAmagSmearedUp",&pfUAmagSmearedUp,"pfUAmagSmearedUp/F");
+    Book("pfUmagSmearedUp",&pfUmagSmearedUp,"pfUmagSmearedUp/F");
+    Book("pfUWmagSmearedDown",&pfUWmagSmearedDown,"pfUWmagSmearedDown/F");
+    Book("pfUZmagSmearedDown",&pfUZmagSmearedDown,"pfUZmagSmearedDown/F");
+    Book("pfUAmagSmearedDown",&pfUAmagSmearedDown,"pfUAmagSmearedDown/F");
+    Book("pfUmagSmearedDown",&pfUmagSmearedDown,"pfUmagSmearedDown/F");
     Book("jot1EtaUp",&jot1EtaUp,"jot1EtaUp/F");
     Book("jot1EtaDown",&jot1EtaDown,"jot1EtaDown/F");
     Book("jot1PtUp",&jot1PtUp,"jot1PtUp/F");
@@ -417,37 +194,23 @@ void GeneralTree::WriteTree(TTree *t) {
     Book("jot2EtaDown",&jot2EtaDown,"jot2EtaDown/F");
     Book("jot1VBFID",&jot1VBFID,"jot1VBFID/I");
   }
-  Book("scale",scale,"scale[6]/F");
-
-  for (auto p : ecfParams) { 
-    TString ecfn(makeECFString(p));
-    Book("fj1"+ecfn,&(fj1ECFNs[p]),"fj1"+ecfn+"/F");
-  }
-
-  for (auto p : btagParams) {
-    TString btagn(makeBTagSFString(p));
-    Book(btagn,&(sf_btags[p]),btagn+"/F");
+  if (fatjet && constituents) {
+    TString ft = "/F";
+    if (halfConstituents) {
+      if (HasFloat16())
+        ft = "/f";
+      else
+        PWarning("GeneralTree::WriteTree","Float16_t leaves need ROOT 6.20 or later, booking the fj1Const arrays as Float_t");
+    }
+    Book("nfj1Const",&nfj1Const,"nfj1Const/I");
+    Book("fj1ConstPtFrac",fj1ConstPtFrac,TString::Format("fj1ConstPtFrac[%i]",NCONST)+ft);
+    Book("fj1ConstDEta",fj1ConstDEta,TString::Format("fj1ConstDEta[%i]",NCONST)+ft);
+    Book("fj1ConstDPhi",fj1ConstDPhi,TString::Format("fj1ConstDPhi[%i]",NCONST)+ft);
+    Book("fj1ConstPuppiW",fj1ConstPuppiW,TString::Format("fj1ConstPuppiW[%i]",NCONST)+ft);
+    Book("fj1ConstCharge",fj1ConstCharge,TString::Format("fj1ConstCharge[%i]/I",NCONST));
+    Book("fj1ConstPdgId",fj1ConstPdgId,TString::Format("fj1ConstPdgId[%i]/I",NCONST));
   }
 //ENDCUSTOMWRITE
-    Book("sf_metTrigZmm",&sf_metTrigZmm,"sf_metTrigZmm/F");
-    Book("sf_qcdV_VBF",&sf_qcdV_VBF,"sf_qcdV_VBF/F");
-    Book("jetNMBtags",&jetNMBtags,"jetNMBtags/I");
-    Book("pfmetRaw",&pfmetRaw,"pfmetRaw/F");
-    Book("nB",&nB,"nB/I");
-    Book("fj1MSDScaleUp_sj",&fj1MSDScaleUp_sj,"fj1MSDScaleUp_sj/F");
-    Book("fj1MSDScaleDown_sj",&fj1MSDScaleDown_sj,"fj1MSDScaleDown_sj/F");
-    Book("fj1MSDSmeared_sj",&fj1MSDSmeared_sj,"fj1MSDSmeared_sj/F");
-    Book("fj1MSDSmearedUp_sj",&fj1MSDSmearedUp_sj,"fj1MSDSmearedUp_sj/F");
-    Book("fj1MSDSmearedDown_sj",&fj1MSDSmearedDown_sj,"fj1MSDSmearedDown_sj/F");
-    Book("fj1PtScaleUp_sj",&fj1PtScaleUp_sj,"fj1PtScaleUp_sj/F");
-    Book("fj1PtScaleDown_sj",&fj1PtScaleDown_sj,"fj1PtScaleDown_sj/F");
-    Book("fj1PtSmeared_sj",&fj1PtSmeared_sj,"fj1PtSmeared_sj/F");
-    Book("fj1PtSmearedUp_sj",&fj1PtSmearedUp_sj,"fj1PtSmearedUp_sj/F");
-    Book("fj1PtSmearedDown_sj",&fj1PtSmearedDown_sj,"fj1PtSmearedDown_sj/F");
-    Book("isGS",&isGS,"isGS/I");
-    Book("fj1SubMaxCSV",&fj1SubMaxCSV,"fj1SubMaxCSV/F");
-    Book("looseLep1IsHLTSafe",&looseLep1IsHLTSafe,"looseLep1IsHLTSafe/I");
-    Book("looseLep2IsHLTSafe",&looseLep2IsHLTSafe,"looseLep2IsHLTSafe/I");
     Book("runNumber",&runNumber,"runNumber/I");
     Book("lumiNumber",&lumiNumber,"lumiNumber/I");
     Book("eventNumber",&eventNumber,"eventNumber/l");
@@ -463,14 +226,56 @@ void GeneralTree::WriteTree(TTree *t) {
     Book("sf_qcdV",&sf_qcdV,"sf_qcdV/F");
     Book("sf_ewkV2j",&sf_ewkV2j,"sf_ewkV2j/F");
     Book("sf_qcdV2j",&sf_qcdV2j,"sf_qcdV2j/F");
+    Book("sf_qcdV_VBF",&sf_qcdV_VBF,"sf_qcdV_VBF/F");
     Book("sf_qcdTT",&sf_qcdTT,"sf_qcdTT/F");
     Book("sf_lepID",&sf_lepID,"sf_lepID/F");
     Book("sf_lepIso",&sf_lepIso,"sf_lepIso/F");
     Book("sf_lepTrack",&sf_lepTrack,"sf_lepTrack/F");
     Book("sf_pho",&sf_pho,"sf_pho/F");
+    Book("sf_btag0",&sf_btags[0],"sf_btag0/F");
+    Book("sf_btag0BUp",&sf_btags[1],"sf_btag0BUp/F");
+    Book("sf_btag0BDown",&sf_btags[2],"sf_btag0BDown/F");
+    Book("sf_btag0MUp",&sf_btags[3],"sf_btag0MUp/F");
+    Book("sf_btag0MDown",&sf_btags[4],"sf_btag0MDown/F");
+    Book("sf_btag1",&sf_btags[5],"sf_btag1/F");
+    Book("sf_btag1BUp",&sf_btags[6],"sf_btag1BUp/F");
+    Book("sf_btag1BDown",&sf_btags[7],"sf_btag1BDown/F");
+    Book("sf_btag1MUp",&sf_btags[8],"sf_btag1MUp/F");
+    Book("sf_btag1MDown",&sf_btags[9],"sf_btag1MDown/F");
+    Book("sf_btag2",&sf_btags[10],"sf_btag2/F");
+    Book("sf_btag2BUp",&sf_btags[11],"sf_btag2BUp/F");
+    Book("sf_btag2BDown",&sf_btags[12],"sf_btag2BDown/F");
+    Book("sf_btag2MUp",&sf_btags[13],"sf_btag2MUp/F");
+    Book("sf_btag2MDown",&sf_btags[14],"sf_btag2MDown/F");
+    Book("sf_btagGT0",&sf_btags[15],"sf_btagGT0/F");
+    Book("sf_btagGT0BUp",&sf_btags[16],"sf_btagGT0BUp/F");
+    Book("sf_btagGT0BDown",&sf_btags[17],"sf_btagGT0BDown/F");
+    Book("sf_btagGT0MUp",&sf_btags[18],"sf_btagGT0MUp/F");
+    Book("sf_btagGT0MDown",&sf_btags[19],"sf_btagGT0MDown/F");
+    Book("sf_sjbtag0",&sf_btags[20],"sf_sjbtag0/F");
+    Book("sf_sjbtag0BUp",&sf_btags[21],"sf_sjbtag0BUp/F");
+    Book("sf_sjbtag0BDown",&sf_btags[22],"sf_sjbtag0BDown/F");
+    Book("sf_sjbtag0MUp",&sf_btags[23],"sf_sjbtag0MUp/F");
+    Book("sf_sjbtag0MDown",&sf_btags[24],"sf_sjbtag0MDown/F");
+    Book("sf_sjbtag1",&sf_btags[25],"sf_sjbtag1/F");
+    Book("sf_sjbtag1BUp",&sf_btags[26],"sf_sjbtag1BUp/F");
+    Book("sf_sjbtag1BDown",&sf_btags[27],"sf_sjbtag1BDown/F");
+    Book("sf_sjbtag1MUp",&sf_btags[28],"sf_sjbtag1MUp/F");
+    Book("sf_sjbtag1MDown",&sf_btags[29],"sf_sjbtag1MDown/F");
+    Book("sf_sjbtag2",&sf_btags[30],"sf_sjbtag2/F");
+    Book("sf_sjbtag2BUp",&sf_btags[31],"sf_sjbtag2BUp/F");
+    Book("sf_sjbtag2BDown",&sf_btags[32],"sf_sjbtag2BDown/F");
+    Book("sf_sjbtag2MUp",&sf_btags[33],"sf_sjbtag2MUp/F");
+    Book("sf_sjbtag2MDown",&sf_btags[34],"sf_sjbtag2MDown/F");
+    Book("sf_sjbtagGT0",&sf_btags[35],"sf_sjbtagGT0/F");
+    Book("sf_sjbtagGT0BUp",&sf_btags[36],"sf_sjbtagGT0BUp/F");
+    Book("sf_sjbtagGT0BDown",&sf_btags[37],"sf_sjbtagGT0BDown/F");
+    Book("sf_sjbtagGT0MUp",&sf_btags[38],"sf_sjbtagGT0MUp/F");
+    Book("sf_sjbtagGT0MDown",&sf_btags[39],"sf_sjbtagGT0MDown/F");
     Book("sf_eleTrig",&sf_eleTrig,"sf_eleTrig/F");
     Book("sf_phoTrig",&sf_phoTrig,"sf_phoTrig/F");
     Book("sf_metTrig",&sf_metTrig,"sf_metTrig/F");
+    Book("sf_metTrigZmm",&sf_metTrigZmm,"sf_metTrigZmm/F");
     Book("sf_pu",&sf_pu,"sf_pu/F");
     Book("sf_npv",&sf_npv,"sf_npv/F");
     Book("sf_tt",&sf_tt,"sf_tt/F");
@@ -480,6 +285,7 @@ void GeneralTree::WriteTree(TTree *t) {
     Book("sf_tt8TeV_ext",&sf_tt8TeV_ext,"sf_tt8TeV_ext/F");
     Book("sf_tt8TeV_bound",&sf_tt8TeV_bound,"sf_tt8TeV_bound/F");
     Book("sf_phoPurity",&sf_phoPurity,"sf_phoPurity/F");
+    Book("pfmetRaw",&pfmetRaw,"pfmetRaw/F");
     Book("pfmet",&pfmet,"pfmet/F");
     Book("pfmetphi",&pfmetphi,"pfmetphi/F");
     Book("pfmetnomu",&pfmetnomu,"pfmetnomu/F");
@@ -558,6 +364,7 @@ void GeneralTree::WriteTree(TTree *t) {
     Book("isojet2CSV",&isojet2CSV,"isojet2CSV/F");
     Book("isojet2Flav",&isojet2Flav,"isojet2Flav/I");
     Book("jetNBtags",&jetNBtags,"jetNBtags/I");
+    Book("jetNMBtags",&jetNMBtags,"jetNMBtags/I");
     Book("isojetNBtags",&isojetNBtags,"isojetNBtags/I");
     Book("nFatjet",&nFatjet,"nFatjet/I");
     Book("fj1Tau32",&fj1Tau32,"fj1Tau32/F");
@@ -570,6 +377,11 @@ void GeneralTree::WriteTree(TTree *t) {
     Book("fj1MSDSmeared",&fj1MSDSmeared,"fj1MSDSmeared/F");
     Book("fj1MSDSmearedUp",&fj1MSDSmearedUp,"fj1MSDSmearedUp/F");
     Book("fj1MSDSmearedDown",&fj1MSDSmearedDown,"fj1MSDSmearedDown/F");
+    Book("fj1MSDScaleUp_sj",&fj1MSDScaleUp_sj,"fj1MSDScaleUp_sj/F");
+    Book("fj1MSDScaleDown_sj",&fj1MSDScaleDown_sj,"fj1MSDScaleDown_sj/F");
+    Book("fj1MSDSmeared_sj",&fj1MSDSmeared_sj,"fj1MSDSmeared_sj/F");
+    Book("fj1MSDSmearedUp_sj",&fj1MSDSmearedUp_sj,"fj1MSDSmearedUp_sj/F");
+    Book("fj1MSDSmearedDown_sj",&fj1MSDSmearedDown_sj,"fj1MSDSmearedDown_sj/F");
     Book("fj1MSD_corr",&fj1MSD_corr,"fj1MSD_corr/F");
     Book("fj1Pt",&fj1Pt,"fj1Pt/F");
     Book("fj1PtScaleUp",&fj1PtScaleUp,"fj1PtScaleUp/F");
@@ -577,10 +389,16 @@ void GeneralTree::WriteTree(TTree *t) {
     Book("fj1PtSmeared",&fj1PtSmeared,"fj1PtSmeared/F");
     Book("fj1PtSmearedUp",&fj1PtSmearedUp,"fj1PtSmearedUp/F");
     Book("fj1PtSmearedDown",&fj1PtSmearedDown,"fj1PtSmearedDown/F");
+    Book("fj1PtScaleUp_sj",&fj1PtScaleUp_sj,"fj1PtScaleUp_sj/F");
+    Book("fj1PtScaleDown_sj",&fj1PtScaleDown_sj,"fj1PtScaleDown_sj/F");
+    Book("fj1PtSmeared_sj",&fj1PtSmeared_sj,"fj1PtSmeared_sj/F");
+    Book("fj1PtSmearedUp_sj",&fj1PtSmearedUp_sj,"fj1PtSmearedUp_sj/F");
+    Book("fj1PtSmearedDown_sj",&fj1PtSmearedDown_sj,"fj1PtSmearedDown_sj/F");
     Book("fj1Phi",&fj1Phi,"fj1Phi/F");
     Book("fj1Eta",&fj1Eta,"fj1Eta/F");
     Book("fj1M",&fj1M,"fj1M/F");
     Book("fj1MaxCSV",&fj1MaxCSV,"fj1MaxCSV/F");
+    Book("fj1SubMaxCSV",&fj1SubMaxCSV,"fj1SubMaxCSV/F");
     Book("fj1MinCSV",&fj1MinCSV,"fj1MinCSV/F");
     Book("fj1DoubleCSV",&fj1DoubleCSV,"fj1DoubleCSV/F");
     Book("fj1GenPt",&fj1GenPt,"fj1GenPt/F");
@@ -602,7 +420,28 @@ void GeneralTree::WriteTree(TTree *t) {
     Book("fj1NSDConst",&fj1NSDConst,"fj1NSDConst/I");
     Book("fj1EFrac100",&fj1EFrac100,"fj1EFrac100/F");
     Book("fj1SDEFrac100",&fj1SDEFrac100,"fj1SDEFrac100/F");
+    for (int beta=0; beta!=int(betaValues().size()); ++beta) {
+      TString sbeta = betaValues()[beta];
+      Book("fj1ECFN_1_1_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,0,0)],"fj1ECFN_1_1_"+sbeta+"/F");
+      Book("fj1ECFN_2_1_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,0,1)],"fj1ECFN_2_1_"+sbeta+"/F");
+      Book("fj1ECFN_3_1_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,0,2)],"fj1ECFN_3_1_"+sbeta+"/F");
+      Book("fj1ECFN_1_2_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,1,0)],"fj1ECFN_1_2_"+sbeta+"/F");
+      Book("fj1ECFN_2_2_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,1,1)],"fj1ECFN_2_2_"+sbeta+"/F");
+      Book("fj1ECFN_3_2_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,1,2)],"fj1ECFN_3_2_"+sbeta+"/F");
+      Book("fj1ECFN_1_3_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,2,0)],"fj1ECFN_1_3_"+sbeta+"/F");
+      Book("fj1ECFN_2_3_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,2,1)],"fj1ECFN_2_3_"+sbeta+"/F");
+      Book("fj1ECFN_3_3_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,2,2)],"fj1ECFN_3_3_"+sbeta+"/F");
+      Book("fj1ECFN_1_4_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,3,0)],"fj1ECFN_1_4_"+sbeta+"/F");
+      Book("fj1ECFN_2_4_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,3,1)],"fj1ECFN_2_4_"+sbeta+"/F");
+      Book("fj1ECFN_3_4_"+sbeta,&fj1ECFNs[fj1ECFNsIndex(beta,3,2)],"fj1ECFN_3_4_"+sbeta+"/F");
+    }
+    if (fatjet) {
+      Book("nfj1Groom",&nfj1Groom,"nfj1Groom/I");
+      Book("nfj1Lund",&nfj1Lund,"nfj1Lund/I");
+      Book("nfj",&nfj,"nfj/I");
+    }
     Book("nHF",&nHF,"nHF/I");
+    Book("nB",&nB,"nB/I");
     Book("nLoosePhoton",&nLoosePhoton,"nLoosePhoton/I");
     Book("nTightPhoton",&nTightPhoton,"nTightPhoton/I");
     Book("loosePho1IsTight",&loosePho1IsTight,"loosePho1IsTight/I");
@@ -619,6 +458,8 @@ void GeneralTree::WriteTree(TTree *t) {
     Book("looseLep2PdgId",&looseLep2PdgId,"looseLep2PdgId/I");
     Book("looseLep1IsTight",&looseLep1IsTight,"looseLep1IsTight/I");
     Book("looseLep2IsTight",&looseLep2IsTight,"looseLep2IsTight/I");
+    Book("looseLep1IsHLTSafe",&looseLep1IsHLTSafe,"looseLep1IsHLTSafe/I");
+    Book("looseLep2IsHLTSafe",&looseLep2IsHLTSafe,"looseLep2IsHLTSafe/I");
     Book("looseLep1Pt",&looseLep1Pt,"looseLep1Pt/F");
     Book("looseLep1Eta",&looseLep1Eta,"looseLep1Eta/F");
     Book("looseLep1Phi",&looseLep1Phi,"looseLep1Phi/F");
@@ -632,5 +473,88 @@ void GeneralTree::WriteTree(TTree *t) {
     Book("scaleDown",&scaleDown,"scaleDown/F");
     Book("pdfUp",&pdfUp,"pdfUp/F");
     Book("pdfDown",&pdfDown,"pdfDown/F");
+    Book("scale",scale,"scale[6]/F");
+    Book("isGS",&isGS,"isGS/I");
+    if (monohiggs) {
+      Book("nJotStored",&nJotStored,"nJotStored/I");
+      Book("nfj1sj",&nfj1sj,"nfj1sj/I");
+    }
+    if (fatjet) {
+      for (int beta=0; beta!=int(betaValues().size()); ++beta) {
+        TString sbeta = betaValues()[beta];
+        Book("fjECFN_1_1_"+sbeta,fjECFNs[fjECFNsIndex(beta,0,0)],TString("fjECFN_1_1_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+        Book("fjECFN_2_1_"+sbeta,fjECFNs[fjECFNsIndex(beta,0,1)],TString("fjECFN_2_1_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+        Book("fjECFN_3_1_"+sbeta,fjECFNs[fjECFNsIndex(beta,0,2)],TString("fjECFN_3_1_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+        Book("fjECFN_1_2_"+sbeta,fjECFNs[fjECFNsIndex(beta,1,0)],TString("fjECFN_1_2_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+        Book("fjECFN_2_2_"+sbeta,fjECFNs[fjECFNsIndex(beta,1,1)],TString("fjECFN_2_2_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+        Book("fjECFN_3_2_"+sbeta,fjECFNs[fjECFNsIndex(beta,1,2)],TString("fjECFN_3_2_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+        Book("fjECFN_1_3_"+sbeta,fjECFNs[fjECFNsIndex(beta,2,0)],TString("fjECFN_1_3_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+        Book("fjECFN_2_3_"+sbeta,fjECFNs[fjECFNsIndex(beta,2,1)],TString("fjECFN_2_3_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+        Book("fjECFN_3_3_"+sbeta,fjECFNs[fjECFNsIndex(beta,2,2)],TString("fjECFN_3_3_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+        Book("fjECFN_1_4_"+sbeta,fjECFNs[fjECFNsIndex(beta,3,0)],TString("fjECFN_1_4_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+        Book("fjECFN_2_4_"+sbeta,fjECFNs[fjECFNsIndex(beta,3,1)],TString("fjECFN_2_4_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+        Book("fjECFN_3_4_"+sbeta,fjECFNs[fjECFNsIndex(beta,3,2)],TString("fjECFN_3_4_"+sbeta)+(fixedArrays ? TString::Format("[%i]/F",NFATJET) : TString("[nfj]/F")));
+      }
+      Book("fj1GroomM",fj1GroomM,fixedArrays ? TString::Format("fj1GroomM[%i]/F",NGROOM) : TString("fj1GroomM[nfj1Groom]/F"));
+      Book("fj1GroomPt",fj1GroomPt,fixedArrays ? TString::Format("fj1GroomPt[%i]/F",NGROOM) : TString("fj1GroomPt[nfj1Groom]/F"));
+      Book("fj1GroomZg",fj1GroomZg,fixedArrays ? TString::Format("fj1GroomZg[%i]/F",NGROOM) : TString("fj1GroomZg[nfj1Groom]/F"));
+      Book("fj1GroomRg",fj1GroomRg,fixedArrays ? TString::Format("fj1GroomRg[%i]/F",NGROOM) : TString("fj1GroomRg[nfj1Groom]/F"));
+      Book("fj1LundLnInvDR",fj1LundLnInvDR,fixedArrays ? TString::Format("fj1LundLnInvDR[%i]/F",NLUND) : TString("fj1LundLnInvDR[nfj1Lund]/F"));
+      Book("fj1LundLnKt",fj1LundLnKt,fixedArrays ? TString::Format("fj1LundLnKt[%i]/F",NLUND) : TString("fj1LundLnKt[nfj1Lund]/F"));
+      Book("fj1LundZ",fj1LundZ,fixedArrays ? TString::Format("fj1LundZ[%i]/F",NLUND) : TString("fj1LundZ[nfj1Lund]/F"));
+      Book("fjPt",fjPt,fixedArrays ? TString::Format("fjPt[%i]/F",NFATJET) : TString("fjPt[nfj]/F"));
+      Book("fjEta",fjEta,fixedArrays ? TString::Format("fjEta[%i]/F",NFATJET) : TString("fjEta[nfj]/F"));
+      Book("fjPhi",fjPhi,fixedArrays ? TString::Format("fjPhi[%i]/F",NFATJET) : TString("fjPhi[nfj]/F"));
+      Book("fjM",fjM,fixedArrays ? TString::Format("fjM[%i]/F",NFATJET) : TString("fjM[nfj]/F"));
+      Book("fjMSD",fjMSD,fixedArrays ? TString::Format("fjMSD[%i]/F",NFATJET) : TString("fjMSD[nfj]/F"));
+      Book("fjMSD_corr",fjMSD_corr,fixedArrays ? TString::Format("fjMSD_corr[%i]/F",NFATJET) : TString("fjMSD_corr[nfj]/F"));
+      Book("fjRawPt",fjRawPt,fixedArrays ? TString::Format("fjRawPt[%i]/F",NFATJET) : TString("fjRawPt[nfj]/F"));
+      Book("fjPtScaleUp",fjPtScaleUp,fixedArrays ? TString::Format("fjPtScaleUp[%i]/F",NFATJET) : TString("fjPtScaleUp[nfj]/F"));
+      Book("fjPtScaleDown",fjPtScaleDown,fixedArrays ? TString::Format("fjPtScaleDown[%i]/F",NFATJET) : TString("fjPtScaleDown[nfj]/F"));
+      Book("fjPtSmeared",fjPtSmeared,fixedArrays ? TString::Format("fjPtSmeared[%i]/F",NFATJET) : TString("fjPtSmeared[nfj]/F"));
+      Book("fjPtSmearedUp",fjPtSmearedUp,fixedArrays ? TString::Format("fjPtSmearedUp[%i]/F",NFATJET) : TString("fjPtSmearedUp[nfj]/F"));
+      Book("fjPtSmearedDown",fjPtSmearedDown,fixedArrays ? TString::Format("fjPtSmearedDown[%i]/F",NFATJET) : TString("fjPtSmearedDown[nfj]/F"));
+      Book("fjMSDScaleUp",fjMSDScaleUp,fixedArrays ? TString::Format("fjMSDScaleUp[%i]/F",NFATJET) : TString("fjMSDScaleUp[nfj]/F"));
+      Book("fjMSDScaleDown",fjMSDScaleDown,fixedArrays ? TString::Format("fjMSDScaleDown[%i]/F",NFATJET) : TString("fjMSDScaleDown[nfj]/F"));
+      Book("fjMSDSmeared",fjMSDSmeared,fixedArrays ? TString::Format("fjMSDSmeared[%i]/F",NFATJET) : TString("fjMSDSmeared[nfj]/F"));
+      Book("fjMSDSmearedUp",fjMSDSmearedUp,fixedArrays ? TString::Format("fjMSDSmearedUp[%i]/F",NFATJET) : TString("fjMSDSmearedUp[nfj]/F"));
+      Book("fjMSDSmearedDown",fjMSDSmearedDown,fixedArrays ? TString::Format("fjMSDSmearedDown[%i]/F",NFATJET) : TString("fjMSDSmearedDown[nfj]/F"));
+      Book("fjPtScaleUp_sj",fjPtScaleUp_sj,fixedArrays ? TString::Format("fjPtScaleUp_sj[%i]/F",NFATJET) : TString("fjPtScaleUp_sj[nfj]/F"));
+      Book("fjPtScaleDown_sj",fjPtScaleDown_sj,fixedArrays ? TString::Format("fjPtScaleDown_sj[%i]/F",NFATJET) : TString("fjPtScaleDown_sj[nfj]/F"));
+      Book("fjPtSmeared_sj",fjPtSmeared_sj,fixedArrays ? TString::Format("fjPtSmeared_sj[%i]/F",NFATJET) : TString("fjPtSmeared_sj[nfj]/F"));
+      Book("fjMSDScaleUp_sj",fjMSDScaleUp_sj,fixedArrays ? TString::Format("fjMSDScaleUp_sj[%i]/F",NFATJET) : TString("fjMSDScaleUp_sj[nfj]/F"));
+      Book("fjMSDScaleDown_sj",fjMSDScaleDown_sj,fixedArrays ? TString::Format("fjMSDScaleDown_sj[%i]/F",NFATJET) : TString("fjMSDScaleDown_sj[nfj]/F"));
+      Book("fjMSDSmeared_sj",fjMSDSmeared_sj,fixedArrays ? TString::Format("fjMSDSmeared_sj[%i]/F",NFATJET) : TString("fjMSDSmeared_sj[nfj]/F"));
+      Book("fjTau32",fjTau32,fixedArrays ? TString::Format("fjTau32[%i]/F",NFATJET) : TString("fjTau32[nfj]/F"));
+      Book("fjTau21",fjTau21,fixedArrays ? TString::Format("fjTau21[%i]/F",NFATJET) : TString("fjTau21[nfj]/F"));
+      Book("fjTau32SD",fjTau32SD,fixedArrays ? TString::Format("fjTau32SD[%i]/F",NFATJET) : TString("fjTau32SD[nfj]/F"));
+      Book("fjTau21SD",fjTau21SD,fixedArrays ? TString::Format("fjTau21SD[%i]/F",NFATJET) : TString("fjTau21SD[nfj]/F"));
+      Book("fjMaxCSV",fjMaxCSV,fixedArrays ? TString::Format("fjMaxCSV[%i]/F",NFATJET) : TString("fjMaxCSV[nfj]/F"));
+      Book("fjMinCSV",fjMinCSV,fixedArrays ? TString::Format("fjMinCSV[%i]/F",NFATJET) : TString("fjMinCSV[nfj]/F"));
+      Book("fjSubMaxCSV",fjSubMaxCSV,fixedArrays ? TString::Format("fjSubMaxCSV[%i]/F",NFATJET) : TString("fjSubMaxCSV[nfj]/F"));
+      Book("fjDoubleCSV",fjDoubleCSV,fixedArrays ? TString::Format("fjDoubleCSV[%i]/F",NFATJET) : TString("fjDoubleCSV[nfj]/F"));
+      Book("fjHTTMass",fjHTTMass,fixedArrays ? TString::Format("fjHTTMass[%i]/F",NFATJET) : TString("fjHTTMass[nfj]/F"));
+      Book("fjHTTFRec",fjHTTFRec,fixedArrays ? TString::Format("fjHTTFRec[%i]/F",NFATJET) : TString("fjHTTFRec[nfj]/F"));
+      Book("fjEFrac100",fjEFrac100,fixedArrays ? TString::Format("fjEFrac100[%i]/F",NFATJET) : TString("fjEFrac100[nfj]/F"));
+      Book("fjSDEFrac100",fjSDEFrac100,fixedArrays ? TString::Format("fjSDEFrac100[%i]/F",NFATJET) : TString("fjSDEFrac100[nfj]/F"));
+      Book("fjIsClean",fjIsClean,fixedArrays ? TString::Format("fjIsClean[%i]/I",NFATJET) : TString("fjIsClean[nfj]/I"));
+      Book("fjNConst",fjNConst,fixedArrays ? TString::Format("fjNConst[%i]/I",NFATJET) : TString("fjNConst[nfj]/I"));
+      Book("fjNSDConst",fjNSDConst,fixedArrays ? TString::Format("fjNSDConst[%i]/I",NFATJET) : TString("fjNSDConst[nfj]/I"));
+    }
+    if (monohiggs) {
+      Book("jetPt",jetPt,fixedArrays ? TString::Format("jetPt[%i]/F",NJET) : TString("jetPt[nJotStored]/F"));
+      Book("jetEta",jetEta,fixedArrays ? TString::Format("jetEta[%i]/F",NJET) : TString("jetEta[nJotStored]/F"));
+      Book("jetPhi",jetPhi,fixedArrays ? TString::Format("jetPhi[%i]/F",NJET) : TString("jetPhi[nJotStored]/F"));
+      Book("jetE",jetE,fixedArrays ? TString::Format("jetE[%i]/F",NJET) : TString("jetE[nJotStored]/F"));
+      Book("jetCSV",jetCSV,fixedArrays ? TString::Format("jetCSV[%i]/F",NJET) : TString("jetCSV[nJotStored]/F"));
+      Book("jetIso",jetIso,fixedArrays ? TString::Format("jetIso[%i]/F",NJET) : TString("jetIso[nJotStored]/F"));
+      Book("jetQGL",jetQGL,fixedArrays ? TString::Format("jetQGL[%i]/F",NJET) : TString("jetQGL[nJotStored]/F"));
+      Book("fj1sjPt",fj1sjPt,fixedArrays ? TString::Format("fj1sjPt[%i]/F",NSUBJET) : TString("fj1sjPt[nfj1sj]/F"));
+      Book("fj1sjPhi",fj1sjPhi,fixedArrays ? TString::Format("fj1sjPhi[%i]/F",NSUBJET) : TString("fj1sjPhi[nfj1sj]/F"));
+      Book("fj1sjEta",fj1sjEta,fixedArrays ? TString::Format("fj1sjEta[%i]/F",NSUBJET) : TString("fj1sjEta[nfj1sj]/F"));
+      Book("fj1sjM",fj1sjM,fixedArrays ? TString::Format("fj1sjM[%i]/F",NSUBJET) : TString("fj1sjM[nfj1sj]/F"));
+      Book("fj1sjCSV",fj1sjCSV,fixedArrays ? TString::Format("fj1sjCSV[%i]/F",NSUBJET) : TString("fj1sjCSV[nfj1sj]/F"));
+      Book("fj1sjQGL",fj1sjQGL,fixedArrays ? TString::Format("fj1sjQGL[%i]/F",NSUBJET) : TString("fj1sjQGL[nfj1sj]/F"));
+    }
 }
 
@@ -0,0 +1,56 @@
+#include "../interface/HistogramBank.h"
+#include "TArrayD.h"
+#include <algorithm>
+
+HistogramBank::HistogramBank(std::vector<TH1D*> hists_) :
+	hists(hists_),
+	axis(hists_.at(0)->GetXaxis()),
+	nVariations(hists_.size())
+{
+	int nBins = axis->GetNbins();
+	for (auto *h : hists) {
+		const TAxis *a = h->GetXaxis();
+		bool same = (a->GetNbins()==nBins);
+		for (int iB=1; same && iB<=nBins+1; ++iB)
+			same = (a->GetBinLowEdge(iB)==axis->GetBinLowEdge(iB));
+		if (!same)
+			PError("HistogramBank::HistogramBank",
+			       TString::Format("%s does not have the binning of %s",h->GetName(),hists[0]->GetName()));
+	}
+	sumw.assign((nBins+2)*nVariations,0);
+	sumw2.assign((nBins+2)*nVariations,0);
+}
+
+void HistogramBank::Fill(int bin, double weight, const double *factors)
+{
+	double *w = sumw.data()+bin*nVariations;
+	double *w2 = sumw2.data()+bin*nVariations;
+	for (unsigned iV=0; iV!=nVariations; ++iV) {
+		double x = weight*factors[iV];
+		w[iV] += x;
+		w2[iV] += x*x;
+	}
+	++nEntries;
+}
+
+void HistogramBank::Unload()
+{
+	int nBins = axis->GetNbins();
+	for (unsigned iV=0; iV!=nVariations; ++iV) {
+		TH1D *h = hists[iV];
+		Double_t entries = h->GetEntries();
+		if (h->GetSumw2N()==0)
+			h->Sumw2();
+		TArrayD &hw2 = *(h->GetSumw2());
+		for (int iB=0; iB<=nBins+1; ++iB) {
+			h->AddBinContent(iB,sumw[iB*nVariations+iV]);
+			hw2[iB] += sumw2[iB*nVariations+iV];
+		}
+		// the moments are recomputed from the bins, which excludes the under/overflow as Fill does
+		h->ResetStats();
+		h->SetEntries(entries+nEntries);
+	}
+	std::fill(sumw.begin(),sumw.end(),0);
+	std::fill(sumw2.begin(),sumw2.end(),0);
+	nEntries = 0;
+}
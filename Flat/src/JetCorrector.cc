@@ -1,5 +1,6 @@
 #include "../interface/JetCorrector.h"
 #include "TLorentzVector.h"
+#include "TMath.h"
 
 JetCorrector::JetCorrector() 
 { 
@@ -49,68 +50,115 @@ void JetCorrector::SetDataCorrector(TString fpath, TString iov)
 void JetCorrector::RunCorrection(bool isData, float rho, panda::JetCollection *injets_, panda::Met *rawmet_, int runNumber)
 {
 	FactorizedJetCorrector *corrector=0;
-	if (isData) {
-		if (mDataJetCorrectors.find("all") != mDataJetCorrectors.end()) {
-			// we have an era-independent corrector. use it
-			corrector = mDataJetCorrectors["all"];
-		} else {
-			TString thisEra = era->getEra(runNumber);
-			TString thisEraGroup;
-			for (auto &iter : mDataJetCorrectors) {
-				if (iter.first.Contains(thisEra)) {
-					thisEraGroup = iter.first;
-					corrector = iter.second;
-					break;
+	bool applyJEC = (mMCJetCorrector!=0 || mDataJetCorrectors.size()>0);
+	if (applyJEC) {
+		if (isData) {
+			if (mDataJetCorrectors.find("all") != mDataJetCorrectors.end()) {
+				// we have an era-independent corrector. use it
+				corrector = mDataJetCorrectors["all"];
+			} else {
+				TString thisEra = era->getEra(runNumber);
+				TString thisEraGroup;
+				for (auto &iter : mDataJetCorrectors) {
+					if (iter.first.Contains(thisEra)) {
+						thisEraGroup = iter.first;
+						corrector = iter.second;
+						break;
+					}
 				}
 			}
+		} else {
+			corrector = mMCJetCorrector;
+		}
+		if (corrector==0) {
+			PError("JetCorrector::RunCorrection",
+					TString::Format("Could not determine data era for run %i",runNumber)
+					);
+			assert(corrector!=0);
 		}
-	} else {
-		corrector = mMCJetCorrector;
-	}
-	if (corrector==0) {
-		PError("JetCorrector::RunCorrection",
-				TString::Format("Could not determine data era for run %i",runNumber)
-				);
-		assert(corrector!=0);
 	}
 
-	TLorentzVector v_outmet;
+	// every shift starts from the raw met and subtracts (corrected - raw) for each jet
+	double metx[nMETShift], mety[nMETShift];
 	if (rawmet_) {
-		v_outmet.SetPtEtaPhiM(rawmet_->pt,0,rawmet_->phi,0);
-		outmet = new panda::Met();
+		for (unsigned iS=0; iS!=nMETShift; ++iS) {
+			metx[iS] = rawmet_->pt*TMath::Cos(rawmet_->phi);
+			mety[iS] = rawmet_->pt*TMath::Sin(rawmet_->phi);
+		}
+		if (!outmet)
+			outmet = new panda::Met(); // reused across calls
 	}
 
-	outjets = new panda::JetCollection();
+	if (makeJets)
+		outjets = new panda::JetCollection();
 
-	TLorentzVector v_j_in, v_j_out;
+	TLorentzVector v_j_in;
+	double scales[nMETShift];
+	scales[kNominal] = 1;
 	for (auto &j_in : *injets_) {
 		double jecFactor = 1;
-		v_j_in.SetPtEtaPhiM(j_in.rawPt,j_in.eta(),j_in.phi(),j_in.m());
-		if (fabs(j_in.eta())<5.191) {
-			corrector->setJetPt(j_in.rawPt);
-			corrector->setJetEta(j_in.eta());
-			corrector->setJetPhi(j_in.phi());
-			corrector->setJetE(v_j_in.E());
-			corrector->setRho(rho);
-			corrector->setJetA(j_in.area);
-			corrector->setJetEMF(-99);
-			jecFactor = corrector->getCorrection();
+		if (corrector) {
+			v_j_in.SetPtEtaPhiM(j_in.rawPt,j_in.eta(),j_in.phi(),j_in.m());
+			if (fabs(j_in.eta())<5.191) {
+				corrector->setJetPt(j_in.rawPt);
+				corrector->setJetEta(j_in.eta());
+				corrector->setJetPhi(j_in.phi());
+				corrector->setJetE(v_j_in.E());
+				corrector->setRho(rho);
+				corrector->setJetA(j_in.area);
+				corrector->setJetEMF(-99);
+				jecFactor = corrector->getCorrection();
+			}
+		} else if (j_in.rawPt>0) {
+			jecFactor = j_in.pt()/j_in.rawPt;
 		}
-		v_j_out.SetPtEtaPhiM(jecFactor*j_in.rawPt,j_in.eta(),j_in.phi(),j_in.m());
-		
-		panda::Jet &j_out = outjets->create_back();
-		j_out.setPtEtaPhiM(jecFactor*j_in.rawPt,j_in.eta(),j_in.phi(),j_in.m());
-		j_out.rawPt = j_in.rawPt;
-
-		if (rawmet_) {
-			TLorentzVector v_diff = v_j_in - v_j_out;
-			v_outmet += v_diff;
+		double pt = jecFactor*j_in.rawPt;
+
+		if (makeJets) {
+			panda::Jet &j_out = outjets->create_back();
+			j_out.setPtEtaPhiM(pt,j_in.eta(),j_in.phi(),j_in.m());
+			j_out.rawPt = j_in.rawPt;
+		}
+
+		if (!rawmet_)
+			continue;
+
+		// all variations are expressed as a scale on the nominal corrected pt
+		double unc = 0;
+		if (uncReader) {
+			uncReader->setJetEta(j_in.eta()); uncReader->setJetPt(pt);
+			unc = uncReader->getUncertainty(true);
+			scales[kJESUp] = 1 + unc;
+			scales[kJESDown] = 1 - unc;
+		} else if (j_in.pt()>0) {
+			scales[kJESUp] = j_in.ptCorrUp/j_in.pt();
+			scales[kJESDown] = j_in.ptCorrDown/j_in.pt();
+		} else {
+			scales[kJESUp] = 1; scales[kJESDown] = 1;
+		}
+		double smear=1, smearUp=1, smearDown=1;
+		if (jerReader && !isData)
+			jerReader->getStochasticSmear(pt,j_in.eta(),rho,smear,smearUp,smearDown);
+		scales[kJER] = smear;
+		scales[kJERUp] = smearUp;
+		scales[kJERDown] = smearDown;
+
+		double cosphi = TMath::Cos(j_in.phi()), sinphi = TMath::Sin(j_in.phi());
+		for (unsigned iS=0; iS!=nMETShift; ++iS) {
+			double ptShifted = scales[iS]*pt;
+			if (ptShifted<minMetJetPt)
+				continue;
+			double dpt = j_in.rawPt - ptShifted;
+			metx[iS] += dpt*cosphi;
+			mety[iS] += dpt*sinphi;
 		}
 	}
 
 	if (rawmet_) {
-		outmet->pt = v_outmet.Pt();
-		outmet->phi = v_outmet.Phi();
+		for (unsigned iS=0; iS!=nMETShift; ++iS)
+			outmets[iS].Set(metx[iS],mety[iS]);
+		outmet->pt = outmets[kNominal].Mod();
+		outmet->phi = TVector2::Phi_mpi_pi(outmets[kNominal].Phi());
 	}
 }
 
@@ -1,5 +1,6 @@
 #include <TTreeFormula.h>
 #include "../interface/LimitTreeBuilder.h"
+#include "../interface/AsyncTreeWriter.h"
 #include "PandaCore/Tools/interface/TreeTools.h"
 
 Process::Process(TString n, TTree *in, VariableMap *vPtr, TString sel, TString w) {
@@ -33,7 +34,7 @@ Process::~Process() {
 	delete inputTree;
 }
 
-void Process::Run() {
+void Process::Run(unsigned nWriterRows) {
 	PInfo("LimitTreeBuilder::Process::Run",TString::Format("%s%s",name.Data(),syst.Data()));
 
 	inputTree->SetBranchStatus("*",0);
@@ -46,44 +47,68 @@ void Process::Run() {
 		turnOnBranches(inputTree,x->formula);
 	}
 
-	// apply selection
-	TTree *clonedTree = (TTree*)inputTree->CopyTree(selection.Data());
-
-	// load inputs	
+	// the selection is evaluated on the input tree itself instead of copying
+	// the selected entries, so the output file only receives limitTree and,
+	// with a writer thread, only that thread touches it
 	for (auto *x : vars) 
-		clonedTree->SetBranchAddress(x->formula,x->val);
+		inputTree->SetBranchAddress(x->formula,x->val);
 
 	std::vector<TTreeFormula*> treeformulae;
 	for (auto *x : formulae) {
-		TTreeFormula *tf = new TTreeFormula(x->name.Data(),x->formula.Data(),clonedTree);
+		TTreeFormula *tf = new TTreeFormula(x->name.Data(),x->formula.Data(),inputTree);
 		tf->SetQuickLoad(true);
 		tf->GetNdata();
 		treeformulae.push_back(tf);
 	}
 	unsigned int nF = treeformulae.size();
 
-	TTreeFormula fweight(TString::Format("w_%s",name.Data()).Data(),weight.Data(),clonedTree);
+	TTreeFormula fweight(TString::Format("w_%s",name.Data()).Data(),weight.Data(),inputTree);
 	fweight.SetQuickLoad(true);
 	fweight.GetNdata();
+	TTreeFormula *fselection = 0;
+	if (selection!="") {
+		fselection = new TTreeFormula(TString::Format("s_%s",name.Data()).Data(),selection.Data(),inputTree);
+		fselection->SetQuickLoad(true);
+		fselection->GetNdata();
+	}
 	float weightval=0; 
 	limitTree->Branch("weight",&weightval,"weight/F");
 
+	AsyncTreeWriter writer(limitTree,nWriterRows);
+	if (nWriterRows>0)
+		writer.Start();
+
 	// loop through and do stuff
-	unsigned int nEntries = clonedTree->GetEntries(), iE=0;
+	unsigned int nEntries = inputTree->GetEntries(), iE=0;
+	int treeNumber = -1;
 	ProgressReporter pr("LimitTreeBuilder::Process::Run",&iE,&nEntries,10);
 	for (iE=0; iE!=nEntries; ++iE) {
 		pr.Report();
-		clonedTree->GetEntry(iE);
+		inputTree->GetEntry(iE);
+		if (inputTree->GetTreeNumber()!=treeNumber) {
+			// a chain moved to its next file
+			treeNumber = inputTree->GetTreeNumber();
+			for (auto tf : treeformulae)
+				tf->UpdateFormulaLeaves();
+			fweight.UpdateFormulaLeaves();
+			if (fselection)
+				fselection->UpdateFormulaLeaves();
+		}
+		if (fselection && fselection->EvalInstance()==0)
+			continue;
 		weightval = fweight.EvalInstance();
 		for (unsigned int iF=0; iF!=nF; ++iF) {
 			*(formulae[iF]->val) = treeformulae[iF]->EvalInstance();
 		}
-		limitTree->Fill();
+		writer.Fill();
 	}
+	writer.Finish();
 
+	// the input may be shared with other processes
+	inputTree->ResetBranchAddresses();
 	for (auto tf : treeformulae)
 		delete tf;
-	delete clonedTree;
+	delete fselection;
 }
 
 void LimitTreeBuilder::Output() {
@@ -0,0 +1,170 @@
+#include "../interface/LumiMask.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cctype>
+#include "TBranch.h"
+#include "TLeaf.h"
+
+bool LumiMask::LoadJSON(TString path)
+{
+	std::ifstream fin(path.Data());
+	if (!fin.is_open()) {
+		PError("LumiMask::LoadJSON","Could not open "+path);
+		return false;
+	}
+	std::stringstream buffer;
+	buffer << fin.rdbuf();
+	const std::string json = buffer.str();
+
+	unsigned nBefore = ranges.size();
+	int depth=0, run=-1;
+	std::vector<long> bounds;
+	for (size_t i=0; i<json.size(); ++i) {
+		char c = json[i];
+		bool bad = false;
+		if (c=='{') {
+			bad = (depth++!=0);
+		} else if (c=='}') {
+			bad = (--depth!=0);
+		} else if (c=='[') {
+			bad = (++depth>3 || depth<2 || run<0);
+		} else if (c==']') {
+			if (depth--==3) {
+				bad = (bounds.size()!=2);
+				if (!bad)
+					AddRange(run,bounds[0],bounds[1]);
+				bounds.clear();
+			}
+		} else if (c=='"') {
+			size_t end = json.find('"',i+1);
+			bad = (depth!=1 || end==std::string::npos);
+			if (!bad) {
+				run = std::atoi(json.substr(i+1,end-i-1).c_str());
+				i = end;
+			}
+		} else if (std::isdigit(c)) {
+			char *end;
+			bounds.push_back(std::strtol(json.c_str()+i,&end,10));
+			bad = (depth!=3);
+			i = end-json.c_str()-1;
+		} else if (!(std::isspace(c) || c==',' || c==':')) {
+			bad = true;
+		}
+		if (bad) {
+			PError("LumiMask::LoadJSON",TString::Format("Could not parse %s at character %lu",
+			                                             path.Data(),(unsigned long)i));
+			ranges.resize(nBefore);
+			return false;
+		}
+	}
+
+	PInfo("LumiMask::LoadJSON",TString::Format("Loaded %u lumi ranges from %s",
+	                                           (unsigned)(ranges.size()-nBefore),path.Data()));
+	return true;
+}
+
+void LumiMask::AddRange(int run, int l0, int l1)
+{
+	ranges.push_back({run,l0,l1});
+	sorted = false;
+	lastRun = -1; lastRange = -1;
+}
+
+void LumiMask::Sort()
+{
+	if (sorted)
+		return;
+	std::sort(ranges.begin(),ranges.end(),
+	          [](const Range &a, const Range &b)->bool {
+	            return (a.run<b.run) || (a.run==b.run && a.l0<b.l0);
+	          });
+	// merge overlapping and adjacent ranges, so at most one range can contain a lumi
+	std::vector<Range> merged;
+	for (auto &r : ranges) {
+		if (!merged.empty() && merged.back().run==r.run && r.l0<=merged.back().l1+1)
+			merged.back().l1 = std::max(merged.back().l1,r.l1);
+		else
+			merged.push_back(r);
+	}
+	ranges.swap(merged);
+	sorted = true;
+}
+
+bool LumiMask::Pass(int run, int lumi)
+{
+	if (run==lastRun && lumi==lastLumi)
+		return lastPass;
+	lastRun = run; lastLumi = lumi;
+
+	if (lastRange>=0) {
+		const Range &r = ranges[lastRange];
+		if (r.run==run && r.l0<=lumi && lumi<=r.l1)
+			return (lastPass=true);
+	}
+
+	Sort();
+	// last range starting at or before (run, lumi)
+	auto next = std::upper_bound(ranges.begin(),ranges.end(),std::make_pair(run,lumi),
+	                             [](const std::pair<int,int> &rl, const Range &r)->bool {
+	                               return (rl.first<r.run) || (rl.first==r.run && rl.second<r.l0);
+	                             });
+	lastPass = false;
+	if (next!=ranges.begin()) {
+		auto r = next-1;
+		if (r->run==run && lumi<=r->l1) {
+			lastPass = true;
+			lastRange = r-ranges.begin();
+		}
+	}
+	return lastPass;
+}
+
+bool LumiEntryIndex::Build(TTree *t, Long64_t first, Long64_t last,
+                           const char *runBranch, const char *lumiBranch)
+{
+	blocks.clear(); cursor = 0; nSkipped = 0;
+
+	// leaves are read through whatever address is set, so the branches of
+	// the input event are left untouched
+	int treeNumber = -1;
+	TBranch *bRun=0, *bLumi=0;
+	for (Long64_t iE=first; iE<last; ++iE) {
+		Long64_t local = t->LoadTree(iE);
+		if (local<0)
+			break;
+		if (t->GetTreeNumber()!=treeNumber) {
+			treeNumber = t->GetTreeNumber();
+			bRun = t->GetBranch(runBranch);
+			bLumi = t->GetBranch(lumiBranch);
+			if (!bRun || !bLumi) {
+				PError("LumiEntryIndex::Build",TString::Format("Could not find %s and %s",runBranch,lumiBranch));
+				blocks.clear();
+				return false;
+			}
+		}
+		bRun->GetEntry(local);
+		bLumi->GetEntry(local);
+		int run = bRun->GetLeaf(runBranch)->GetValue();
+		int lumi = bLumi->GetLeaf(lumiBranch)->GetValue();
+		if (!blocks.empty() && blocks.back().run==run && blocks.back().lumi==lumi)
+			blocks.back().end = iE+1;
+		else
+			blocks.push_back({run,lumi,iE,iE+1});
+	}
+	return true;
+}
+
+Long64_t LumiEntryIndex::NextGood(Long64_t iE, LumiMask &mask)
+{
+	while (cursor<blocks.size() && blocks[cursor].end<=iE)
+		++cursor;
+	while (cursor<blocks.size() && blocks[cursor].first<=iE
+	       && !mask.Pass(blocks[cursor].run,blocks[cursor].lumi)) {
+		nSkipped += blocks[cursor].end-iE;
+		iE = blocks[cursor].end;
+		++cursor;
+	}
+	return iE;
+}
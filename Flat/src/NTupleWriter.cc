@@ -0,0 +1,152 @@
+#include "../interface/NTupleWriter.h"
+#include "RVersion.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,32,0)
+
+#include <ROOT/RNTupleModel.hxx>
+#include <ROOT/RField.hxx>
+#if __has_include(<ROOT/RNTupleWriter.hxx>)
+#include <ROOT/RNTupleWriter.hxx>
+#else
+#include <ROOT/RNTuple.hxx>
+#endif
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,36,0)
+namespace rnt = ROOT;
+#else
+namespace rnt = ROOT::Experimental;
+#endif
+
+struct NTupleWriter::Impl {
+	std::unique_ptr<rnt::RNTupleWriter> writer;
+	std::unique_ptr<rnt::REntry> entry;
+	std::vector<std::function<void()>> copies; // of the variable-length arrays
+};
+
+template <typename T>
+static std::function<void()> BindVector(rnt::REntry &entry, std::string field,
+                                        const char *src, const Int_t *count)
+{
+	auto v = std::make_shared<std::vector<T>>();
+	entry.BindValue(field,v);
+	const T *begin = reinterpret_cast<const T*>(src);
+	return [v,begin,count]() { v->assign(begin,begin+std::max(*count,0)); };
+}
+
+bool NTupleWriter::Open()
+{
+	if (impl)
+		return true;
+
+	static const std::map<TString,TString> types = {
+		{"Float_t","float"}, {"Float16_t","float"}, {"Double_t","double"},
+		{"Int_t","std::int32_t"}, {"UInt_t","std::uint32_t"},
+		{"Long64_t","std::int64_t"}, {"ULong64_t","std::uint64_t"},
+		{"Bool_t","bool"}
+	};
+	struct Spec {
+		std::string field;
+		TString leafType;
+		char *src;
+		const Int_t *count;
+	};
+
+	std::vector<Spec> specs;
+	auto model = rnt::RNTupleModel::CreateBare();
+	TObjArray *branches = schema->GetListOfBranches();
+	for (int iB=0; iB!=branches->GetEntriesFast(); ++iB) {
+		TBranch *b = static_cast<TBranch*>(branches->At(iB));
+		TLeaf *l = (b->GetListOfLeaves()->GetEntriesFast()==1) ?
+		           static_cast<TLeaf*>(b->GetListOfLeaves()->At(0)) : 0;
+		auto type = l ? types.find(l->GetTypeName()) : types.end();
+		TLeaf *lc = l ? l->GetLeafCount() : 0;
+		if (b->IsA()!=TBranch::Class() || !b->GetAddress() || type==types.end()
+		    || (lc && (TString(lc->GetTypeName())!="Int_t" || type->first=="Bool_t"))) {
+			PError("NTupleWriter::Open",TString("Cannot write branch ")+b->GetName());
+			return false;
+		}
+
+		Spec s{b->GetName(),type->first,b->GetAddress(),0};
+		TString fieldType = type->second;
+		if (lc) {
+			s.count = reinterpret_cast<const Int_t*>(lc->GetBranch()->GetAddress()+lc->GetOffset());
+			fieldType = "std::vector<"+fieldType+">";
+		} else if (l->GetLenStatic()>1) {
+			fieldType = TString::Format("std::array<%s,%i>",fieldType.Data(),l->GetLenStatic());
+		}
+		model->AddField(rnt::RFieldBase::Create(s.field,fieldType.Data()).Unwrap());
+		specs.push_back(s);
+	}
+
+	impl = new Impl;
+	impl->writer = rnt::RNTupleWriter::Append(std::move(model),name.Data(),*f);
+	impl->entry = impl->writer->CreateEntry();
+	for (auto &s : specs) {
+		if (!s.count) {
+			impl->entry->BindRawPtr(s.field,static_cast<void*>(s.src));
+		} else if (s.leafType=="Float_t" || s.leafType=="Float16_t") {
+			impl->copies.push_back(BindVector<float>(*impl->entry,s.field,s.src,s.count));
+		} else if (s.leafType=="Double_t") {
+			impl->copies.push_back(BindVector<double>(*impl->entry,s.field,s.src,s.count));
+		} else if (s.leafType=="Int_t") {
+			impl->copies.push_back(BindVector<std::int32_t>(*impl->entry,s.field,s.src,s.count));
+		} else if (s.leafType=="UInt_t") {
+			impl->copies.push_back(BindVector<std::uint32_t>(*impl->entry,s.field,s.src,s.count));
+		} else if (s.leafType=="Long64_t") {
+			impl->copies.push_back(BindVector<std::int64_t>(*impl->entry,s.field,s.src,s.count));
+		} else {
+			impl->copies.push_back(BindVector<std::uint64_t>(*impl->entry,s.field,s.src,s.count));
+		}
+	}
+	return true;
+}
+
+void NTupleWriter::Fill()
+{
+	if (!impl)
+		return;
+	for (auto &copy : impl->copies)
+		copy();
+	impl->writer->Fill(*(impl->entry));
+	++nFilled;
+}
+
+void NTupleWriter::Close()
+{
+	if (!impl)
+		return;
+	// the writer commits the last cluster when it is destroyed
+	impl->entry.reset();
+	impl->writer.reset();
+	delete impl;
+	impl = 0;
+	PInfo("NTupleWriter::Close",TString::Format("Wrote %lld entries to the RNTuple %s",nFilled,name.Data()));
+}
+
+#else
+
+struct NTupleWriter::Impl { };
+
+bool NTupleWriter::Open()
+{
+	PError("NTupleWriter::Open","RNTuple output needs ROOT 6.32 or later");
+	return false;
+}
+
+void NTupleWriter::Fill() { }
+
+void NTupleWriter::Close() { }
+
+#endif
+
+NTupleWriter::~NTupleWriter()
+{
+	Close();
+}
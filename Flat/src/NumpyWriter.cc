@@ -0,0 +1,102 @@
+#include "../interface/NumpyWriter.h"
+#include <cstring>
+
+// the header is padded to a fixed length so it can be rewritten in place
+static const unsigned headerLength = 128;
+
+bool NumpyWriter::Open(TString path, std::vector<unsigned> shape_, bool half_)
+{
+	Close();
+	shape = shape_;
+	half = half_;
+	nRecords = 0;
+	recordSize = 1;
+	for (auto s : shape)
+		recordSize *= s;
+	if (half)
+		halfBuffer.resize(recordSize);
+
+	fout = fopen(path.Data(),"wb");
+	if (!fout) {
+		PError("NumpyWriter::Open","Could not open "+path);
+		return false;
+	}
+	WriteHeader();
+	return true;
+}
+
+void NumpyWriter::WriteHeader()
+{
+	TString dict = TString::Format("{'descr': '%s', 'fortran_order': False, 'shape': (%lu, ",
+	                               half ? "<f2" : "<f4", nRecords);
+	for (auto s : shape)
+		dict += TString::Format("%u, ",s);
+	dict += "), }";
+	// magic(6) + version(2) + length(2) + dict, terminated by a newline
+	unsigned dictLength = headerLength-10;
+	while ((unsigned)dict.Length()<dictLength-1)
+		dict += " ";
+	dict += "\n";
+
+	unsigned char preamble[10] = {0x93,'N','U','M','P','Y',1,0,
+	                              (unsigned char)(dictLength&0xff),(unsigned char)(dictLength>>8)};
+	fseek(fout,0,SEEK_SET);
+	fwrite(preamble,1,10,fout);
+	fwrite(dict.Data(),1,dictLength,fout);
+	fseek(fout,0,SEEK_END);
+}
+
+void NumpyWriter::Write(const float *record)
+{
+	if (!fout)
+		return;
+	if (half) {
+		for (unsigned i=0; i!=recordSize; ++i)
+			halfBuffer[i] = FloatToHalf(record[i]);
+		fwrite(halfBuffer.data(),sizeof(unsigned short),recordSize,fout);
+	} else {
+		fwrite(record,sizeof(float),recordSize,fout);
+	}
+	++nRecords;
+}
+
+void NumpyWriter::Close()
+{
+	if (!fout)
+		return;
+	WriteHeader();
+	fclose(fout);
+	fout = 0;
+}
+
+unsigned short NumpyWriter::FloatToHalf(float f)
+{
+	// IEEE 754 binary16, round to nearest even (little-endian hosts only)
+	unsigned int x;
+	std::memcpy(&x,&f,sizeof(x));
+	unsigned short sign = (x>>16) & 0x8000;
+	int exponent = int((x>>23) & 0xff) - 127 + 15;
+	unsigned int mantissa = x & 0x7fffff;
+
+	if (((x>>23) & 0xff)==0xff) // inf or nan
+		return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+	if (exponent>=31) // overflow
+		return sign | 0x7c00;
+	if (exponent<=0) { // subnormal or zero
+		if (exponent<-10)
+			return sign;
+		mantissa |= 0x800000;
+		unsigned int shift = 14-exponent;
+		unsigned int halfMant = mantissa>>shift;
+		unsigned int rest = mantissa & ((1u<<shift)-1);
+		unsigned int halfway = 1u<<(shift-1);
+		if (rest>halfway || (rest==halfway && (halfMant&1)))
+			++halfMant;
+		return sign | halfMant;
+	}
+	unsigned short h = sign | (exponent<<10) | (mantissa>>13);
+	unsigned int rest = mantissa & 0x1fff;
+	if (rest>0x1000 || (rest==0x1000 && (h&1)))
+		++h; // may carry into the exponent, which is still correct
+	return h;
+}
@@ -1,6 +1,7 @@
 #include "../interface/PandaAnalyzer.h"
 #include "TVector2.h"
 #include "TMath.h"
+#include "TSystem.h"
 #include <algorithm>
 #include <vector>
 
@@ -24,6 +25,14 @@ PandaAnalyzer::PandaAnalyzer(int debug_/*=0*/) {
   flags["applyJSON"]      = true;
   flags["genOnly"]        = false;
   flags["pfCands"]        = false;
+  flags["recalcECF"]      = false;
+  flags["constituents"]   = false;
+  flags["halfConstituents"] = false;
+  flags["fixedArrays"]    = false;
+  flags["reducedPrecision"] = false;
+  flags["ghostConstituents"] = false;
+  flags["validatePrecision"] = false;
+  flags["columnPreselection"] = false;
   if (DEBUG) PDebug("PandaAnalyzer::PandaAnalyzer","Called constructor");
 }
 
@@ -33,6 +42,14 @@ PandaAnalyzer::~PandaAnalyzer() {
 }
 
 
+void PandaAnalyzer::SetECFBetas(std::vector<double> betas) {
+  // the upstream ECFs only exist for the default betas, so recompute
+  gt->SetECFBetas(betas);
+  ibetas = gt->get_ibetas();
+  flags["recalcECF"] = true;
+}
+
+
 void PandaAnalyzer::ResetBranches() {
   genObjects.clear();
   matchPhos.clear();
@@ -43,15 +60,24 @@ void PandaAnalyzer::ResetBranches() {
 }
 
 
-void PandaAnalyzer::SetOutputFile(TString fOutName) {
+void PandaAnalyzer::SetOutputFile(TString fOutName, TString profile) {
   fOut = new TFile(fOutName,"RECREATE");
   tOut = new TTree("events","events");
 
+  if (gt->SetOutputProfile(profile) && profile!="default")
+    fOut->SetCompressionSettings(gt->GetCompression());
+
   fOut->WriteTObject(hDTotalMCWeight);    
 
   gt->monohiggs = flags["monohiggs"];
+  gt->fixedArrays = flags["fixedArrays"]; // jet arrays padded to NJET, as in older skims
   gt->vbf       = flags["vbf"];
   gt->fatjet    = flags["fatjet"];
+  gt->constituents = flags["fatjet"] && flags["constituents"];
+  gt->halfConstituents = flags["halfConstituents"];
+  // the @precision families of GeneralTree.cfg are stored as Float16_t only on request
+  gt->EnablePrecision(flags["reducedPrecision"]);
+  gt->SetPrecisionValidation(flags["validatePrecision"]);
 
   // fill the signal weights
   for (auto& id : wIDs) 
@@ -59,6 +85,10 @@ void PandaAnalyzer::SetOutputFile(TString fOutName) {
 
   // Build the input tree here 
   gt->WriteTree(tOut);
+  if (ntupleOutput)
+    ntupleOutput = gt->StartNTupleOutput(fOut);
+  else if (nWriterRows>0)
+    gt->StartAsyncWriter(nWriterRows);
 
   if (DEBUG) PDebug("PandaAnalyzer::SetOutputFile","Created output in "+fOutName);
 }
@@ -75,25 +105,38 @@ int PandaAnalyzer::Init(TTree *t, TH1D *hweights, TTree *weightNames)
 
   event.setStatus(*t, {"!*"}); // turn everything off first
 
+  if (flags["genOnly"] && isData) {
+    PError("PandaAnalyzer::Init","genOnly cannot run on data!");
+    return 4;
+  }
+
   TString jetname = (flags["puppi"]) ? "puppi" : "chs";
-  panda::utils::BranchList readlist({"runNumber", "lumiNumber", "eventNumber", "rho", 
-                                     "isData", "npv", "npvTrue", "weight", "chsAK4Jets", 
-                                     "electrons", "muons", "taus", "photons", 
-                                     "pfMet", "caloMet", "puppiMet", "rawMet", 
-                                     "recoil","metFilters","genMet",});
+  panda::utils::BranchList readlist;
   readlist.setVerbosity(0);
 
-  if (flags["fatjet"])
-   readlist += {jetname+"CA15Jets", "subjets", jetname+"CA15Subjets","Subjets"};
-  
-  if (flags["pfCands"])
-    readlist.push_back("pfCandidates");
-
-  if (isData) {
-    readlist.push_back("triggers");
+  if (flags["genOnly"]) {
+    readlist += {"runNumber", "lumiNumber", "eventNumber", "weight",
+                 "genParticles", "genReweight"};
   } else {
-   readlist.push_back("genParticles");
-   readlist.push_back("genReweight");
+    readlist += {"runNumber", "lumiNumber", "eventNumber", "rho", 
+                 "isData", "npv", "npvTrue", "weight", "chsAK4Jets", 
+                 "electrons", "muons", "taus", "photons", 
+                 "pfMet", "caloMet", "puppiMet", "rawMet", 
+                 "recoil","metFilters","genMet",};
+
+    if (flags["fatjet"])
+     readlist += {jetname+"CA15Jets", "subjets", jetname+"CA15Subjets","Subjets"};
+    
+    if (flags["pfCands"] || flags["recalcECF"] || flags["constituents"] ||
+        (!isData && flags["ghostConstituents"]))
+      readlist.push_back("pfCandidates");
+
+    if (isData) {
+      readlist.push_back("triggers");
+    } else {
+     readlist.push_back("genParticles");
+     readlist.push_back("genReweight");
+    }
   }
 
 
@@ -130,58 +173,435 @@ int PandaAnalyzer::Init(TTree *t, TH1D *hweights, TTree *weightNames)
     gt->RemoveBranches(droppable,{"sf_phoPurity"});
   }
   if (flags["genOnly"]) {
-    std::vector<TString> keepable = {"mcWeight","scale","scaleUp",
-                                     "scaleDown","pdf*","gen*","fj1*",
-                                     "nFatjet","sf_tt*","sf_qcdTT*"};
+    std::vector<TString> keepable = {"runNumber","lumiNumber","eventNumber",
+                                     "mcWeight","scale","scaleUp",
+                                     "scaleDown","pdf*","gen*","trueGenBosonPt",
+                                     "fj1Gen","fj1IsMatched","fj1IsWMatched",
+                                     "sf_tt*","sf_qcdTT*","sf_qcdV","sf_ewkV","rw_"};
     gt->RemoveBranches({".*"},keepable);
+    // nothing below is needed for the gen-only engine
+    if (DEBUG) PDebug("PandaAnalyzer::Init","Finished gen-only configuration");
+    return 0;
   }
 
+  double radius = 1.5;
   if (!flags["fatjet"]) {
     gt->RemoveBranches({"fj1.*"});
   } else if (flags["pfCands"]) {
-    int activeAreaRepeats = 1;
-    double ghostArea = 0.01;
     double ghostEtaMax = 7.0;
-    double radius = 1.5;
     double sdZcut = 0.15;
     double sdBeta = 1.;
     activeArea = new fastjet::GhostedAreaSpec(ghostEtaMax,activeAreaRepeats,ghostArea);
     areaDef = new fastjet::AreaDefinition(fastjet::active_area_explicit_ghosts,*activeArea);
     jetDef = new fastjet::JetDefinition(fastjet::cambridge_algorithm,radius);
-    softDrop = new fastjet::contrib::SoftDrop(sdBeta,sdZcut,radius);
+    // the first grooming point defines fj1NSDConst and fj1SDEFrac100
+    groomPoints.insert(groomPoints.begin(),std::make_pair(sdBeta,sdZcut));
+    if (groomPoints.size()>NGROOM) {
+      PError("PandaAnalyzer::Init",TString::Format("Only keeping the first %i grooming points",NGROOM));
+      groomPoints.resize(NGROOM);
+    }
   } else { 
-    std::vector<TString> droppable = {"fj1NConst","fj1NSDConst","fj1EFrac100","fj1SDEFrac100"};
+    std::vector<TString> droppable = {"fj1NConst","fj1NSDConst","fj1EFrac100","fj1SDEFrac100",
+                                      "fjNConst","fjNSDConst","fjEFrac100","fjSDEFrac100",
+                                      "fj1Groom","fj1Lund"};
     gt->RemoveBranches(droppable);
   }
 
+  if (flags["fatjet"]) {
+    // one set of scratch objects per thread running the fatjet substructure.
+    // the event-wide clustering is shared by all fatjets, and copying its
+    // PseudoJets from several threads races on their reference counts
+    int nWorkers = std::max(1,std::min(nThreads,NFATJET));
+    if (nWorkers>1 && flags["pfCands"] && reclusterMode==kReclusterEvent) {
+      PError("PandaAnalyzer::Init","The substructure runs in one thread when reclustering the whole event");
+      nWorkers = 1;
+    }
+    for (int iW=0; iW!=nWorkers; ++iW) {
+      FatjetWorker *w = new FatjetWorker(radius, flags["pfCands"] ? 4000 : 0);
+      if (flags["recalcECF"]) {
+        w->ecfCalc = new ECFCalculator(gt->get_betas(),
+                                       *std::max_element(Ns.begin(),Ns.end()),
+                                       *std::max_element(orders.begin(),orders.end()));
+        w->ecfCalc->SetTopK(ecfTopK);
+      }
+      fjWorkers.push_back(w);
+    }
+    if (nWorkers>1) {
+      if (flags["pfCands"])
+        fastjet::ClusterSequence::print_banner(); // the first call is not thread-safe
+      fjPool = new WorkerPool(nWorkers);
+    }
+  }
+
+  if (flags["fatjet"] && flags["constituents"] && constituentFile!="") {
+    constWriter = new NumpyWriter();
+    if (!constWriter->Open(constituentFile,{NCONST,nConstFeatures},flags["halfConstituents"]))
+      return 3;
+    constRecord.resize(NCONST*nConstFeatures);
+  }
+
   if (DEBUG) PDebug("PandaAnalyzer::Init","Finished configuration");
 
   return 0;
 }
 
 
+void PandaAnalyzer::BuildGenGrids() {
+  // ids follow the map order, so MatchToGen picks the same object as a scan of genObjects
+  genObjList.clear();
+  genObjGrid.Clear();
+  for (auto &iG : genObjects) {
+    genObjGrid.Add(iG.first->eta(),iG.first->phi(),genObjList.size());
+    genObjList.push_back(iG.first);
+  }
+  genObjGrid.Build();
+}
+
+
 panda::GenParticle const *PandaAnalyzer::MatchToGen(double eta, double phi, double radius, int pdgid) {
-  panda::GenParticle const* found=NULL;
-  double r2 = radius*radius;
   pdgid = abs(pdgid);
 
-  unsigned int counter=0;
-  for (map<panda::GenParticle const*,float>::iterator iG=genObjects.begin();
-      iG!=genObjects.end(); ++iG) {
-    if (found!=NULL)
-      break;
-    if (pdgid!=0 && abs(iG->first->pdgid)!=pdgid)
+  genObjGrid.Query(eta,phi,radius*radius,gridHits);
+  for (auto iG : gridHits) {
+    panda::GenParticle const *part = genObjList[iG];
+    if (pdgid!=0 && abs(part->pdgid)!=pdgid)
       continue;
-    if (DeltaR2(eta,phi,iG->first->eta(),iG->first->phi())<r2)
-      found = iG->first;
+    return part;
+  }
+
+  return NULL;
+}
+
+
+void PandaAnalyzer::FatjetBasics(unsigned iFJ, panda::FatJet &fj,
+                                 FactorizedJetCorrector *scaleReaderAK4, JetCorrectionUncertainty *uncReaderAK4) {
+  // uses the shared JEC readers, so this is not run in the worker threads
+  float pt = fj.pt();
+  float eta = fj.eta();
+  gt->fjPt[iFJ] = pt;
+  gt->fjEta[iFJ] = eta;
+  gt->fjPhi[iFJ] = fj.phi();
+  gt->fjM[iFJ] = fj.m();
+  gt->fjMSD[iFJ] = fj.mSD;
+  gt->fjRawPt[iFJ] = fj.rawPt;
+  float msd = gt->fjMSD[iFJ];
+
+  // do a bit of jet energy scaling
+  // uncReader->setJetEta(eta); uncReader->setJetPt(pt);
+  // double scaleUnc = uncReader->getUncertainty(true);
+  double scaleUnc = (fj.ptCorrUp - gt->fjPt[iFJ]) / gt->fjPt[iFJ]; 
+  gt->fjPtScaleUp[iFJ]    = pt  * (1 + 2*scaleUnc);
+  gt->fjPtScaleDown[iFJ]  = pt  * (1 - 2*scaleUnc);
+  gt->fjMSDScaleUp[iFJ]   = msd * (1 + 2*scaleUnc);
+  gt->fjMSDScaleDown[iFJ] = msd * (1 - 2*scaleUnc);
+
+  // do some jet energy smearing
+  if (isData) {
+    gt->fjPtSmeared[iFJ] = pt;
+    gt->fjPtSmearedUp[iFJ] = pt;
+    gt->fjPtSmearedDown[iFJ] = pt;
+    gt->fjMSDSmeared[iFJ] = msd;
+    gt->fjMSDSmearedUp[iFJ] = msd;
+    gt->fjMSDSmearedDown[iFJ] = msd;
+  } else {
+    double smear=1, smearUp=1, smearDown=1;
+    ak8JERReader->getStochasticSmear(pt,eta,event.rho,smear,smearUp,smearDown);
+
+    gt->fjPtSmeared[iFJ] = smear*pt;
+    gt->fjPtSmearedUp[iFJ] = smearUp*pt;
+    gt->fjPtSmearedDown[iFJ] = smearDown*pt;
+
+    gt->fjMSDSmeared[iFJ] = smear*msd;
+    gt->fjMSDSmearedUp[iFJ] = smearUp*msd;
+    gt->fjMSDSmearedDown[iFJ] = smearDown*msd;
+  }
+
+  // now have to do this mess with the subjets...
+  if (doSubjetJES) {
+    TLorentzVector sjSum, sjSumUp, sjSumDown, sjSumSmear;
+    for (unsigned int iSJ=0; iSJ!=fj.subjets.size(); ++iSJ) {
+      auto& subjet = fj.subjets.objAt(iSJ);
+      // now correct...
+      double factor=1;
+      if (fabs(subjet.eta())<5.191) {
+        scaleReaderAK4->setJetPt(subjet.pt());
+        scaleReaderAK4->setJetEta(subjet.eta());
+        scaleReaderAK4->setJetPhi(subjet.phi());
+        scaleReaderAK4->setJetE(subjet.e());
+        scaleReaderAK4->setRho(event.rho);
+        scaleReaderAK4->setJetA(0);
+        scaleReaderAK4->setJetEMF(-99.0);
+        factor = scaleReaderAK4->getCorrection();
+      }
+      TLorentzVector vCorr = factor * subjet.p4();
+      sjSum += vCorr;
+      double corr_pt = vCorr.Pt();
+
+      // now vary
+      uncReaderAK4->setJetEta(subjet.eta()); uncReaderAK4->setJetPt(corr_pt);
+      double sjScaleUnc = uncReaderAK4->getUncertainty(true);
+      sjSumUp += (1 + 2*sjScaleUnc) * vCorr;
+      sjSumDown += (1 - 2*sjScaleUnc) * vCorr;
+
+      // now smear...
+      double smear=1, smearUp=1, smearDown=1;
+      ak4JERReader->getStochasticSmear(corr_pt,subjet.eta(),event.rho,smear,smearUp,smearDown);
+      sjSumSmear += smear * vCorr;
+    }
+    gt->fjPtScaleUp_sj[iFJ] = pt * (sjSumUp.Pt()/sjSum.Pt());
+    gt->fjPtScaleDown_sj[iFJ] = pt * (sjSumDown.Pt()/sjSum.Pt());
+    gt->fjPtSmeared_sj[iFJ] = pt * (sjSumSmear.Pt()/sjSum.Pt());
+    gt->fjMSDScaleUp_sj[iFJ] = msd * (sjSumUp.Pt()/sjSum.Pt());
+    gt->fjMSDScaleDown_sj[iFJ] = msd * (sjSumDown.Pt()/sjSum.Pt());
+    gt->fjMSDSmeared_sj[iFJ] = msd * (sjSumSmear.Pt()/sjSum.Pt());
+  }
+
+  // mSD correction
+  float corrweight=1.;
+  corrweight = GetMSDCorr(pt,eta);
+  gt->fjMSD_corr[iFJ] = corrweight*msd;
+
+  // now we do substructure
+  gt->fjTau32[iFJ] = clean(fj.tau3/fj.tau2);
+  gt->fjTau32SD[iFJ] = clean(fj.tau3SD/fj.tau2SD);
+  gt->fjTau21[iFJ] = clean(fj.tau2/fj.tau1);
+  gt->fjTau21SD[iFJ] = clean(fj.tau2SD/fj.tau1SD);
+  gt->fjHTTMass[iFJ] = fj.htt_mass;
+  gt->fjHTTFRec[iFJ] = fj.htt_frec;
+
+  std::vector<panda::MicroJet const*> subjets;
+  for (unsigned iS(0); iS != fj.subjets.size(); ++iS)
+   subjets.push_back(&fj.subjets.objAt(iS));
+
+  auto csvsort([](panda::MicroJet const* j1, panda::MicroJet const* j2)->bool {
+    return j1->csv > j2->csv;
+   });
+
+  std::sort(subjets.begin(),subjets.end(),csvsort);
+  if (subjets.size()>0) {
+    gt->fjMaxCSV[iFJ] = subjets.at(0)->csv;
+    gt->fjMinCSV[iFJ] = subjets.back()->csv;
+    if (subjets.size()>1) {
+      gt->fjSubMaxCSV[iFJ] = subjets.at(1)->csv;
+    }
+  }
+  gt->fjDoubleCSV[iFJ] = fj.double_sub;
+}
+
+
+void PandaAnalyzer::RunFatjetSubstructure(std::vector<panda::FatJet*> &selFatjets) {
+  unsigned nFJ = selFatjets.size();
+  if (nFJ==0)
+    return;
+
+  // read the flags here, the map is not touched by the workers
+  bool puppi = flags["puppi"];
+  bool recluster = flags["pfCands"];
+
+  // in event mode the clustering is shared by all fatjets
+  fastjet::ClusterSequenceArea *eventSeq=0;
+  if (recluster && reclusterMode==kReclusterEvent) {
+    VPseudoJet &particles = fjWorkers[0]->arena.particles;
+    ConvertPFCands(event.pfCandidates,puppi,particles,0);
+    eventSeq = new fastjet::ClusterSequenceArea(particles,*jetDef,*areaDef);
   }
 
-  return found;
+  // jets are distributed round-robin, each worker only writes its own indices
+  unsigned nWorkers = std::min(nFJ,(unsigned)fjWorkers.size());
+  auto work = [this,&selFatjets,eventSeq,nWorkers,nFJ,puppi,recluster](unsigned iW) {
+    for (unsigned iFJ=iW; iFJ<nFJ; iFJ+=nWorkers)
+      FatjetSubstructure(iFJ,*(selFatjets[iFJ]),*(fjWorkers[iW]),eventSeq,puppi,recluster);
+  };
+  if (fjPool)
+    fjPool->Run(nWorkers,work);
+  else
+    work(0);
+
+  delete eventSeq;
+}
+
+
+void PandaAnalyzer::FatjetSubstructure(unsigned iFJ, panda::FatJet &fj, FatjetWorker &w, 
+                                       const fastjet::ClusterSequence *eventSeq, bool puppi, bool recluster) {
+  // may run in a worker thread: only touch w and index iFJ of the output arrays
+  if (doECFs) {
+    if (w.ecfCalc)
+      w.ecfCalc->Compute(fj.constituents,puppi);
+    for (auto ibeta : ibetas) {
+      for (auto N : Ns) {
+        for (auto order : orders) {
+          float ecf = (w.ecfCalc) ? w.ecfCalc->Get(order,N,ibeta) : fj.get_ecf(order,N,ibeta);
+          gt->fjECFNs[GeneralTree::ECFIndex(order,N,ibeta)][iFJ] = ecf;
+        }
+      }
+    } //loop over betas
+  }
+
+  if (!recluster)
+    return;
+
+  const fastjet::ClusterSequence *seq = eventSeq;
+  fastjet::ClusterSequenceArea *localSeq = 0;
+  if (!seq) {
+    VPseudoJet &particles = w.arena.particles;
+    if (reclusterMode==kReclusterConstituents) {
+      ConvertPFCands(fj.constituents,puppi,particles,0);
+    } else {
+      std::vector<const panda::PFCand*> &coneCands = w.arena.cands;
+      coneCands.clear();
+      double maxDR2 = reclusterConeDR*reclusterConeDR;
+      for (auto &cand : event.pfCandidates) {
+        if (DeltaR2(cand.eta(),cand.phi(),fj.eta(),fj.phi())<maxDR2)
+          coneCands.push_back(&cand);
+      }
+      ConvertPFCands(coneCands,puppi,particles,0);
+    }
+    // only put ghosts in the region around the fatjet. each jet has its own
+    // ghost generator, seeded by event and jet, so the result does not depend
+    // on which worker runs it
+    fastjet::Selector ghostSel = fastjet::SelectorCircle(reclusterConeDR);
+    ghostSel.set_reference(fastjet::PtYPhiM(fj.pt(),fj.eta(),fj.phi()));
+    fastjet::GhostedAreaSpec ghostSpec(ghostSel,activeAreaRepeats,ghostArea);
+    ghostSpec.set_random_status({int(event.eventNumber%2147483629)+1,int(iFJ)+1});
+    fastjet::AreaDefinition seqAreaDef(fastjet::active_area_explicit_ghosts,ghostSpec);
+    localSeq = new fastjet::ClusterSequenceArea(particles,*jetDef,seqAreaDef);
+    seq = localSeq;
+  }
+
+  // walk the history for the final jets instead of copying out inclusive_jets()
+  const VPseudoJet &seqJets = seq->jets();
+  const std::vector<fastjet::ClusterSequence::history_element> &seqHistory = seq->history();
+  const fastjet::PseudoJet *pj=0;
+  double minDR2 = 999;
+  for (auto &step : seqHistory) {
+    if (step.parent2!=fastjet::ClusterSequence::BeamJet)
+      continue;
+    const fastjet::PseudoJet &jet = seqJets[seqHistory[step.parent1].jetp_index];
+    double dr2 = DeltaR2(jet.eta(),jet.phi_std(),fj.eta(),fj.phi());
+    if (dr2<minDR2) {
+      minDR2 = dr2;
+      pj = &jet;
+    }
+  }
+  if (pj) {
+    VPseudoJet &constituents = w.arena.constituents;
+    FillConstituents(*pj,constituents);
+    gt->fjNConst[iFJ] = constituents.size();
+    gt->fjEFrac100[iFJ] = LeadingEFraction(constituents,100);
+
+    // all grooming and the Lund plane come from one declustering
+    JetDeclusterer &declust = w.declust;
+    declust.Build(*pj);
+    if (iFJ==0) {
+      unsigned nGroom = groomPoints.size();
+      gt->nfj1Groom = nGroom;
+      for (unsigned iG=0; iG!=nGroom; ++iG) {
+        unsigned iStep = declust.SoftDropStep(groomPoints[iG].first,groomPoints[iG].second);
+        const fastjet::PseudoJet &groomed = declust.GetParent(iStep);
+        gt->fj1GroomM[iG] = groomed.m();
+        gt->fj1GroomPt[iG] = groomed.perp();
+        if (iStep<declust.GetNSteps()) {
+          gt->fj1GroomZg[iG] = declust.GetStep(iStep).z;
+          gt->fj1GroomRg[iG] = declust.GetStep(iStep).dR;
+        } else {
+          gt->fj1GroomZg[iG] = 0;
+          gt->fj1GroomRg[iG] = 0;
+        }
+      }
+
+      unsigned nLund = std::min(declust.GetNSteps(),(unsigned)NLUND);
+      gt->nfj1Lund = nLund;
+      for (unsigned iL=0; iL!=nLund; ++iL) {
+        const JetDeclusterer::Step &step = declust.GetStep(iL);
+        gt->fj1LundLnInvDR[iL] = -log(step.dR);
+        gt->fj1LundLnKt[iL] = log(step.kt);
+        gt->fj1LundZ[iL] = step.z;
+      }
+    }
+
+    const fastjet::PseudoJet &sdJet = declust.SoftDrop(groomPoints[0].first,groomPoints[0].second);
+    VPseudoJet &sdConstituents = w.arena.sdConstituents;
+    FillConstituents(sdJet,sdConstituents);
+    gt->fjNSDConst[iFJ] = sdConstituents.size();
+    gt->fjSDEFrac100[iFJ] = LeadingEFraction(sdConstituents,100);
+  }
+
+  delete localSeq;
+}
+
+
+void PandaAnalyzer::FillConstituentArrays(panda::FatJet &fj) {
+  bool puppi = flags["puppi"];
+  constSort.clear();
+  double ptSum = 0;
+  for (auto &&ref : fj.constituents) {
+    const panda::PFCand *pf = PFCandPtr(ref);
+    float pt = (puppi ? pf->puppiW() : 1) * pf->pt();
+    if (pt<=0)
+      continue;
+    constSort.emplace_back(pt,pf);
+    ptSum += pt;
+  }
+  unsigned nC = std::min((unsigned)constSort.size(),(unsigned)NCONST);
+  std::partial_sort(constSort.begin(),constSort.begin()+nC,constSort.end(),
+                    [](const std::pair<float,const panda::PFCand*> &a,
+                       const std::pair<float,const panda::PFCand*> &b)->bool {
+                      return a.first > b.first;
+                    });
+
+  gt->nfj1Const = nC;
+  for (unsigned iC=0; iC!=nC; ++iC) {
+    const panda::PFCand *pf = constSort[iC].second;
+    gt->fj1ConstPtFrac[iC] = constSort[iC].first/ptSum;
+    gt->fj1ConstDEta[iC] = pf->eta()-fj.eta();
+    gt->fj1ConstDPhi[iC] = TVector2::Phi_mpi_pi(pf->phi()-fj.phi());
+    gt->fj1ConstPuppiW[iC] = pf->puppiW();
+    gt->fj1ConstCharge[iC] = pf->q();
+    gt->fj1ConstPdgId[iC] = pf->pdgId();
+  }
+}
+
+
+void PandaAnalyzer::WriteConstituentRecord() {
+  // one (NCONST x nConstFeatures) record per output event, row-major
+  for (unsigned iC=0; iC!=NCONST; ++iC) {
+    float *row = constRecord.data()+iC*nConstFeatures;
+    row[0] = gt->fj1ConstPtFrac[iC];
+    row[1] = gt->fj1ConstDEta[iC];
+    row[2] = gt->fj1ConstDPhi[iC];
+    row[3] = gt->fj1ConstPuppiW[iC];
+    row[4] = gt->fj1ConstCharge[iC];
+    row[5] = gt->fj1ConstPdgId[iC];
+  }
+  constWriter->Write(constRecord.data());
 }
 
 
 void PandaAnalyzer::Terminate() {
-  fOut->WriteTObject(tOut);
+  delete columns; columns=0;
+  gt->FinishWriting();
+  if (!gt->HasNTuple()) {
+    tOut->FlushBaskets();
+    gt->PrintBranchSizes();
+    gt->PrintPrecisionReport();
+    fOut->WriteTObject(tOut);
+  }
+
+  // index of the fj1Groom arrays; written here because Init prepends the
+  // default soft drop and truncates the list to NGROOM
+  if (flags["pfCands"] && flags["fatjet"]) {
+    fOut->cd();
+    TTree *tGroom = new TTree("groomingPoints","groomingPoints");
+    double beta, zcut;
+    tGroom->Branch("beta",&beta,"beta/D");
+    tGroom->Branch("zcut",&zcut,"zcut/D");
+    for (auto &gp : groomPoints) {
+      beta = gp.first; zcut = gp.second;
+      tGroom->Fill();
+    }
+    fOut->WriteTObject(tGroom);
+    delete tGroom;
+  }
   fOut->Close();
 
   for (auto *f : fCorrs)
@@ -209,11 +629,27 @@ void PandaAnalyzer::Terminate() {
     delete iter.second;
 
   delete ak4JERReader;
+  delete ak4chsJERReader;
+  delete jetCorr;
 
   delete activeArea;
   delete areaDef;
   delete jetDef;
-  delete softDrop;
+  delete fjPool;
+  fjPool = 0;
+  for (auto *w : fjWorkers)
+    delete w;
+  if (constWriter) {
+    constWriter->Close();
+    PInfo("PandaAnalyzer::Terminate",
+          TString::Format("Wrote %lu constituent records to ",constWriter->GetNRecords())+constituentFile);
+  }
+  delete constWriter;
+
+  if (triggerMenu.GetNPaths()>0) {
+    for (auto &path : triggerMenu.GetDeadPaths())
+      PInfo("PandaAnalyzer::Terminate","Trigger never fired: "+path);
+  }
 
   delete hDTotalMCWeight;
   if (DEBUG) PDebug("PandaAnalyzer::Terminate","Finished with output");
@@ -239,12 +675,62 @@ double PandaAnalyzer::GetCorr(CorrectionType ct, double x, double y) {
   }
 }
 
+void PandaAnalyzer::LoadKFactors(TString dirPath) {
+  // kfactors
+  TFile *fKFactor = new TFile(dirPath+"kfactors.root"); 
+  fCorrs[cZNLO] = fKFactor; // just for garbage collection
+
+  TH1D *hZLO    = (TH1D*)fKFactor->Get("ZJets_LO/inv_pt");
+  TH1D *hWLO    = (TH1D*)fKFactor->Get("WJets_LO/inv_pt");
+  TH1D *hALO    = (TH1D*)fKFactor->Get("GJets_LO/inv_pt_G");
+
+  h1Corrs[cZNLO] = new THCorr1((TH1D*)fKFactor->Get("ZJets_012j_NLO/nominal"));
+  h1Corrs[cWNLO] = new THCorr1((TH1D*)fKFactor->Get("WJets_012j_NLO/nominal"));
+  h1Corrs[cANLO] = new THCorr1((TH1D*)fKFactor->Get("GJets_1j_NLO/nominal_G"));
+
+  h1Corrs[cZEWK] = new THCorr1((TH1D*)fKFactor->Get("EWKcorr/Z"));
+  h1Corrs[cWEWK] = new THCorr1((TH1D*)fKFactor->Get("EWKcorr/W"));
+  h1Corrs[cAEWK] = new THCorr1((TH1D*)fKFactor->Get("EWKcorr/photon"));
+
+  h1Corrs[cZEWK]->GetHist()->Divide(h1Corrs[cZNLO]->GetHist());     
+  h1Corrs[cWEWK]->GetHist()->Divide(h1Corrs[cWNLO]->GetHist());     
+  h1Corrs[cAEWK]->GetHist()->Divide(h1Corrs[cANLO]->GetHist());
+
+  h1Corrs[cZNLO]->GetHist()->Divide(hZLO);    
+  h1Corrs[cWNLO]->GetHist()->Divide(hWLO);    
+  h1Corrs[cANLO]->GetHist()->Divide(hALO);
+
+  OpenCorrection(cANLO2j,dirPath+"moriond17/histo_photons_2jet.root","Func",1);
+
+  if (DEBUG) PDebug("PandaAnalyzer::LoadKFactors","Loaded k factors");
+
+  TFile *fKFactor_VBFZ = new TFile(dirPath+"vbf_kfactors/kfactor_VBF_zjets.root");
+  h1Corrs[cVBF_ZNLO] = new THCorr1((TH1D*)fKFactor_VBFZ->Get("bosonPt_NLO_vbf"));
+  h1Corrs[cVBF_ZNLO]->GetHist()->Divide((TH1D*)fKFactor_VBFZ->Get("bosonPt_LO_vbf"));
+
+  TFile *fKFactor_VBFW = new TFile(dirPath+"vbf_kfactors/kfactor_VBF_wjets.root");
+  h1Corrs[cVBF_WNLO] = new THCorr1((TH1D*)fKFactor_VBFW->Get("bosonPt_NLO_vbf"));
+  h1Corrs[cVBF_WNLO]->GetHist()->Divide((TH1D*)fKFactor_VBFW->Get("bosonPt_LO_vbf"));
+
+  OpenCorrection(cVBF_EWKZ,dirPath+"vbf_kfactors/kFactor_ZToNuNu_pT_Mjj_2D.root",
+                 "TH2F_kFactor",2);
+  OpenCorrection(cVBF_EWKW,dirPath+"vbf_kfactors/kFactor_WToLNu_pT_Mjj_2D.root",
+                 "TH2F_kFactor",2);
+
+  if (DEBUG) PDebug("PandaAnalyzer::LoadKFactors","Loaded VBF k factors");
+}
+
+
 void PandaAnalyzer::SetDataDir(const char *s) {
   TString dirPath(s);
   dirPath += "/";
 
   if (DEBUG) PDebug("PandaAnalyzer::SetDataDir","Starting loading of data");
 
+  LoadKFactors(dirPath);
+  if (flags["genOnly"])
+    return; // the k-factors are the only corrections used at gen level
+
   // pileup
   OpenCorrection(cNPV,dirPath+"moriond17/normalized_npv.root","data_npv_Wmn",1);
   OpenCorrection(cPU,dirPath+"moriond17/puWeights_80x_37ifb.root","puWeights",1);
@@ -283,49 +769,6 @@ void PandaAnalyzer::SetDataDir(const char *s) {
 
   if (DEBUG) PDebug("PandaAnalyzer::SetDataDir","Loaded scale factors");
 
-  // kfactors
-  TFile *fKFactor = new TFile(dirPath+"kfactors.root"); 
-  fCorrs[cZNLO] = fKFactor; // just for garbage collection
-
-  TH1D *hZLO    = (TH1D*)fKFactor->Get("ZJets_LO/inv_pt");
-  TH1D *hWLO    = (TH1D*)fKFactor->Get("WJets_LO/inv_pt");
-  TH1D *hALO    = (TH1D*)fKFactor->Get("GJets_LO/inv_pt_G");
-
-  h1Corrs[cZNLO] = new THCorr1((TH1D*)fKFactor->Get("ZJets_012j_NLO/nominal"));
-  h1Corrs[cWNLO] = new THCorr1((TH1D*)fKFactor->Get("WJets_012j_NLO/nominal"));
-  h1Corrs[cANLO] = new THCorr1((TH1D*)fKFactor->Get("GJets_1j_NLO/nominal_G"));
-
-  h1Corrs[cZEWK] = new THCorr1((TH1D*)fKFactor->Get("EWKcorr/Z"));
-  h1Corrs[cWEWK] = new THCorr1((TH1D*)fKFactor->Get("EWKcorr/W"));
-  h1Corrs[cAEWK] = new THCorr1((TH1D*)fKFactor->Get("EWKcorr/photon"));
-
-  h1Corrs[cZEWK]->GetHist()->Divide(h1Corrs[cZNLO]->GetHist());     
-  h1Corrs[cWEWK]->GetHist()->Divide(h1Corrs[cWNLO]->GetHist());     
-  h1Corrs[cAEWK]->GetHist()->Divide(h1Corrs[cANLO]->GetHist());
-
-  h1Corrs[cZNLO]->GetHist()->Divide(hZLO);    
-  h1Corrs[cWNLO]->GetHist()->Divide(hWLO);    
-  h1Corrs[cANLO]->GetHist()->Divide(hALO);
-
-  OpenCorrection(cANLO2j,dirPath+"moriond17/histo_photons_2jet.root","Func",1);
-
-  if (DEBUG) PDebug("PandaAnalyzer::SetDataDir","Loaded k factors");
-
-  TFile *fKFactor_VBFZ = new TFile(dirPath+"vbf_kfactors/kfactor_VBF_zjets.root");
-  h1Corrs[cVBF_ZNLO] = new THCorr1((TH1D*)fKFactor_VBFZ->Get("bosonPt_NLO_vbf"));
-  h1Corrs[cVBF_ZNLO]->GetHist()->Divide((TH1D*)fKFactor_VBFZ->Get("bosonPt_LO_vbf"));
-
-  TFile *fKFactor_VBFW = new TFile(dirPath+"vbf_kfactors/kfactor_VBF_wjets.root");
-  h1Corrs[cVBF_WNLO] = new THCorr1((TH1D*)fKFactor_VBFW->Get("bosonPt_NLO_vbf"));
-  h1Corrs[cVBF_WNLO]->GetHist()->Divide((TH1D*)fKFactor_VBFW->Get("bosonPt_LO_vbf"));
-
-  OpenCorrection(cVBF_EWKZ,dirPath+"vbf_kfactors/kFactor_ZToNuNu_pT_Mjj_2D.root",
-                 "TH2F_kFactor",2);
-  OpenCorrection(cVBF_EWKW,dirPath+"vbf_kfactors/kFactor_WToLNu_pT_Mjj_2D.root",
-                 "TH2F_kFactor",2);
-
-  if (DEBUG) PDebug("PandaAnalyzer::SetDataDir","Loaded VBF k factors");
-
   // btag SFs
   btagCalib = new BTagCalibration("csvv2",(dirPath+"moriond17/CSVv2_Moriond17_B_H.csv").Data());
   btagReaders[bJetL] = new BTagCalibrationReader(BTagEntry::OP_LOOSE,"central",{"up","down"});
@@ -382,6 +825,23 @@ void PandaAnalyzer::SetDataDir(const char *s) {
   ak4JERReader = new JERReader(dirPath+"/jec/25nsV10/Spring16_25nsV10_MC_SF_AK4PFPuppi.txt",
                                dirPath+"/jec/25nsV10/Spring16_25nsV10_MC_PtResolution_AK4PFPuppi.txt");
 
+  // the input jets are already corrected, so only the variations are propagated to MET
+  jetCorr = new JetCorrector();
+  jetCorr->makeJets = false;
+  jetCorr->minMetJetPt = 15;
+  // the met shifts smear chsAK4Jets, so they need the CHS resolution, not
+  // the Puppi one used for the CA15 subjets
+  TString chsJERSF = dirPath+"/jec/25nsV10/Spring16_25nsV10_MC_SF_AK4PFchs.txt";
+  TString chsJERRes = dirPath+"/jec/25nsV10/Spring16_25nsV10_MC_PtResolution_AK4PFchs.txt";
+  if (gSystem->AccessPathName(chsJERSF) || gSystem->AccessPathName(chsJERRes)) {
+    PWarning("PandaAnalyzer::SetDataDir",
+             "No AK4PFchs JER files in "+dirPath+"/jec/25nsV10, the pf met JER shifts use AK4PFPuppi");
+    jetCorr->SetJER(ak4JERReader);
+  } else {
+    ak4chsJERReader = new JERReader(chsJERSF,chsJERRes);
+    jetCorr->SetJER(ak4chsJERReader);
+  }
+
   std::vector<JetCorrectorParameters> params = {
     JetCorrectorParameters(
       (dirPath+"/jec/"+jecVFull+"/Summer16_"+jecVFull+"_MC_L1FastJet_AK4PFPuppi.txt").Data()),
@@ -415,39 +875,15 @@ void PandaAnalyzer::SetDataDir(const char *s) {
 
 
 void PandaAnalyzer::AddGoodLumiRange(int run, int l0, int l1) {
-  auto run_ = goodLumis.find(run);
-  if (run_==goodLumis.end()) { // don't know about this run yet
-    std::vector<LumiRange> newLumiList;
-    newLumiList.emplace_back(l0,l1);
-    goodLumis[run] = newLumiList;
-  } else {
-    run_->second.emplace_back(l0,l1);
-  }
+  goodLumis.AddRange(run,l0,l1);
 }
 
 
 bool PandaAnalyzer::PassGoodLumis(int run, int lumi) {
-  auto run_ = goodLumis.find(run);
-  if (run_==goodLumis.end()) {
-    // matched no run
-    if (DEBUG) 
-      PDebug("PandaAnalyzer::PassGoodLumis",TString::Format("Failing run=%i",run));
-    return false;
-  }
-
-  // found the run, now look for a lumi range
-  for (auto &range : run_->second) {
-    if (range.Contains(lumi)) {
-      if (DEBUG) 
-        PDebug("PandaAnalyzer::PassGoodLumis",TString::Format("Accepting run=%i, lumi=%i",run,lumi));
-      return true;
-    }
-  }
-
-  // matched no lumi range
+  bool pass = goodLumis.Pass(run,lumi);
   if (DEBUG) 
-    PDebug("PandaAnalyzer::PassGoodLumis",TString::Format("Failing run=%i, lumi=%i",run,lumi));
-  return false;
+    PDebug("PandaAnalyzer::PassGoodLumis",TString::Format("%s run=%i, lumi=%i",pass ? "Accepting" : "Failing",run,lumi));
+  return pass;
 }
 
 
@@ -500,6 +936,62 @@ bool PandaAnalyzer::PassPreselection() {
   return isGood;
 }
 
+bool PandaAnalyzer::SetupColumnPreselection() {
+  // only conditions every event passing PassPreselection must satisfy:
+  // the recoil.max cut in Run, and a raw CA15 jet passing the fatjet selection
+  // when only fatjet bits are set
+  bool recoilCut = preselBits & (kMonotop|kMonohiggs|kMonojet|kRecoil);
+  bool fatjetCut = flags["fatjet"] && preselBits!=0 && (preselBits & ~(kFatjet|kMonotop))==0;
+  if (!recoilCut && !fatjetCut) {
+    PWarning("PandaAnalyzer::SetupColumnPreselection","No column cut for this preselection, reading every entry");
+    return false;
+  }
+  if (tIn->InheritsFrom("TChain") || !tIn->GetCurrentFile()) {
+    PWarning("PandaAnalyzer::SetupColumnPreselection","Column preselection needs a single input file, reading every entry");
+    return false;
+  }
+
+  columns = new ColumnReader(tIn->GetCurrentFile()->GetName(),tIn->GetName());
+  if (!columns->IsOpen())
+    return false;
+  if (recoilCut && (cRecoil = columns->AddObject("recoil",{"max"}))<0)
+    return false;
+  TString fjName = flags["puppi"] ? "puppiCA15Jets" : "chsCA15Jets";
+  if (fatjetCut && (cFatjets = columns->AddParticles(fjName,{"monojet"}))<0)
+    return false;
+
+  if (DEBUG) PDebug("PandaAnalyzer::SetupColumnPreselection",
+                    TString::Format("recoil %i, fatjets %i",cRecoil,cFatjets));
+  return true;
+}
+
+bool PandaAnalyzer::PassColumnPreselection(unsigned int iE, unsigned int nEvents) {
+  Long64_t first = columns->GetFirstEntry();
+  if (iE<first || iE>=first+columns->GetNEvents()) {
+    unsigned int last = std::min(iE+colBlockSize,nEvents);
+    unsigned int n = columns->ReadBlock(iE,last);
+    colPass.assign(n,1);
+    if (cRecoil>=0) {
+      const float *recoil = columns->Column(cRecoil,0);
+      for (unsigned int i=0; i!=n; ++i)
+        colPass[i] &= (recoil[i]>=175);
+    }
+    if (cFatjets>=0) {
+      const float *pt = columns->Column(cFatjets,0);
+      const float *eta = columns->Column(cFatjets,1);
+      const float *monojet = columns->Column(cFatjets,3);
+      for (unsigned int i=0; i!=n; ++i) {
+        char any=0;
+        for (unsigned int j=columns->Begin(cFatjets,i); j!=columns->End(cFatjets,i); ++j)
+          any |= (pt[j]>=200 && fabs(eta[j])<=2.4 && monojet[j]!=0);
+        colPass[i] &= any;
+      }
+    }
+    first = iE;
+  }
+  return colPass[iE-first];
+}
+
 
 void PandaAnalyzer::CalcBJetSFs(BTagType bt, int flavor,
                 double eta, double pt, double eff, double uncFactor,
@@ -555,12 +1047,9 @@ void PandaAnalyzer::EvalBTagSF(std::vector<btagcand> &cands, std::vector<double>
     sfGT0 = (1-prob_data0)/(1-prob_mc0);
   }
 
-  GeneralTree::BTagParams p;
-  p.shift = shift;
-  p.jet = jettype;
-  p.tag=GeneralTree::b0; gt->sf_btags[p] = sf0;
-  p.tag=GeneralTree::b1; gt->sf_btags[p] = sf1;
-  p.tag=GeneralTree::bGT0; gt->sf_btags[p] = sfGT0;
+  gt->sf_btags[GeneralTree::sf_btagsIndex(jettype,GeneralTree::b0,shift)] = sf0;
+  gt->sf_btags[GeneralTree::sf_btagsIndex(jettype,GeneralTree::b1,shift)] = sf1;
+  gt->sf_btags[GeneralTree::sf_btagsIndex(jettype,GeneralTree::bGT0,shift)] = sfGT0;
 
   if (do2) {
     float prob_mc2=0, prob_data2=0;
@@ -586,7 +1075,7 @@ void PandaAnalyzer::EvalBTagSF(std::vector<btagcand> &cands, std::vector<double>
       sf2 = prob_data2/prob_mc2;
     }
 
-    p.tag=GeneralTree::b2; gt->sf_btags[p] = sf2;
+    gt->sf_btags[GeneralTree::sf_btagsIndex(jettype,GeneralTree::b2,shift)] = sf2;
   }
 
 }
@@ -609,13 +1098,387 @@ float PandaAnalyzer::GetMSDCorr(Float_t puppipt, Float_t puppieta) {
   return totalWeight;
 }
 
-void PandaAnalyzer::RegisterTrigger(TString path, std::vector<unsigned> &idxs) {
+void PandaAnalyzer::SetMETShifts(TVector2 *shifts, float &up, float &down,
+                                 float &smeared, float &smearedUp, float &smearedDown) {
+  up          = shifts[JetCorrector::kJESUp].Mod();
+  down        = shifts[JetCorrector::kJESDown].Mod();
+  smeared     = shifts[JetCorrector::kJER].Mod();
+  smearedUp   = shifts[JetCorrector::kJERUp].Mod();
+  smearedDown = shifts[JetCorrector::kJERDown].Mod();
+}
+
+void PandaAnalyzer::RegisterTrigger(TString path, unsigned groupBit) {
   unsigned idx = event.registerTrigger(path);
   if (DEBUG>1) PDebug("PandaAnalyzer::RegisterTrigger",
             TString::Format("At %u found trigger=%s",idx,path.Data()));
-  idxs.push_back(idx);
+  triggerMenu.AddPath(groupBit,path,idx);
 }
 
+void PandaAnalyzer::ConfigureStages() {
+  // must follow SetOutputFile, so the booked branches are known.
+  // recoil shifts are also needed by the recoil preselections
+  doSubjetJES = gt->IsActive({"_sj$"});
+  doECFs = gt->IsActive({"ECFN_"});
+  doRecoilShifts = gt->IsActive({"^pfU.*magUp","^pfU.*magDown","^pfU.*magSmeared"})
+                   || (preselBits & (kRecoil|kMonojet));
+  doBTagShifts = gt->IsActive({"^sf_btag.*Up","^sf_btag.*Down"});
+  doSubjetBTagShifts = gt->IsActive({"^sf_sjbtag.*Up","^sf_sjbtag.*Down"});
+  if (DEBUG) 
+    PDebug("PandaAnalyzer::ConfigureStages",
+           TString::Format("subjetJES=%i ECFs=%i recoilShifts=%i btagShifts=%i sjBtagShifts=%i",
+                           doSubjetJES,doECFs,doRecoilShifts,doBTagShifts,doSubjetBTagShifts));
+}
+
+// gen-level pieces, shared by Run and RunGenOnly
+unsigned int PandaAnalyzer::FindGenObjects() {
+  // hadronically decaying targets of the process, and the size of their decays
+  unsigned int pdgidTarget=0;
+  if (!isData && processType>=kTT) {
+    switch(processType) {
+      case kTop:
+      case kTT:
+      case kSignal:
+        pdgidTarget=6;
+        break;
+      case kV:
+        pdgidTarget=24;
+        break;
+      case kH:
+        pdgidTarget=25;
+        break;
+      default:
+        // processType>=kTT means we should never get here
+        PError("PandaAnalyzer::FindGenObjects","Reached an unknown process type");
+    }
+
+    std::vector<int> targets;
+
+    int nGen = event.genParticles.size();
+    for (int iG=0; iG!=nGen; ++iG) {
+      auto& part(event.genParticles.at(iG));
+      int pdgid = part.pdgid;
+      unsigned int abspdgid = abs(pdgid);
+      if (abspdgid == pdgidTarget)
+        targets.push_back(iG);
+    } //looking for targets
+
+    for (int iG : targets) {
+      auto& part(event.genParticles.at(iG));
+
+      // check there is no further copy:
+      bool isLastCopy=true;
+      for (int jG : targets) {
+        if (event.genParticles.at(jG).parent.get() == &part) {
+          isLastCopy=false;
+          break;
+        }
+      }
+      if (!isLastCopy)
+        continue;
+
+      // (a) check it is a hadronic decay and if so, (b) calculate the size
+      if (processType==kTop||processType==kTT) {
+
+        // first look for a W whose parent is the top at iG, or a W further down the chain
+        panda::GenParticle const* lastW(0);
+        for (int jG=0; jG!=nGen; ++jG) {
+          GenParticle const& partW(event.genParticles.at(jG));
+          if (TMath::Abs(partW.pdgid)==24 && partW.pdgid*part.pdgid>0) {
+            // it's a W and has the same sign as the top
+            if (!lastW && partW.parent.get() == &part) {
+              lastW = &partW;
+            } else if (lastW && partW.parent.get() == lastW) {
+              lastW = &partW;
+            }
+          }
+        } // looking for W
+        if (!lastW) {// ???
+          continue;
+        }
+        auto& partW(*lastW);
+
+        // now look for b or W->qq
+        int iB=-1, iQ1=-1, iQ2=-1;
+        double size=0, sizeW=0;
+        for (int jG=0; jG!=nGen; ++jG) {
+          auto& partQ(event.genParticles.at(jG));
+          int pdgidQ = partQ.pdgid;
+          unsigned int abspdgidQ = TMath::Abs(pdgidQ);
+          if (abspdgidQ>5)
+            continue;
+          if (abspdgidQ==5 && iB<0 && partQ.parent.get() == &part) {
+            // only keep first copy
+            iB = jG;
+            size = TMath::Max(DeltaR2(part.eta(),part.phi(),partQ.eta(),partQ.phi()),size);
+          } else if (abspdgidQ<5 && partQ.parent.get() == &partW) {
+            if (iQ1<0) {
+              iQ1 = jG;
+              size = TMath::Max(DeltaR2(part.eta(),part.phi(),partQ.eta(),partQ.phi()),
+                       size);
+              sizeW = TMath::Max(DeltaR2(partW.eta(),partW.phi(),partQ.eta(),partQ.phi()),
+                       sizeW);
+            } else if (iQ2<0) {
+              iQ2 = jG;
+              size = TMath::Max(DeltaR2(part.eta(),part.phi(),partQ.eta(),partQ.phi()),
+                       size);
+              sizeW = TMath::Max(DeltaR2(partW.eta(),partW.phi(),partQ.eta(),partQ.phi()),
+                       sizeW);
+            }
+          }
+          if (iB>=0 && iQ1>=0 && iQ2>=0)
+            break;
+        } // looking for quarks
+
+
+        bool isHadronic = (iB>=0 && iQ1>=0 && iQ2>=0); // all 3 quarks were found
+        if (isHadronic)
+          genObjects[&part] = size;
+
+        bool isHadronicW = (iQ1>=0 && iQ2>=0);
+        if (isHadronicW)
+          genObjects[&partW] = sizeW;
+
+      } else { // these are W,Z,H - 2 prong decays
+
+        int iQ1=-1, iQ2=-1;
+        double size=0;
+        for (int jG=0; jG!=nGen; ++jG) {
+          auto& partQ(event.genParticles.at(jG));
+          int pdgidQ = partQ.pdgid;
+          unsigned int abspdgidQ = TMath::Abs(pdgidQ);
+          if (abspdgidQ>5)
+            continue;
+          if (partQ.parent.get() == &part) {
+            if (iQ1<0) {
+              iQ1=jG;
+              size = TMath::Max(DeltaR2(part.eta(),part.phi(),partQ.eta(),partQ.phi()),
+                       size);
+            } else if (iQ2<0) {
+              iQ2=jG;
+              size = TMath::Max(DeltaR2(part.eta(),part.phi(),partQ.eta(),partQ.phi()),
+                       size);
+            }
+          }
+          if (iQ1>=0 && iQ2>=0)
+            break;
+        } // looking for quarks
+
+        bool isHadronic = (iQ1>=0 && iQ2>=0); // both quarks were found
+
+        // add to collection
+        if (isHadronic)
+          genObjects[&part] = size;
+      }
+
+    } // loop over targets
+  } // process is interesting
+
+  return pdgidTarget;
+}
+
+
+void PandaAnalyzer::FillTTbarGen() {
+  // ttbar pT weight
+  gt->sf_tt = 1; gt->sf_tt_ext = 1; gt->sf_tt_bound = 1;
+  gt->sf_tt8TeV = 1; gt->sf_tt8TeV_ext = 1; gt->sf_tt8TeV_bound = 1;
+  gt->sf_qcdTT = 1;
+  if (!isData && processType==kTT) {
+    gt->genWPlusPt = -1; gt->genWMinusPt = -1;
+    for (auto& gen : event.genParticles) {
+      if (abs(gen.pdgid)!=24)
+        continue;
+      if (flags["firstGen"]) {
+        if (gen.parent.isValid() && gen.parent->pdgid==gen.pdgid)
+          continue; // must be first copy
+      }
+      if (gen.pdgid>0) {
+       gt->genWPlusPt = gen.pt();
+       gt->genWPlusEta = gen.eta();
+      } else {
+       gt->genWMinusPt = gen.pt();
+       gt->genWMinusEta = gen.eta();
+      }
+      if (flags["firstGen"]) {
+        if (gt->genWPlusPt>0 && gt->genWMinusPt>0)
+          break;
+      }
+    }
+    TLorentzVector vT,vTbar;
+    float pt_t=0, pt_tbar=0;
+    for (auto& gen : event.genParticles) {
+      if (abs(gen.pdgid)!=6)
+        continue;
+      if (flags["firstGen"]) {
+        if (gen.parent.isValid() && gen.parent->pdgid==gen.pdgid)
+          continue; // must be first copy
+      }
+      if (gen.pdgid>0) {
+       pt_t = gen.pt();
+       gt->genTopPt = gen.pt();
+       gt->genTopEta = gen.eta();
+       vT.SetPtEtaPhiM(gen.pt(),gen.eta(),gen.phi(),gen.m());
+      } else {
+       pt_tbar = gen.pt();
+       gt->genAntiTopPt = gen.pt();
+       gt->genAntiTopEta = gen.eta();
+       vTbar.SetPtEtaPhiM(gen.pt(),gen.eta(),gen.phi(),gen.m());
+      }
+      if (flags["firstGen"]) {
+        if (pt_t>0 && pt_tbar>0)
+          break;
+      }
+    }
+    if (pt_t>0 && pt_tbar>0) {
+      TLorentzVector vTT = vT+vTbar;
+      gt->genTTPt = vTT.Pt(); gt->genTTEta = vTT.Eta();
+      gt->sf_tt8TeV       = TMath::Sqrt(TMath::Exp(0.156-0.00137*TMath::Min((float)400.,pt_t)) *
+                       TMath::Exp(0.156-0.00137*TMath::Min((float)400.,pt_tbar)));
+      gt->sf_tt           = TMath::Sqrt(TMath::Exp(0.0615-0.0005*TMath::Min((float)400.,pt_t)) *
+                       TMath::Exp(0.0615-0.0005*TMath::Min((float)400.,pt_tbar)));
+      gt->sf_tt8TeV_ext   = TMath::Sqrt(TMath::Exp(0.156-0.00137*pt_t) *
+                       TMath::Exp(0.156-0.00137*pt_tbar));
+      gt->sf_tt_ext       = TMath::Sqrt(TMath::Exp(0.0615-0.0005*pt_t) *
+                       TMath::Exp(0.0615-0.0005*pt_tbar));
+      gt->sf_tt8TeV_bound = TMath::Sqrt(((pt_t>400) ? 1 : TMath::Exp(0.156-0.00137*pt_t)) *
+                       ((pt_tbar>400) ? 1 : TMath::Exp(0.156-0.00137*pt_tbar)));
+      gt->sf_tt_bound     = TMath::Sqrt(((pt_t>400) ? 1 : TMath::Exp(0.0615-0.0005*pt_t)) *
+                       ((pt_tbar>400) ? 1 : TMath::Exp(0.0615-0.0005*pt_tbar)));
+    }
+
+    if (pt_t>0)
+      gt->sf_qcdTT *= TTNLOToNNLO(pt_t);
+    if (pt_tbar>0) 
+      gt->sf_qcdTT *= TTNLOToNNLO(pt_tbar);
+    gt->sf_qcdTT = TMath::Sqrt(gt->sf_qcdTT);
+
+  }
+}
+
+
+void PandaAnalyzer::FillBosonSFs(float genBosonPtMin, float genBosonPtMax) {
+  gt->sf_qcdV=1; gt->sf_ewkV=1;
+  gt->sf_qcdV_VBF=1;
+  if (!isData) {
+    bool found = processType!=kA && processType!=kZ && processType!=kW
+                   && processType!=kZEWK && processType!=kWEWK;
+    int target=24;
+    if (processType==kZ || processType==kZEWK) target=23;
+    if (processType==kA) target=22;
+
+    for (auto& gen : event.genParticles) {
+      if (found) break;
+      int apdgid = abs(gen.pdgid);
+      if (apdgid==target)     {
+        if (gen.parent.isValid() && gen.parent->pdgid==gen.pdgid)
+          continue;
+        if (processType==kZ) {
+          gt->trueGenBosonPt = gen.pt();
+          gt->genBosonPt = bound(gen.pt(),genBosonPtMin,genBosonPtMax);
+          gt->sf_qcdV = GetCorr(cZNLO,gt->genBosonPt);
+          gt->sf_ewkV = GetCorr(cZEWK,gt->genBosonPt);
+          gt->sf_qcdV_VBF = GetCorr(cVBF_ZNLO,gt->genBosonPt);
+          found=true;
+        } else if (processType==kW) {
+          gt->trueGenBosonPt = gen.pt();
+          gt->genBosonPt = bound(gen.pt(),genBosonPtMin,genBosonPtMax);
+          gt->sf_qcdV = GetCorr(cWNLO,gt->genBosonPt);
+          gt->sf_ewkV = GetCorr(cWEWK,gt->genBosonPt);
+          gt->sf_qcdV_VBF = GetCorr(cVBF_WNLO,gt->genBosonPt);
+          found=true;
+        } else if (processType==kZEWK) {
+          gt->trueGenBosonPt = gen.pt();
+          gt->genBosonPt = bound(gen.pt(),genBosonPtMin,genBosonPtMax);
+          gt->sf_qcdV_VBF = GetCorr(cVBF_EWKZ,gt->genBosonPt,gt->jot12Mass);
+        } else if (processType==kWEWK) {
+          gt->trueGenBosonPt = gen.pt();
+          gt->genBosonPt = bound(gen.pt(),genBosonPtMin,genBosonPtMax);
+          gt->sf_qcdV_VBF = GetCorr(cVBF_EWKW,gt->genBosonPt,gt->jot12Mass);
+        } else if (processType==kA) {
+          // take the highest pT
+          if (gen.pt() > gt->trueGenBosonPt) {
+            gt->trueGenBosonPt = gen.pt();
+            gt->genBosonPt = bound(gen.pt(),genBosonPtMin,genBosonPtMax);
+            gt->sf_qcdV = GetCorr(cANLO,gt->genBosonPt);
+            gt->sf_ewkV = GetCorr(cAEWK,gt->genBosonPt);
+            gt->sf_qcdV2j = GetCorr(cANLO2j,gt->genBosonPt);
+          }
+        }
+      } // target matches
+    }
+  }
+}
+
+
+void PandaAnalyzer::FillSignalGen() {
+  if (!isData && processType==kSignal) {
+    bool found=false, foundbar=false;
+    TLorentzVector vMediator(0,0,0,0);
+    for (auto& gen : event.genParticles) {
+      if (found && foundbar)
+        break;
+      if (abs(gen.pdgid) != 18)
+        continue;
+      if (gen.parent.isValid() && gen.parent->pdgid == gen.pdgid)
+        continue;
+      if (gen.pdgid == 18 && !found) {
+        found = true;
+        vMediator += gen.p4();
+      } else if (gen.pdgid == -18 && !foundbar) {
+        foundbar = true;
+        vMediator += gen.p4();
+      }
+    }
+    if (found && foundbar) {
+      gt->trueGenBosonPt = vMediator.Pt();
+      gt->genBosonPt = bound(gt->trueGenBosonPt,175,1200);
+    }
+    // gt->trueGenBosonPt = event.genMet.pt;
+    // gt->genBosonPt = bound(gt->trueGenBosonPt,175,1200);
+    // tr.TriggerEvent("signal gen kinematics");
+  }
+}
+
+
+void PandaAnalyzer::FillGenWeights() {
+  gt->scaleUp = 1; gt->scaleDown = 1;
+  gt->pdfUp = 1; gt->pdfDown = 1;
+  if (!isData) {
+    gt->pdfUp = 1 + event.genReweight.pdfDW;
+    gt->pdfDown = 1 - event.genReweight.pdfDW;
+    auto &genReweight = event.genReweight;
+    for (unsigned iS=0; iS!=6; ++iS) {
+      float s=1;
+      switch (iS) {
+        case 0:
+          s = genReweight.r1f2DW; break;
+        case 1:
+          s = genReweight.r1f5DW; break;
+        case 2:
+          s = genReweight.r2f1DW; break;
+        case 3:
+          s = genReweight.r2f2DW; break;
+        case 4:
+          s = genReweight.r5f1DW; break;
+        case 5:
+          s = genReweight.r5f5DW; break;
+        default:
+          break;
+      }
+      gt->scale[iS] = s; 
+      gt->scaleUp = max(float(gt->scaleUp),float(s));
+      gt->scaleDown = min(float(gt->scaleDown),float(s));
+    }
+
+    unsigned nW = wIDs.size();
+    if (nW) {
+      for (unsigned iW=0; iW!=nW; ++iW) {
+        gt->signal_weights[wIDs[iW]] = event.genReweight.genParam[iW];
+      }
+    }
+  }
+}
+
+
 // run
 void PandaAnalyzer::Run() {
 
@@ -640,6 +1503,11 @@ void PandaAnalyzer::Run() {
     genBosonPtMax = h1Corrs[cZNLO]->GetHist()->GetBinCenter(h1Corrs[cZNLO]->GetHist()->GetNbinsX());
   }
 
+  if (flags["genOnly"]) {
+    RunGenOnly(nZero,nEvents,genBosonPtMin,genBosonPtMax);
+    return;
+  }
+
   panda::FatJetCollection* fatjets(0);
   if (flags["fatjet"]) {
    if (flags["puppi"])
@@ -672,10 +1540,6 @@ void PandaAnalyzer::Run() {
   JetCorrectionUncertainty *uncReaderAK4=0;
   FactorizedJetCorrector *scaleReaderAK4=0;
 
-  std::vector<unsigned int> metTriggers;
-  std::vector<unsigned int> eleTriggers;
-  std::vector<unsigned int> phoTriggers;
-  std::vector<unsigned int> muTriggers;
 
   if (isData) {
     std::vector<TString> metTriggerPaths = {
@@ -728,15 +1592,15 @@ void PandaAnalyzer::Run() {
 
     if (DEBUG>1) PDebug("PandaAnalyzer::Run","Loading MET triggers");
     for (auto path : metTriggerPaths) {
-      RegisterTrigger(path,metTriggers);
+      RegisterTrigger(path,kMETTrig);
     }
     if (DEBUG>1) PDebug("PandaAnalyzer::Run","Loading SingleElectron triggers");
     for (auto path : eleTriggerPaths) {
-      RegisterTrigger(path,eleTriggers);
+      RegisterTrigger(path,kSingleEleTrig);
     }
     if (DEBUG>1) PDebug("PandaAnalyzer::Run","Loading SinglePhoton triggers");
     for (auto path : phoTriggerPaths) {
-      RegisterTrigger(path,phoTriggers);
+      RegisterTrigger(path,kSinglePhoTrig);
     }
 
   }
@@ -749,12 +1613,26 @@ void PandaAnalyzer::Run() {
   TimeReporter tr("PandaAnalyzer::Run",DEBUG);
 
   bool applyJSON = flags["applyJSON"];
+  // on data, entries of lumis failing the JSON are skipped without being read
+  bool skipBadLumis = isData && applyJSON && lumiIndex.Build(tIn,nZero,nEvents);
   bool doMonoH = flags["monohiggs"];
   bool doVBF = flags["vbf"];
   bool doFatjet = flags["fatjet"];
+  ConfigureStages();
+  if (flags["columnPreselection"] && !SetupColumnPreselection()) {
+    delete columns; columns=0;
+  }
 
   // EVENTLOOP --------------------------------------------------------------------------
   for (iE=nZero; iE!=nEvents; ++iE) {
+    if (skipBadLumis) {
+      iE = lumiIndex.NextGood(iE,goodLumis);
+      if (iE==nEvents)
+        break;
+    }
+    // entries failing the column cuts would fail the preselection, so skip them before getEntry
+    if (columns && !PassColumnPreselection(iE,nEvents))
+      continue;
     tr.Start();
     pr.Report();
     ResetBranches();
@@ -814,24 +1692,7 @@ void PandaAnalyzer::Run() {
         continue;
 
       // save triggers
-      for (auto iT : metTriggers) {
-       if (event.triggerFired(iT)) {
-        gt->trigger |= kMETTrig;
-        break;
-       }
-      }
-      for (auto iT : eleTriggers) {
-       if (event.triggerFired(iT)) {
-        gt->trigger |= kSingleEleTrig;
-        break;
-       }
-      }
-      for (auto iT : phoTriggers) {
-       if (event.triggerFired(iT)) {
-        gt->trigger |= kSinglePhoTrig;
-        break;
-       }
-      }
+      gt->trigger |= triggerMenu.Evaluate(event,event.runNumber);
     } else {
       gt->sf_npv = GetCorr(cNPV,gt->npv);
       gt->sf_pu = GetCorr(cPU,gt->pu);
@@ -863,8 +1724,6 @@ void PandaAnalyzer::Run() {
     gt->pfmetRaw = event.rawMet.pt;
     gt->pfmet = event.pfMet.pt;
     gt->pfmetphi = event.pfMet.phi;
-    gt->pfmetUp = event.pfMet.ptCorrUp;
-    gt->pfmetDown = event.pfMet.ptCorrDown;
     gt->calomet = event.caloMet.pt;
     gt->puppimet = event.puppiMet.pt;
     gt->puppimetphi = event.puppiMet.phi;
@@ -873,6 +1732,18 @@ void PandaAnalyzer::Run() {
     vPuppiMET.SetPtEtaPhiM(gt->puppimet,0,gt->puppimetphi,0);
     TVector2 vMETNoMu; vMETNoMu.SetMagPhi(gt->pfmet,gt->pfmetphi); //       for trigger eff
 
+    // propagate JES and JER variations of all jets to the pf met in a single pass;
+    // the shifts are applied relative to the upstream type-1 met
+    jetCorr->RunCorrection(isData,event.rho,jets,&event.rawMet,event.runNumber);
+    TVector2 vpfShift[JetCorrector::nMETShift];
+    TVector2 vpfNominal = jetCorr->GetCorrectedMetVector(JetCorrector::kNominal);
+    for (unsigned iS=0; iS!=JetCorrector::nMETShift; ++iS) {
+      vpfShift[iS] = vPFMET.Vect().XYvector()
+                     + jetCorr->GetCorrectedMetVector((JetCorrector::METShift)iS) - vpfNominal;
+    }
+    SetMETShifts(vpfShift,gt->pfmetUp,gt->pfmetDown,
+                 gt->pfmetSmeared,gt->pfmetSmearedUp,gt->pfmetSmearedDown);
+
     tr.TriggerEvent("met");
 
     gt->isGS = 0;
@@ -1054,6 +1925,10 @@ void PandaAnalyzer::Run() {
         gt->sf_phoPurity = 0.02544;
     }
 
+    // cleaning against leptons and photons is done on these from here on
+    lepArrays.Fill(matchLeps);
+    phoArrays.Fill(matchPhos);
+
     tr.TriggerEvent("photons");
 
     // trigger efficiencies
@@ -1079,12 +1954,12 @@ void PandaAnalyzer::Run() {
     tr.TriggerEvent("triggers");
 
     // recoil!
-    TLorentzVector vpfUp; vpfUp.SetPtEtaPhiM(gt->pfmetUp,0,gt->pfmetphi,0);
-    TLorentzVector vpfDown; vpfDown.SetPtEtaPhiM(gt->pfmetDown,0,gt->pfmetphi,0);
     TLorentzVector vObj1, vObj2;
     TLorentzVector vpuppiUW, vpuppiUZ, vpuppiUA;
     TLorentzVector vpfUW, vpfUZ, vpfUA;
     TLorentzVector vpuppiU, vpfU;
+    TVector2 vpfUWShift[JetCorrector::nMETShift], vpfUZShift[JetCorrector::nMETShift];
+    TVector2 vpfUAShift[JetCorrector::nMETShift], vpfUShift[JetCorrector::nMETShift];
     int whichRecoil = 0; // -1=photon, 0=MET, 1,2=nLep
     if (gt->nLooseLep>0) {
       panda::Lepton *lep1 = looseLeps.at(0);
@@ -1094,8 +1969,12 @@ void PandaAnalyzer::Run() {
       vpuppiUW = vPuppiMET+vObj1; gt->puppiUWmag=vpuppiUW.Pt(); gt->puppiUWphi=vpuppiUW.Phi();
       vpfUW = vPFMET+vObj1; gt->pfUWmag=vpfUW.Pt(); gt->pfUWphi=vpfUW.Phi();
       
-      TLorentzVector vpfUWUp = vpfUp+vObj1; gt->pfUWmagUp = vpfUWUp.Pt();
-      TLorentzVector vpfUWDown = vpfDown+vObj1; gt->pfUWmagDown = vpfUWDown.Pt();
+      if (doRecoilShifts) {
+        for (unsigned iS=0; iS!=JetCorrector::nMETShift; ++iS)
+          vpfUWShift[iS] = vpfShift[iS] + vObj1.Vect().XYvector();
+        SetMETShifts(vpfUWShift,gt->pfUWmagUp,gt->pfUWmagDown,
+                     gt->pfUWmagSmeared,gt->pfUWmagSmearedUp,gt->pfUWmagSmearedDown);
+      }
 
       if (gt->nLooseLep>1 && gt->looseLep1PdgId+gt->looseLep2PdgId==0) {
         // two OS lep => Z
@@ -1105,13 +1984,19 @@ void PandaAnalyzer::Run() {
         vpuppiUZ=vpuppiUW+vObj2; gt->puppiUZmag=vpuppiUZ.Pt(); gt->puppiUZphi=vpuppiUZ.Phi();
         vpfUZ=vpfUW+vObj2; gt->pfUZmag=vpfUZ.Pt(); gt->pfUZphi=vpfUZ.Phi();
 
-        TLorentzVector vpfUZUp = vpfUWUp+vObj2; gt->pfUZmagUp = vpfUZUp.Pt();
-        TLorentzVector vpfUZDown = vpfUWDown+vObj2; gt->pfUZmagDown = vpfUZDown.Pt();
+        if (doRecoilShifts) {
+          for (unsigned iS=0; iS!=JetCorrector::nMETShift; ++iS)
+            vpfUZShift[iS] = vpfUWShift[iS] + vObj2.Vect().XYvector();
+          SetMETShifts(vpfUZShift,gt->pfUZmagUp,gt->pfUZmagDown,
+                       gt->pfUZmagSmeared,gt->pfUZmagSmearedUp,gt->pfUZmagSmearedDown);
+        }
 
         vpuppiU = vpuppiUZ; vpfU = vpfUZ;
+        std::copy(vpfUZShift,vpfUZShift+JetCorrector::nMETShift,vpfUShift);
         whichRecoil = 2;
       } else {
         vpuppiU = vpuppiUW; vpfU = vpfUW;
+        std::copy(vpfUWShift,vpfUWShift+JetCorrector::nMETShift,vpfUShift);
         whichRecoil = 1;
       }
     }
@@ -1122,19 +2007,28 @@ void PandaAnalyzer::Run() {
       vpuppiUA=vPuppiMET+vObj1; gt->puppiUAmag=vpuppiUA.Pt(); gt->puppiUAphi=vpuppiUA.Phi();
       vpfUA=vPFMET+vObj1; gt->pfUAmag=vpfUA.Pt(); gt->pfUAphi=vpfUA.Phi();
 
-      TLorentzVector vpfUAUp = vpfUp+vObj1; gt->pfUAmagUp = vpfUAUp.Pt();
-      TLorentzVector vpfUADown = vpfDown+vObj1; gt->pfUAmagDown = vpfUADown.Pt();
+      if (doRecoilShifts) {
+        for (unsigned iS=0; iS!=JetCorrector::nMETShift; ++iS)
+          vpfUAShift[iS] = vpfShift[iS] + vObj1.Vect().XYvector();
+        SetMETShifts(vpfUAShift,gt->pfUAmagUp,gt->pfUAmagDown,
+                     gt->pfUAmagSmeared,gt->pfUAmagSmearedUp,gt->pfUAmagSmearedDown);
+      }
 
       if (gt->nLooseLep==0) {
         vpuppiU = vpuppiUA; vpfU = vpfUA;
+        std::copy(vpfUAShift,vpfUAShift+JetCorrector::nMETShift,vpfUShift);
         whichRecoil = -1;
       }
     }
     if (gt->nLooseLep==0 && gt->nLoosePhoton==0) {
       vpuppiU = vPuppiMET;
       vpfU = vPFMET;
+      std::copy(vpfShift,vpfShift+JetCorrector::nMETShift,vpfUShift);
       whichRecoil = 0;
     }
+    if (doRecoilShifts)
+      SetMETShifts(vpfUShift,gt->pfUmagUp,gt->pfUmagDown,
+                   gt->pfUmagSmeared,gt->pfUmagSmearedUp,gt->pfUmagSmearedDown);
     gt->puppiUmag = vpuppiU.Pt();
     gt->puppiUphi = vpuppiU.Phi();
     gt->pfUmag = vpfU.Pt();
@@ -1145,13 +2039,13 @@ void PandaAnalyzer::Run() {
     panda::FatJet *fj1=0;
     gt->nFatjet=0;
     if (doFatjet) {
+      vector<panda::FatJet*> selFatjets;
+      CleaningMask(*fatjets,2.25,true);
       int fatjet_counter=-1;
       for (auto& fj : *fatjets) {
         ++fatjet_counter;
         float pt = fj.pt();
-        float rawpt = fj.rawPt;
         float eta = fj.eta();
-        float mass = fj.m();
         float ptcut = 200;
         if (doMonoH)
           ptcut = 200;
@@ -1160,139 +2054,58 @@ void PandaAnalyzer::Run() {
           continue;
 
         float phi = fj.phi();
-        if (IsMatched(&matchLeps,2.25,eta,phi) || IsMatched(&matchPhos,2.25,eta,phi)) {
+        if (cleanMask.Test(fatjet_counter)) {
           continue;
         }
 
         gt->nFatjet++;
+        if (gt->nfj<NFATJET) {
+          unsigned iFJ = gt->nfj++;
+          gt->ResetNfj(iFJ); // not every fj array is filled for every jet
+          gt->fjIsClean[iFJ] = (fatjet_counter==0) ? 1 : 0;
+          FatjetBasics(iFJ,fj,scaleReaderAK4,uncReaderAK4);
+          selFatjets.push_back(&fj);
+        }
         if (gt->nFatjet==1) {
           fj1 = &fj;
-          if (fatjet_counter==0)
-            gt->fj1IsClean = 1;
-          else
-            gt->fj1IsClean = 0;
-          gt->fj1Pt = pt;
-          gt->fj1Eta = eta;
-          gt->fj1Phi = phi;
-          gt->fj1M = mass;
-          gt->fj1MSD = fj.mSD;
-          gt->fj1RawPt = rawpt;
-
-          // do a bit of jet energy scaling
-          // uncReader->setJetEta(eta); uncReader->setJetPt(pt);
-          // double scaleUnc = uncReader->getUncertainty(true);
-          double scaleUnc = (fj.ptCorrUp - gt->fj1Pt) / gt->fj1Pt; 
-          gt->fj1PtScaleUp    = gt->fj1Pt  * (1 + 2*scaleUnc);
-          gt->fj1PtScaleDown  = gt->fj1Pt  * (1 - 2*scaleUnc);
-          gt->fj1MSDScaleUp   = gt->fj1MSD * (1 + 2*scaleUnc);
-          gt->fj1MSDScaleDown = gt->fj1MSD * (1 - 2*scaleUnc);
-
-          // do some jet energy smearing
-          if (isData) {
-            gt->fj1PtSmeared = gt->fj1Pt;
-            gt->fj1PtSmearedUp = gt->fj1Pt;
-            gt->fj1PtSmearedDown = gt->fj1Pt;
-            gt->fj1MSDSmeared = gt->fj1MSD;
-            gt->fj1MSDSmearedUp = gt->fj1MSD;
-            gt->fj1MSDSmearedDown = gt->fj1MSD;
-          } else {
-            double smear=1, smearUp=1, smearDown=1;
-            ak8JERReader->getStochasticSmear(pt,eta,event.rho,smear,smearUp,smearDown);
-
-            gt->fj1PtSmeared = smear*gt->fj1Pt;
-            gt->fj1PtSmearedUp = smearUp*gt->fj1Pt;
-            gt->fj1PtSmearedDown = smearDown*gt->fj1Pt;
-
-            gt->fj1MSDSmeared = smear*gt->fj1MSD;
-            gt->fj1MSDSmearedUp = smearUp*gt->fj1MSD;
-            gt->fj1MSDSmearedDown = smearDown*gt->fj1MSD;
-          }
-
-          // now have to do this mess with the subjets...
-          TLorentzVector sjSum, sjSumUp, sjSumDown, sjSumSmear;
-          for (unsigned int iSJ=0; iSJ!=fj.subjets.size(); ++iSJ) {
-            auto& subjet = fj.subjets.objAt(iSJ);
-            // now correct...
-            double factor=1;
-            if (fabs(subjet.eta())<5.191) {
-              scaleReaderAK4->setJetPt(subjet.pt());
-              scaleReaderAK4->setJetEta(subjet.eta());
-              scaleReaderAK4->setJetPhi(subjet.phi());
-              scaleReaderAK4->setJetE(subjet.e());
-              scaleReaderAK4->setRho(event.rho);
-              scaleReaderAK4->setJetA(0);
-              scaleReaderAK4->setJetEMF(-99.0);
-              factor = scaleReaderAK4->getCorrection();
-            }
-            TLorentzVector vCorr = factor * subjet.p4();
-            sjSum += vCorr;
-            double corr_pt = vCorr.Pt();
-
-            // now vary
-            uncReaderAK4->setJetEta(subjet.eta()); uncReaderAK4->setJetPt(corr_pt);
-            double scaleUnc = uncReaderAK4->getUncertainty(true);
-            sjSumUp += (1 + 2*scaleUnc) * vCorr;
-            sjSumDown += (1 - 2*scaleUnc) * vCorr;
-
-            // now smear...
-            double smear=1, smearUp=1, smearDown=1;
-            ak4JERReader->getStochasticSmear(corr_pt,subjet.eta(),event.rho,smear,smearUp,smearDown);
-            sjSumSmear += smear * vCorr;
-          }
-          gt->fj1PtScaleUp_sj = gt->fj1Pt * (sjSumUp.Pt()/sjSum.Pt());
-          gt->fj1PtScaleDown_sj = gt->fj1Pt * (sjSumDown.Pt()/sjSum.Pt());
-          gt->fj1PtSmeared_sj = gt->fj1Pt * (sjSumSmear.Pt()/sjSum.Pt());
-          gt->fj1MSDScaleUp_sj = gt->fj1MSD * (sjSumUp.Pt()/sjSum.Pt());
-          gt->fj1MSDScaleDown_sj = gt->fj1MSD * (sjSumDown.Pt()/sjSum.Pt());
-          gt->fj1MSDSmeared_sj = gt->fj1MSD * (sjSumSmear.Pt()/sjSum.Pt());
-
-
-          // mSD correction
-          float corrweight=1.;
-          corrweight = GetMSDCorr(pt,eta);
-          gt->fj1MSD_corr = corrweight*gt->fj1MSD;
-
-          // now we do substructure
-          gt->fj1Tau32 = clean(fj.tau3/fj.tau2);
-          gt->fj1Tau32SD = clean(fj.tau3SD/fj.tau2SD);
-          gt->fj1Tau21 = clean(fj.tau2/fj.tau1);
-          gt->fj1Tau21SD = clean(fj.tau2SD/fj.tau1SD);
-
-          for (auto ibeta : ibetas) {
-            for (auto N : Ns) {
-              for (auto order : orders) {
-                GeneralTree::ECFParams p;
-                p.order = order; p.N = N; p.ibeta = ibeta;
-                if (gt->fj1IsClean || true)
-                  gt->fj1ECFNs[p] = fj.get_ecf(order,N,ibeta);
-                else
-                  gt->fj1ECFNs[p] = fj.get_ecf(order,N,ibeta);
-              }
-            }
-          } //loop over betas
-          gt->fj1HTTMass = fj.htt_mass;
-          gt->fj1HTTFRec = fj.htt_frec;
-
-          std::vector<panda::MicroJet const*> subjets;
-          for (unsigned iS(0); iS != fj.subjets.size(); ++iS)
-           subjets.push_back(&fj.subjets.objAt(iS));
-
-          auto csvsort([](panda::MicroJet const* j1, panda::MicroJet const* j2)->bool {
-            return j1->csv > j2->csv;
-           });
-
-          std::sort(subjets.begin(),subjets.end(),csvsort);
-          if (subjets.size()>0) {
-            gt->fj1MaxCSV = subjets.at(0)->csv;
-            gt->fj1MinCSV = subjets.back()->csv;
-            if (subjets.size()>1) {
-              gt->fj1SubMaxCSV = subjets.at(1)->csv;
-            }
-          }
-          gt->fj1DoubleCSV = fj.double_sub;
+          gt->fj1IsClean = gt->fjIsClean[0];
+          gt->fj1Pt = gt->fjPt[0];
+          gt->fj1Eta = gt->fjEta[0];
+          gt->fj1Phi = gt->fjPhi[0];
+          gt->fj1M = gt->fjM[0];
+          gt->fj1MSD = gt->fjMSD[0];
+          gt->fj1RawPt = gt->fjRawPt[0];
+          gt->fj1PtScaleUp = gt->fjPtScaleUp[0];
+          gt->fj1PtScaleDown = gt->fjPtScaleDown[0];
+          gt->fj1MSDScaleUp = gt->fjMSDScaleUp[0];
+          gt->fj1MSDScaleDown = gt->fjMSDScaleDown[0];
+          gt->fj1PtSmeared = gt->fjPtSmeared[0];
+          gt->fj1PtSmearedUp = gt->fjPtSmearedUp[0];
+          gt->fj1PtSmearedDown = gt->fjPtSmearedDown[0];
+          gt->fj1MSDSmeared = gt->fjMSDSmeared[0];
+          gt->fj1MSDSmearedUp = gt->fjMSDSmearedUp[0];
+          gt->fj1MSDSmearedDown = gt->fjMSDSmearedDown[0];
+          gt->fj1PtScaleUp_sj = gt->fjPtScaleUp_sj[0];
+          gt->fj1PtScaleDown_sj = gt->fjPtScaleDown_sj[0];
+          gt->fj1PtSmeared_sj = gt->fjPtSmeared_sj[0];
+          gt->fj1MSDScaleUp_sj = gt->fjMSDScaleUp_sj[0];
+          gt->fj1MSDScaleDown_sj = gt->fjMSDScaleDown_sj[0];
+          gt->fj1MSDSmeared_sj = gt->fjMSDSmeared_sj[0];
+          gt->fj1MSD_corr = gt->fjMSD_corr[0];
+          gt->fj1Tau32 = gt->fjTau32[0];
+          gt->fj1Tau32SD = gt->fjTau32SD[0];
+          gt->fj1Tau21 = gt->fjTau21[0];
+          gt->fj1Tau21SD = gt->fjTau21SD[0];
+          gt->fj1HTTMass = gt->fjHTTMass[0];
+          gt->fj1HTTFRec = gt->fjHTTFRec[0];
+          gt->fj1MaxCSV = gt->fjMaxCSV[0];
+          gt->fj1MinCSV = gt->fjMinCSV[0];
+          gt->fj1SubMaxCSV = gt->fjSubMaxCSV[0];
+          gt->fj1DoubleCSV = gt->fjDoubleCSV[0];
 
           if (doMonoH) {
-            for (unsigned int iSJ=0; iSJ!=fj.subjets.size(); ++iSJ) {
+            gt->nfj1sj = std::min((unsigned)fj.subjets.size(),(unsigned)NSUBJET);
+            for (unsigned int iSJ=0; iSJ!=(unsigned)gt->nfj1sj; ++iSJ) {
               auto& subjet = fj.subjets.objAt(iSJ);
               gt->fj1sjPt[iSJ]=subjet.pt();
               gt->fj1sjEta[iSJ]=subjet.eta();
@@ -1306,47 +2119,20 @@ void PandaAnalyzer::Run() {
       }
       tr.TriggerSubEvent("fatjet basics");
 
-      if (flags["pfCands"] && fj1) {
-        VPseudoJet particles = ConvertPFCands(event.pfCandidates,flags["puppi"],0);
-        fastjet::ClusterSequenceArea seq(particles,*jetDef,*areaDef);
-        VPseudoJet allJets(seq.inclusive_jets(0.));
-        fastjet::PseudoJet *pj1=0;
-        double minDR2 = 999;
-        for (auto &jet : allJets) {
-          double dr2 = DeltaR2(jet.eta(),jet.phi_std(),fj1->eta(),fj1->phi());
-          if (dr2<minDR2) {
-            minDR2 = dr2;
-            pj1 = &jet;
-          }
-        }
-        if (pj1) {
-          VPseudoJet constituents = fastjet::sorted_by_pt(pj1->constituents());
-
-          gt->fj1NConst = constituents.size();
-          double eTot=0, eTrunc=0;
-          for (unsigned iC=0; iC!=gt->fj1NConst; ++iC) {
-            double e = constituents.at(iC).E();
-            eTot += e;
-            if (iC<100)
-              eTrunc += e;
-          }
-          gt->fj1EFrac100 = eTrunc/eTot;
-
-
-          fastjet::PseudoJet sdJet = (*softDrop)(*pj1);
-          VPseudoJet sdConstituents = fastjet::sorted_by_pt(sdJet.constituents());
-          gt->fj1NSDConst = sdConstituents.size();
-          eTot=0; eTrunc=0;
-          for (unsigned iC=0; iC!=gt->fj1NSDConst; ++iC) {
-            double e = sdConstituents.at(iC).E();
-            eTot += e;
-            if (iC<100)
-              eTrunc += e;
-          }
-          gt->fj1SDEFrac100 = eTrunc/eTot;
+      RunFatjetSubstructure(selFatjets);
+      if (fj1) {
+        for (unsigned iECF=0; iECF!=gt->GetNECF(); ++iECF)
+          gt->fj1ECFNs[iECF] = gt->fjECFNs[iECF][0];
+        gt->fj1NConst = gt->fjNConst[0];
+        gt->fj1EFrac100 = gt->fjEFrac100[0];
+        gt->fj1NSDConst = gt->fjNSDConst[0];
+        gt->fj1SDEFrac100 = gt->fjSDEFrac100[0];
+      }
+      tr.TriggerSubEvent("fatjet substructure");
 
-        }
-        tr.TriggerSubEvent("fatjet reclustering");
+      if (fj1 && flags["constituents"]) {
+        FillConstituentArrays(*fj1);
+        tr.TriggerSubEvent("fatjet constituents");
       }
     }
 
@@ -1368,8 +2154,10 @@ void PandaAnalyzer::Run() {
     float maxIsoEta = (doMonoH) ? maxJetEta : 2.5;
     unsigned nJetDPhi = (doVBF) ? 4 : 5;
 
+    CleaningMask(*jets,0.16,true);
+    int jet_counter=-1;
     for (auto& jet : *jets) {
-     
+     ++jet_counter;
 
      // only do eta-phi checks here
      if (abs(jet.eta()) > maxJetEta)
@@ -1378,8 +2166,7 @@ void PandaAnalyzer::Run() {
      // For VBF we require nTightLep>0, but in monotop looseLep1IsTight
      // No good reason to do that, should switch to former
      // Should update jet cleaning accordingly (just check all loose objects)
-     if (IsMatched(&matchLeps,0.16,jet.eta(),jet.phi()) ||
-         IsMatched(&matchPhos,0.16,jet.eta(),jet.phi()))
+     if (cleanMask.Test(jet_counter))
         continue;
      if (doVBF && !jet.loose)
        continue;
@@ -1426,7 +2213,8 @@ void PandaAnalyzer::Run() {
         }
       }
 
-      if (doMonoH) {
+      if (doMonoH && cleanedJets.size()<=NJET) {
+        gt->nJotStored = cleanedJets.size();
         gt->jetPt[cleanedJets.size()-1]=jet.pt();
         gt->jetEta[cleanedJets.size()-1]=jet.eta();
         gt->jetPhi[cleanedJets.size()-1]=jet.phi();
@@ -1473,10 +2261,10 @@ void PandaAnalyzer::Run() {
          gt->isojet2Pt = jet.pt();
          gt->isojet2CSV = jet.csv;
         }
-        if (doMonoH)
+        if (doMonoH && cleanedJets.size()<=NJET)
           gt->jetIso[cleanedJets.size()-1]=1;
       } else {
-        if (doMonoH)
+        if (doMonoH && cleanedJets.size()<=NJET)
           gt->jetIso[cleanedJets.size()-1]=0;
       }
      }
@@ -1605,7 +2393,10 @@ void PandaAnalyzer::Run() {
       tr.TriggerEvent("monohiggs");
     }
 
+    CleaningMask(event.taus,0.16,false);
+    int tau_counter=-1;
     for (auto& tau : event.taus) {
+      ++tau_counter;
       if (doVBF) {
         if (!tau.decayMode || !tau.decayModeNew)
           continue;
@@ -1623,7 +2414,7 @@ void PandaAnalyzer::Run() {
       */
       if (tau.pt()<18 || fabs(tau.eta())>2.3)
         continue;
-      if (IsMatched(&matchLeps,0.16,tau.eta(),tau.phi()))
+      if (cleanMask.Test(tau_counter))
         continue;
       gt->nTau++;
     }
@@ -1636,146 +2427,12 @@ void PandaAnalyzer::Run() {
     tr.TriggerEvent("presel");
 
     // identify interesting gen particles for fatjet matching
-    unsigned int pdgidTarget=0;
-    if (!isData && processType>=kTT) {
-      switch(processType) {
-        case kTop:
-        case kTT:
-        case kSignal:
-          pdgidTarget=6;
-          break;
-        case kV:
-          pdgidTarget=24;
-          break;
-        case kH:
-          pdgidTarget=25;
-          break;
-        default:
-          // processType>=kTT means we should never get here
-          PError("PandaAnalyzer::Run","Reached an unknown process type");
-      }
+    unsigned int pdgidTarget = FindGenObjects();
 
-      std::vector<int> targets;
-
-      int nGen = event.genParticles.size();
-      for (int iG=0; iG!=nGen; ++iG) {
-        auto& part(event.genParticles.at(iG));
-        int pdgid = part.pdgid;
-        unsigned int abspdgid = abs(pdgid);
-        if (abspdgid == pdgidTarget)
-          targets.push_back(iG);
-      } //looking for targets
-
-      for (int iG : targets) {
-        auto& part(event.genParticles.at(iG));
-
-        // check there is no further copy:
-        bool isLastCopy=true;
-        for (int jG : targets) {
-          if (event.genParticles.at(jG).parent.get() == &part) {
-            isLastCopy=false;
-            break;
-          }
-        }
-        if (!isLastCopy)
-          continue;
-
-        // (a) check it is a hadronic decay and if so, (b) calculate the size
-        if (processType==kTop||processType==kTT) {
-
-          // first look for a W whose parent is the top at iG, or a W further down the chain
-          panda::GenParticle const* lastW(0);
-          for (int jG=0; jG!=nGen; ++jG) {
-            GenParticle const& partW(event.genParticles.at(jG));
-            if (TMath::Abs(partW.pdgid)==24 && partW.pdgid*part.pdgid>0) {
-              // it's a W and has the same sign as the top
-              if (!lastW && partW.parent.get() == &part) {
-                lastW = &partW;
-              } else if (lastW && partW.parent.get() == lastW) {
-                lastW = &partW;
-              }
-            }
-          } // looking for W
-          if (!lastW) {// ???
-            continue;
-          }
-          auto& partW(*lastW);
-
-          // now look for b or W->qq
-          int iB=-1, iQ1=-1, iQ2=-1;
-          double size=0, sizeW=0;
-          for (int jG=0; jG!=nGen; ++jG) {
-            auto& partQ(event.genParticles.at(jG));
-            int pdgidQ = partQ.pdgid;
-            unsigned int abspdgidQ = TMath::Abs(pdgidQ);
-            if (abspdgidQ>5)
-              continue;
-            if (abspdgidQ==5 && iB<0 && partQ.parent.get() == &part) {
-              // only keep first copy
-              iB = jG;
-              size = TMath::Max(DeltaR2(part.eta(),part.phi(),partQ.eta(),partQ.phi()),size);
-            } else if (abspdgidQ<5 && partQ.parent.get() == &partW) {
-              if (iQ1<0) {
-                iQ1 = jG;
-                size = TMath::Max(DeltaR2(part.eta(),part.phi(),partQ.eta(),partQ.phi()),
-                         size);
-                sizeW = TMath::Max(DeltaR2(partW.eta(),partW.phi(),partQ.eta(),partQ.phi()),
-                         sizeW);
-              } else if (iQ2<0) {
-                iQ2 = jG;
-                size = TMath::Max(DeltaR2(part.eta(),part.phi(),partQ.eta(),partQ.phi()),
-                         size);
-                sizeW = TMath::Max(DeltaR2(partW.eta(),partW.phi(),partQ.eta(),partQ.phi()),
-                         sizeW);
-              }
-            }
-            if (iB>=0 && iQ1>=0 && iQ2>=0)
-              break;
-          } // looking for quarks
-
-
-          bool isHadronic = (iB>=0 && iQ1>=0 && iQ2>=0); // all 3 quarks were found
-          if (isHadronic)
-            genObjects[&part] = size;
-
-          bool isHadronicW = (iQ1>=0 && iQ2>=0);
-          if (isHadronicW)
-            genObjects[&partW] = sizeW;
-
-        } else { // these are W,Z,H - 2 prong decays
-
-          int iQ1=-1, iQ2=-1;
-          double size=0;
-          for (int jG=0; jG!=nGen; ++jG) {
-            auto& partQ(event.genParticles.at(jG));
-            int pdgidQ = partQ.pdgid;
-            unsigned int abspdgidQ = TMath::Abs(pdgidQ);
-            if (abspdgidQ>5)
-              continue;
-            if (partQ.parent.get() == &part) {
-              if (iQ1<0) {
-                iQ1=jG;
-                size = TMath::Max(DeltaR2(part.eta(),part.phi(),partQ.eta(),partQ.phi()),
-                         size);
-              } else if (iQ2<0) {
-                iQ2=jG;
-                size = TMath::Max(DeltaR2(part.eta(),part.phi(),partQ.eta(),partQ.phi()),
-                         size);
-              }
-            }
-            if (iQ1>=0 && iQ2>=0)
-              break;
-          } // looking for quarks
-
-          bool isHadronic = (iQ1>=0 && iQ2>=0); // both quarks were found
-
-          // add to collection
-          if (isHadronic)
-            genObjects[&part] = size;
-        }
-
-      } // loop over targets
-    } // process is interesting
+    if (!isData) {
+      BuildGenGrids();
+      flavourLabeller.SetGhosts(event.genParticles);
+    }
 
     tr.TriggerEvent("gen matching");
 
@@ -1856,23 +2513,15 @@ void PandaAnalyzer::Run() {
       vector<btagcand> sj_btagcands;
       vector<double> sj_sf_cent, sj_sf_bUp, sj_sf_bDown, sj_sf_mUp, sj_sf_mDown;
       unsigned int nSJ = fj1->subjets.size();
+      flavourLabeller.ClearJets();
       for (unsigned int iSJ=0; iSJ!=nSJ; ++iSJ) {
         auto& subjet = fj1->subjets.objAt(iSJ);
-        int flavor=0;
-        for (auto& gen : event.genParticles) {
-          int apdgid = abs(gen.pdgid);
-          if (apdgid==0 || (apdgid>5 && apdgid!=21)) // light quark or gluon
-            continue;
-          double dr2 = DeltaR2(subjet.eta(),subjet.phi(),gen.eta(),gen.phi());
-          if (dr2<0.09) {
-            if (apdgid==4 || apdgid==5) {
-              flavor=apdgid;
-              break;
-            } else {
-              flavor=0;
-            }
-          }
-        } // finding the subjet flavor
+        flavourLabeller.AddJet(subjet.pt(),subjet.eta(),subjet.phi());
+      }
+      flavourLabeller.Label(subjetRadius,fastjet::cambridge_algorithm);
+      for (unsigned int iSJ=0; iSJ!=nSJ; ++iSJ) {
+        auto& subjet = fj1->subjets.objAt(iSJ);
+        int flavor = flavourLabeller.GetFlavour(iSJ);
 
         float pt = subjet.pt();
         float btagUncFactor = 1;
@@ -1901,10 +2550,12 @@ void PandaAnalyzer::Run() {
       } // loop over subjets
 
       EvalBTagSF(sj_btagcands,sj_sf_cent,GeneralTree::bCent,GeneralTree::bSubJet);
-      EvalBTagSF(sj_btagcands,sj_sf_bUp,GeneralTree::bBUp,GeneralTree::bSubJet);
-      EvalBTagSF(sj_btagcands,sj_sf_bDown,GeneralTree::bBDown,GeneralTree::bSubJet);
-      EvalBTagSF(sj_btagcands,sj_sf_mUp,GeneralTree::bMUp,GeneralTree::bSubJet);
-      EvalBTagSF(sj_btagcands,sj_sf_mDown,GeneralTree::bMDown,GeneralTree::bSubJet);
+      if (doSubjetBTagShifts) {
+        EvalBTagSF(sj_btagcands,sj_sf_bUp,GeneralTree::bBUp,GeneralTree::bSubJet);
+        EvalBTagSF(sj_btagcands,sj_sf_bDown,GeneralTree::bBDown,GeneralTree::bSubJet);
+        EvalBTagSF(sj_btagcands,sj_sf_mUp,GeneralTree::bMUp,GeneralTree::bSubJet);
+        EvalBTagSF(sj_btagcands,sj_sf_mDown,GeneralTree::bMDown,GeneralTree::bSubJet);
+      }
 
     }
 
@@ -1918,28 +2569,23 @@ void PandaAnalyzer::Run() {
       vector<double> sf_cent_alt, sf_bUp_alt, sf_bDown_alt, sf_mUp_alt, sf_mDown_alt;
 
       unsigned int nJ = centralJets.size();
+      // chs jets: the constituents are not puppi-weighted
+      bool jetConstituents = flags["ghostConstituents"] && event.pfCandidates.size()>0;
+      flavourLabeller.ClearJets();
+      for (auto *jet : centralJets) {
+        if (jetConstituents)
+          flavourLabeller.AddJet(jet->pt(),jet->eta(),jet->phi(),jet->constituents,false);
+        else
+          flavourLabeller.AddJet(jet->pt(),jet->eta(),jet->phi());
+      }
+      flavourLabeller.Label(0.4,fastjet::antikt_algorithm);
       for (unsigned int iJ=0; iJ!=nJ; ++iJ) {
         panda::Jet *jet = centralJets.at(iJ);
         bool isIsoJet=false;
         if (std::find(isoJets.begin(), isoJets.end(), jet) != isoJets.end())
           isIsoJet = true;
-        int flavor=0;
-        float genpt=0;
-        for (auto& gen : event.genParticles) {
-          int apdgid = abs(gen.pdgid);
-          if (apdgid==0 || (apdgid>5 && apdgid!=21)) // light quark or gluon
-            continue;
-          double dr2 = DeltaR2(jet->eta(),jet->phi(),gen.eta(),gen.phi());
-          if (dr2<0.09) {
-            genpt = gen.pt();
-            if (apdgid==4 || apdgid==5) {
-              flavor=apdgid;
-              break;
-            } else {
-              flavor=0;
-            }
-          }
-        } // finding the jet flavor
+        int flavor = flavourLabeller.GetFlavour(iJ);
+        float genpt = flavourLabeller.GetGenPt(iJ);
         float pt = jet->pt();
         float btagUncFactor = 1;
         float eta = jet->eta();
@@ -1998,10 +2644,12 @@ void PandaAnalyzer::Run() {
       } // loop over jets
 
       EvalBTagSF(btagcands,sf_cent,GeneralTree::bCent,GeneralTree::bJet);
-      EvalBTagSF(btagcands,sf_bUp,GeneralTree::bBUp,GeneralTree::bJet);
-      EvalBTagSF(btagcands,sf_bDown,GeneralTree::bBDown,GeneralTree::bJet);
-      EvalBTagSF(btagcands,sf_mUp,GeneralTree::bMUp,GeneralTree::bJet);
-      EvalBTagSF(btagcands,sf_mDown,GeneralTree::bMDown,GeneralTree::bJet);
+      if (doBTagShifts) {
+        EvalBTagSF(btagcands,sf_bUp,GeneralTree::bBUp,GeneralTree::bJet);
+        EvalBTagSF(btagcands,sf_bDown,GeneralTree::bBDown,GeneralTree::bJet);
+        EvalBTagSF(btagcands,sf_mUp,GeneralTree::bMUp,GeneralTree::bJet);
+        EvalBTagSF(btagcands,sf_mDown,GeneralTree::bMDown,GeneralTree::bJet);
+      }
 
       /* // see above, also needs to use the new functions -SN
       if (flags["monohiggs"]) {
@@ -2021,163 +2669,16 @@ void PandaAnalyzer::Run() {
 
     tr.TriggerEvent("ak4 gen-matching");
 
-    // ttbar pT weight
-    gt->sf_tt = 1; gt->sf_tt_ext = 1; gt->sf_tt_bound = 1;
-    gt->sf_tt8TeV = 1; gt->sf_tt8TeV_ext = 1; gt->sf_tt8TeV_bound = 1;
-    gt->sf_qcdTT = 1;
-    if (!isData && processType==kTT) {
-      gt->genWPlusPt = -1; gt->genWMinusPt = -1;
-      for (auto& gen : event.genParticles) {
-        if (abs(gen.pdgid)!=24)
-          continue;
-        if (flags["firstGen"]) {
-          if (gen.parent.isValid() && gen.parent->pdgid==gen.pdgid)
-            continue; // must be first copy
-        }
-        if (gen.pdgid>0) {
-         gt->genWPlusPt = gen.pt();
-         gt->genWPlusEta = gen.eta();
-        } else {
-         gt->genWMinusPt = gen.pt();
-         gt->genWMinusEta = gen.eta();
-        }
-        if (flags["firstGen"]) {
-          if (gt->genWPlusPt>0 && gt->genWMinusPt>0)
-            break;
-        }
-      }
-      TLorentzVector vT,vTbar;
-      float pt_t=0, pt_tbar=0;
-      for (auto& gen : event.genParticles) {
-        if (abs(gen.pdgid)!=6)
-          continue;
-        if (flags["firstGen"]) {
-          if (gen.parent.isValid() && gen.parent->pdgid==gen.pdgid)
-            continue; // must be first copy
-        }
-        if (gen.pdgid>0) {
-         pt_t = gen.pt();
-         gt->genTopPt = gen.pt();
-         gt->genTopEta = gen.eta();
-         vT.SetPtEtaPhiM(gen.pt(),gen.eta(),gen.phi(),gen.m());
-        } else {
-         pt_tbar = gen.pt();
-         gt->genAntiTopPt = gen.pt();
-         gt->genAntiTopEta = gen.eta();
-         vTbar.SetPtEtaPhiM(gen.pt(),gen.eta(),gen.phi(),gen.m());
-        }
-        if (flags["firstGen"]) {
-          if (pt_t>0 && pt_tbar>0)
-            break;
-        }
-      }
-      if (pt_t>0 && pt_tbar>0) {
-        TLorentzVector vTT = vT+vTbar;
-        gt->genTTPt = vTT.Pt(); gt->genTTEta = vTT.Eta();
-        gt->sf_tt8TeV       = TMath::Sqrt(TMath::Exp(0.156-0.00137*TMath::Min((float)400.,pt_t)) *
-                         TMath::Exp(0.156-0.00137*TMath::Min((float)400.,pt_tbar)));
-        gt->sf_tt           = TMath::Sqrt(TMath::Exp(0.0615-0.0005*TMath::Min((float)400.,pt_t)) *
-                         TMath::Exp(0.0615-0.0005*TMath::Min((float)400.,pt_tbar)));
-        gt->sf_tt8TeV_ext   = TMath::Sqrt(TMath::Exp(0.156-0.00137*pt_t) *
-                         TMath::Exp(0.156-0.00137*pt_tbar));
-        gt->sf_tt_ext       = TMath::Sqrt(TMath::Exp(0.0615-0.0005*pt_t) *
-                         TMath::Exp(0.0615-0.0005*pt_tbar));
-        gt->sf_tt8TeV_bound = TMath::Sqrt(((pt_t>400) ? 1 : TMath::Exp(0.156-0.00137*pt_t)) *
-                         ((pt_tbar>400) ? 1 : TMath::Exp(0.156-0.00137*pt_tbar)));
-        gt->sf_tt_bound     = TMath::Sqrt(((pt_t>400) ? 1 : TMath::Exp(0.0615-0.0005*pt_t)) *
-                         ((pt_tbar>400) ? 1 : TMath::Exp(0.0615-0.0005*pt_tbar)));
-      }
-
-      if (pt_t>0)
-        gt->sf_qcdTT *= TTNLOToNNLO(pt_t);
-      if (pt_tbar>0) 
-        gt->sf_qcdTT *= TTNLOToNNLO(pt_tbar);
-      gt->sf_qcdTT = TMath::Sqrt(gt->sf_qcdTT);
-
-    }
+    FillTTbarGen();
 
     tr.TriggerEvent("tt SFs");
 
     // derive ewk/qcd weights
-    gt->sf_qcdV=1; gt->sf_ewkV=1;
-    gt->sf_qcdV_VBF=1;
-    if (!isData) {
-      bool found = processType!=kA && processType!=kZ && processType!=kW
-                     && processType!=kZEWK && processType!=kWEWK;
-      int target=24;
-      if (processType==kZ || processType==kZEWK) target=23;
-      if (processType==kA) target=22;
-
-      for (auto& gen : event.genParticles) {
-        if (found) break;
-        int apdgid = abs(gen.pdgid);
-        if (apdgid==target)     {
-          if (gen.parent.isValid() && gen.parent->pdgid==gen.pdgid)
-            continue;
-          if (processType==kZ) {
-            gt->trueGenBosonPt = gen.pt();
-            gt->genBosonPt = bound(gen.pt(),genBosonPtMin,genBosonPtMax);
-            gt->sf_qcdV = GetCorr(cZNLO,gt->genBosonPt);
-            gt->sf_ewkV = GetCorr(cZEWK,gt->genBosonPt);
-            gt->sf_qcdV_VBF = GetCorr(cVBF_ZNLO,gt->genBosonPt);
-            found=true;
-          } else if (processType==kW) {
-            gt->trueGenBosonPt = gen.pt();
-            gt->genBosonPt = bound(gen.pt(),genBosonPtMin,genBosonPtMax);
-            gt->sf_qcdV = GetCorr(cWNLO,gt->genBosonPt);
-            gt->sf_ewkV = GetCorr(cWEWK,gt->genBosonPt);
-            gt->sf_qcdV_VBF = GetCorr(cVBF_WNLO,gt->genBosonPt);
-            found=true;
-          } else if (processType==kZEWK) {
-            gt->trueGenBosonPt = gen.pt();
-            gt->genBosonPt = bound(gen.pt(),genBosonPtMin,genBosonPtMax);
-            gt->sf_qcdV_VBF = GetCorr(cVBF_EWKZ,gt->genBosonPt,gt->jot12Mass);
-          } else if (processType==kWEWK) {
-            gt->trueGenBosonPt = gen.pt();
-            gt->genBosonPt = bound(gen.pt(),genBosonPtMin,genBosonPtMax);
-            gt->sf_qcdV_VBF = GetCorr(cVBF_EWKW,gt->genBosonPt,gt->jot12Mass);
-          } else if (processType==kA) {
-            // take the highest pT
-            if (gen.pt() > gt->trueGenBosonPt) {
-              gt->trueGenBosonPt = gen.pt();
-              gt->genBosonPt = bound(gen.pt(),genBosonPtMin,genBosonPtMax);
-              gt->sf_qcdV = GetCorr(cANLO,gt->genBosonPt);
-              gt->sf_ewkV = GetCorr(cAEWK,gt->genBosonPt);
-              gt->sf_qcdV2j = GetCorr(cANLO2j,gt->genBosonPt);
-            }
-          }
-        } // target matches
-      }
-    }
+    FillBosonSFs(genBosonPtMin,genBosonPtMax);
 
     tr.TriggerEvent("qcd/ewk SFs");
 
-    if (!isData && processType==kSignal) {
-      bool found=false, foundbar=false;
-      TLorentzVector vMediator(0,0,0,0);
-      for (auto& gen : event.genParticles) {
-        if (found && foundbar)
-          break;
-        if (abs(gen.pdgid) != 18)
-          continue;
-        if (gen.parent.isValid() && gen.parent->pdgid == gen.pdgid)
-          continue;
-        if (gen.pdgid == 18 && !found) {
-          found = true;
-          vMediator += gen.p4();
-        } else if (gen.pdgid == -18 && !foundbar) {
-          foundbar = true;
-          vMediator += gen.p4();
-        }
-      }
-      if (found && foundbar) {
-        gt->trueGenBosonPt = vMediator.Pt();
-        gt->genBosonPt = bound(gt->trueGenBosonPt,175,1200);
-      }
-      // gt->trueGenBosonPt = event.genMet.pt;
-      // gt->genBosonPt = bound(gt->trueGenBosonPt,175,1200);
-      // tr.TriggerEvent("signal gen kinematics");
-    }
+    FillSignalGen();
 
     //lepton SFs
     gt->sf_lepID=1; gt->sf_lepIso=1; gt->sf_lepTrack=1;
@@ -2220,49 +2721,83 @@ void PandaAnalyzer::Run() {
     tr.TriggerEvent("photon SFs");
 
     // scale and PDF weights, if they exist
-    gt->scaleUp = 1; gt->scaleDown = 1;
-    gt->pdfUp = 1; gt->pdfDown = 1;
-    if (!isData) {
-      gt->pdfUp = 1 + event.genReweight.pdfDW;
-      gt->pdfDown = 1 - event.genReweight.pdfDW;
-      auto &genReweight = event.genReweight;
-      for (unsigned iS=0; iS!=6; ++iS) {
-        float s=1;
-        switch (iS) {
-          case 0:
-            s = genReweight.r1f2DW; break;
-          case 1:
-            s = genReweight.r1f5DW; break;
-          case 2:
-            s = genReweight.r2f1DW; break;
-          case 3:
-            s = genReweight.r2f2DW; break;
-          case 4:
-            s = genReweight.r5f1DW; break;
-          case 5:
-            s = genReweight.r5f5DW; break;
-          default:
-            break;
-        }
-        gt->scale[iS] = s; 
-        gt->scaleUp = max(float(gt->scaleUp),float(s));
-        gt->scaleDown = min(float(gt->scaleDown),float(s));
-      }
-      tr.TriggerEvent("qcd uncertainties");
-
-      unsigned nW = wIDs.size();
-      if (nW) {
-        for (unsigned iW=0; iW!=nW; ++iW) {
-          gt->signal_weights[wIDs[iW]] = event.genReweight.genParam[iW];
-        }
-      }
-    }
+    FillGenWeights();
+    tr.TriggerEvent("qcd uncertainties");
 
     gt->Fill();
+    if (constWriter)
+      WriteConstituentRecord();
 
   } // entry loop
 
+  if (skipBadLumis)
+    PInfo("PandaAnalyzer::Run",TString::Format("Skipped %lld entries in lumis failing the JSON",lumiIndex.GetNSkipped()));
   if (DEBUG) { PDebug("PandaAnalyzer::Run","Done with entry loop"); }
 
 } // Run()
 
+
+void PandaAnalyzer::RunGenOnly(unsigned int nZero, unsigned int nEvents, 
+                               float genBosonPtMin, float genBosonPtMax) {
+  // only the gen branches are read (see Init), and none of the reco code runs
+
+  unsigned int iE=0;
+  ProgressReporter pr("PandaAnalyzer::RunGenOnly",&iE,&nEvents,10);
+  TimeReporter tr("PandaAnalyzer::RunGenOnly",DEBUG);
+
+  for (iE=nZero; iE!=nEvents; ++iE) {
+    tr.Start();
+    pr.Report();
+    ResetBranches();
+    event.getEntry(*tIn,iE);
+
+    tr.TriggerEvent(TString::Format("GetEntry %u",iE));
+
+    gt->mcWeight = event.weight;
+    gt->runNumber = event.runNumber;
+    gt->lumiNumber = event.lumiNumber;
+    gt->eventNumber = event.eventNumber;
+
+    // without reco fatjets, fj1 gen info describes the hardest hadronic target
+    unsigned int pdgidTarget = FindGenObjects();
+    panda::GenParticle const *hardest=0, *hardestW=0;
+    for (auto &iG : genObjects) {
+      unsigned int apdgid = abs(iG.first->pdgid);
+      if (apdgid==pdgidTarget && (!hardest || iG.first->pt()>hardest->pt()))
+        hardest = iG.first;
+      else if (pdgidTarget==6 && apdgid==24 && (!hardestW || iG.first->pt()>hardestW->pt()))
+        hardestW = iG.first;
+    }
+    if (hardest) {
+      gt->fj1IsMatched = 1;
+      gt->fj1GenPt = hardest->pt();
+      gt->fj1GenSize = genObjects[hardest];
+    }
+    if (hardestW) {
+      gt->fj1IsWMatched = 1;
+      gt->fj1GenWPt = hardestW->pt();
+      gt->fj1GenWSize = genObjects[hardestW];
+    }
+
+    tr.TriggerEvent("gen matching");
+
+    FillTTbarGen();
+
+    tr.TriggerEvent("tt SFs");
+
+    FillBosonSFs(genBosonPtMin,genBosonPtMax);
+    FillSignalGen();
+
+    tr.TriggerEvent("qcd/ewk SFs");
+
+    FillGenWeights();
+
+    tr.TriggerEvent("qcd uncertainties");
+
+    gt->Fill();
+
+  } // entry loop
+
+  if (DEBUG) { PDebug("PandaAnalyzer::RunGenOnly","Done with entry loop"); }
+
+} // RunGenOnly()
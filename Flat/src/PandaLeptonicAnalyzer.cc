@@ -22,6 +22,7 @@ PandaLeptonicAnalyzer::PandaLeptonicAnalyzer(int debug_/*=0*/) {
   flags["applyJSON"] = true;
   flags["genOnly"]   = false;
   flags["lepton"]    = false;
+  flags["ghostConstituents"] = false;
   if (DEBUG) PDebug("PandaLeptonicAnalyzer::PandaLeptonicAnalyzer","Called constructor");
 }
 
@@ -41,10 +42,13 @@ void PandaLeptonicAnalyzer::ResetBranches() {
 }
 
 
-void PandaLeptonicAnalyzer::SetOutputFile(TString fOutName) {
+void PandaLeptonicAnalyzer::SetOutputFile(TString fOutName, TString profile) {
   fOut = new TFile(fOutName,"RECREATE");
   tOut = new TTree("events","events");
 
+  if (gt->SetOutputProfile(profile) && profile!="default")
+    fOut->SetCompressionSettings(gt->GetCompression());
+
   fOut->WriteTObject(hDTotalMCWeight);
 
   // fill the signal weights
@@ -53,6 +57,10 @@ void PandaLeptonicAnalyzer::SetOutputFile(TString fOutName) {
 
   // Build the input tree here 
   gt->WriteTree(tOut);
+  if (ntupleOutput)
+    ntupleOutput = gt->StartNTupleOutput(fOut);
+  else if (nWriterRows>0)
+    gt->StartAsyncWriter(nWriterRows);
 
   if (DEBUG) PDebug("PandaLeptonicAnalyzer::SetOutputFile","Created output in "+fOutName);
 }
@@ -100,6 +108,8 @@ int PandaLeptonicAnalyzer::Init(TTree *t, TH1D *hweights, TTree *weightNames)
    readlist.push_back("genReweight");
    readlist.push_back("partons");
    readlist.push_back("ak4GenJets");
+   if (flags["ghostConstituents"])
+     readlist.push_back("pfCandidates");
   }
 
   event.setAddress(*t, readlist); // pass the readlist so only the relevant branches are turned on
@@ -394,6 +404,58 @@ int PandaLeptonicAnalyzer::Init(TTree *t, TH1D *hweights, TTree *weightNames)
   for(int i=0; i<4; i++) hDWWN0JET_NNLOPart[i] = new TH1D(Form("hDWWN0JET_NNLO_%d",i) ,Form("hDWWN0JET_NNLO_%d",i), nBinWWN0JET, xbinsWWN0JET);
   for(int i=0; i<4; i++) hDWWNJET_NNLOPart[i] = new TH1D(Form("hDWWNJET_NNLO_%d",i) ,Form("hDWWNJET_NNLO_%d",i), nBinWWN0JET, xbinsWWN0JET);
 
+  // columns: nominal, PDF, the six QCD scales and, for WW, the four NNLO parts
+  auto bank = [this](TH1D *h, TH1D *hPDF, TH1D **hQCDPart, TH1D **hNNLOPart) {
+    std::vector<TH1D*> hists = {h,hPDF};
+    hists.insert(hists.end(),hQCDPart,hQCDPart+6);
+    if (hNNLOPart)
+      hists.insert(hists.end(),hNNLOPart,hNNLOPart+4);
+    banks.push_back(new HistogramBank(hists));
+    return banks.back();
+  };
+  bDDilPtMM = bank(hDDilPtMM,hDDilPtMM_PDF,hDDilPtMM_QCDPart,0);
+  bDDilPtEE = bank(hDDilPtEE,hDDilPtEE_PDF,hDDilPtEE_QCDPart,0);
+  bDDilHighPtIncMM = bank(hDDilHighPtIncMM,hDDilHighPtIncMM_PDF,hDDilHighPtIncMM_QCDPart,0);
+  bDDilHighPtIncEE = bank(hDDilHighPtIncEE,hDDilHighPtIncEE_PDF,hDDilHighPtIncEE_QCDPart,0);
+  bDDilHighPtMM = bank(hDDilHighPtMM,hDDilHighPtMM_PDF,hDDilHighPtMM_QCDPart,0);
+  bDDilHighPtEE = bank(hDDilHighPtEE,hDDilHighPtEE_PDF,hDDilHighPtEE_QCDPart,0);
+  bDDilHighPtNN = bank(hDDilHighPtNN,hDDilHighPtNN_PDF,hDDilHighPtNN_QCDPart,0);
+  bDFidHighPtNN = bank(hDFidHighPtNN,hDFidHighPtNN_PDF,hDFidHighPtNN_QCDPart,0);
+  bDDilRapMM = bank(hDDilRapMM,hDDilRapMM_PDF,hDDilRapMM_QCDPart,0);
+  bDDilRapEE = bank(hDDilRapEE,hDDilRapEE_PDF,hDDilRapEE_QCDPart,0);
+  bDDilPhiStarMM = bank(hDDilPhiStarMM,hDDilPhiStarMM_PDF,hDDilPhiStarMM_QCDPart,0);
+  bDDilPhiStarEE = bank(hDDilPhiStarEE,hDDilPhiStarEE_PDF,hDDilPhiStarEE_QCDPart,0);
+  bDDilPtRap0MM = bank(hDDilPtRap0MM,hDDilPtRap0MM_PDF,hDDilPtRap0MM_QCDPart,0);
+  bDDilPtRap0EE = bank(hDDilPtRap0EE,hDDilPtRap0EE_PDF,hDDilPtRap0EE_QCDPart,0);
+  bDDilPtRap1MM = bank(hDDilPtRap1MM,hDDilPtRap1MM_PDF,hDDilPtRap1MM_QCDPart,0);
+  bDDilPtRap1EE = bank(hDDilPtRap1EE,hDDilPtRap1EE_PDF,hDDilPtRap1EE_QCDPart,0);
+  bDDilPtRap2MM = bank(hDDilPtRap2MM,hDDilPtRap2MM_PDF,hDDilPtRap2MM_QCDPart,0);
+  bDDilPtRap2EE = bank(hDDilPtRap2EE,hDDilPtRap2EE_PDF,hDDilPtRap2EE_QCDPart,0);
+  bDDilPtRap3MM = bank(hDDilPtRap3MM,hDDilPtRap3MM_PDF,hDDilPtRap3MM_QCDPart,0);
+  bDDilPtRap3EE = bank(hDDilPtRap3EE,hDDilPtRap3EE_PDF,hDDilPtRap3EE_QCDPart,0);
+  bDDilPtRap4MM = bank(hDDilPtRap4MM,hDDilPtRap4MM_PDF,hDDilPtRap4MM_QCDPart,0);
+  bDDilPtRap4EE = bank(hDDilPtRap4EE,hDDilPtRap4EE_PDF,hDDilPtRap4EE_QCDPart,0);
+  bDSSWWMJJQCD = bank(hDSSWWMJJQCD,hDSSWWMJJQCD_PDF,hDSSWWMJJQCD_QCDPart,0);
+  bDSSWWMJJ = bank(hDSSWWMJJ,hDSSWWMJJ_PDF,hDSSWWMJJ_QCDPart,0);
+  bDSSWWMLL = bank(hDSSWWMLL,hDSSWWMLL_PDF,hDSSWWMLL_QCDPart,0);
+  bDSSWWPTL1 = bank(hDSSWWPTL1,hDSSWWPTL1_PDF,hDSSWWPTL1_QCDPart,0);
+  bDNoEWKCorrSSWWMJJ = bank(hDNoEWKCorrSSWWMJJ,hDNoEWKCorrSSWWMJJ_PDF,hDNoEWKCorrSSWWMJJ_QCDPart,0);
+  bDNoEWKCorrSSWWMLL = bank(hDNoEWKCorrSSWWMLL,hDNoEWKCorrSSWWMLL_PDF,hDNoEWKCorrSSWWMLL_QCDPart,0);
+  bDNoEWKCorrSSWWPTL1 = bank(hDNoEWKCorrSSWWPTL1,hDNoEWKCorrSSWWPTL1_PDF,hDNoEWKCorrSSWWPTL1_QCDPart,0);
+  bDWZMJJ = bank(hDWZMJJ,hDWZMJJ_PDF,hDWZMJJ_QCDPart,0);
+  bDNoEWKCorrWZMJJ = bank(hDNoEWKCorrWZMJJ,hDNoEWKCorrWZMJJ_PDF,hDNoEWKCorrWZMJJ_QCDPart,0);
+  bDWWMLL = bank(hDWWMLL,hDWWMLL_PDF,hDWWMLL_QCDPart,hDWWMLL_NNLOPart);
+  bDWWDPHILL = bank(hDWWDPHILL,hDWWDPHILL_PDF,hDWWDPHILL_QCDPart,hDWWDPHILL_NNLOPart);
+  bDWWPTL1 = bank(hDWWPTL1,hDWWPTL1_PDF,hDWWPTL1_QCDPart,hDWWPTL1_NNLOPart);
+  bDWWPTL2 = bank(hDWWPTL2,hDWWPTL2_PDF,hDWWPTL2_QCDPart,hDWWPTL2_NNLOPart);
+  bDWWPTLL = bank(hDWWPTLL,hDWWPTLL_PDF,hDWWPTLL_QCDPart,hDWWPTLL_NNLOPart);
+  bDWWMLL0JET = bank(hDWWMLL0JET,hDWWMLL0JET_PDF,hDWWMLL0JET_QCDPart,hDWWMLL0JET_NNLOPart);
+  bDWWDPHILL0JET = bank(hDWWDPHILL0JET,hDWWDPHILL0JET_PDF,hDWWDPHILL0JET_QCDPart,hDWWDPHILL0JET_NNLOPart);
+  bDWWPTL10JET = bank(hDWWPTL10JET,hDWWPTL10JET_PDF,hDWWPTL10JET_QCDPart,hDWWPTL10JET_NNLOPart);
+  bDWWPTL20JET = bank(hDWWPTL20JET,hDWWPTL20JET_PDF,hDWWPTL20JET_QCDPart,hDWWPTL20JET_NNLOPart);
+  bDWWPTLL0JET = bank(hDWWPTLL0JET,hDWWPTLL0JET_PDF,hDWWPTLL0JET_QCDPart,hDWWPTLL0JET_NNLOPart);
+  bDWWN0JET = bank(hDWWN0JET,hDWWN0JET_PDF,hDWWN0JET_QCDPart,hDWWN0JET_NNLOPart);
+
   if (weightNames) {
     //if (weightNames->GetEntries()!=377 && weightNames->GetEntries()!=22) {
     //  PError("PandaLeptonicAnalyzer::Init",
@@ -457,6 +519,12 @@ panda::GenParticle const *PandaLeptonicAnalyzer::MatchToGen(double eta, double p
 
 
 void PandaLeptonicAnalyzer::Terminate() {
+  for (auto *b : banks) {
+    b->Unload();
+    delete b;
+  }
+  banks.clear();
+
   {
     printf("hDDilPtMM: (%f/%f/%f/%f/%f/%f->%f)\n",
   	    hDDilPtMM_QCDPart[0]->GetSumOfWeights(),hDDilPtMM_QCDPart[1]->GetSumOfWeights(),hDDilPtMM_QCDPart[2]->GetSumOfWeights(),
@@ -1269,7 +1337,12 @@ void PandaLeptonicAnalyzer::Terminate() {
     }
   }
 
-  fOut->WriteTObject(tOut);
+  gt->FinishWriting();
+  if (!gt->HasNTuple()) {
+    tOut->FlushBaskets();
+    gt->PrintBranchSizes();
+    fOut->WriteTObject(tOut);
+  }
 /*
   for(int i=0; i<nBinEta; i++){
     fOut->WriteTObject(hDRecoMuon_P[i]);
@@ -1363,6 +1436,11 @@ void PandaLeptonicAnalyzer::Terminate() {
 
   delete ak4JERReader;
   
+  if (triggerMenu.GetNPaths()>0) {
+    for (auto &path : triggerMenu.GetDeadPaths())
+      PInfo("PandaLeptonicAnalyzer::Terminate","Trigger never fired: "+path);
+  }
+
   delete hDTotalMCWeight;
 /*
   for(int i=0; i<nBinEta; i++){
@@ -1568,40 +1646,18 @@ void PandaLeptonicAnalyzer::SetDataDir(const char *s2) {
 }
 
 void PandaLeptonicAnalyzer::AddGoodLumiRange(int run, int l0, int l1) {
-  auto run_ = goodLumis.find(run);
-  if (run_==goodLumis.end()) { // don't know about this run yet
-    std::vector<LumiRange> newLumiList;
-    newLumiList.emplace_back(l0,l1);
-    goodLumis[run] = newLumiList;
-  } else {
-    run_->second.emplace_back(l0,l1);
-  }
+  goodLumis.AddRange(run,l0,l1);
 }
 
-bool PandaLeptonicAnalyzer::PassGoodLumis(int run, int lumi) {
-  auto run_ = goodLumis.find(run);
-  if (run_==goodLumis.end()) {
-    // matched no run
-    if (DEBUG) 
-      PDebug("PandaLeptonicAnalyzer::PassGoodLumis",TString::Format("Failing run=%i",run));
-    return false;
-  }
-
-  // found the run, now look for a lumi range
-  for (auto &range : run_->second) {
-    if (range.Contains(lumi)) {
-      if (DEBUG) 
-        PDebug("PandaLeptonicAnalyzer::PassGoodLumis",TString::Format("Accepting run=%i, lumi=%i",run,lumi));
-      return true;
-    }
-  }
 
-  // matched no lumi range
+bool PandaLeptonicAnalyzer::PassGoodLumis(int run, int lumi) {
+  bool pass = goodLumis.Pass(run,lumi);
   if (DEBUG) 
-    PDebug("PandaLeptonicAnalyzer::PassGoodLumis",TString::Format("Failing run=%i, lumi=%i",run,lumi));
-  return false;
+    PDebug("PandaLeptonicAnalyzer::PassGoodLumis",TString::Format("%s run=%i, lumi=%i",pass ? "Accepting" : "Failing",run,lumi));
+  return pass;
 }
 
+
 bool PandaLeptonicAnalyzer::PassPreselection() {
 
   if (preselBits==0)
@@ -1684,12 +1740,9 @@ void PandaLeptonicAnalyzer::EvalBTagSF(std::vector<btagcand> &cands, std::vector
     sfGT0 = (1-prob_data0)/(1-prob_mc0);
   }
 
-  GeneralLeptonicTree::BTagParams p;
-  p.shift = shift;
-  p.jet = jettype;
-  p.tag=GeneralLeptonicTree::b0; gt->sf_btags[p] = sf0;
-  p.tag=GeneralLeptonicTree::b1; gt->sf_btags[p] = sf1;
-  p.tag=GeneralLeptonicTree::bGT0; gt->sf_btags[p] = sfGT0;
+  gt->sf_btags[GeneralLeptonicTree::sf_btagsIndex(jettype,GeneralLeptonicTree::b0,shift)] = sf0;
+  gt->sf_btags[GeneralLeptonicTree::sf_btagsIndex(jettype,GeneralLeptonicTree::b1,shift)] = sf1;
+  gt->sf_btags[GeneralLeptonicTree::sf_btagsIndex(jettype,GeneralLeptonicTree::bGT0,shift)] = sfGT0;
 
   if (do2) {
     float prob_mc2=0, prob_data2=0;
@@ -1715,16 +1768,16 @@ void PandaLeptonicAnalyzer::EvalBTagSF(std::vector<btagcand> &cands, std::vector
       sf2 = prob_data2/prob_mc2;
     }
 
-    p.tag=GeneralLeptonicTree::b2; gt->sf_btags[p] = sf2;
+    gt->sf_btags[GeneralLeptonicTree::sf_btagsIndex(jettype,GeneralLeptonicTree::b2,shift)] = sf2;
   }
 
 }
 
-void PandaLeptonicAnalyzer::RegisterTrigger(TString path, std::vector<unsigned> &idxs) {
+void PandaLeptonicAnalyzer::RegisterTrigger(TString path, unsigned groupBit) {
   unsigned idx = event.registerTrigger(path);
   if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::RegisterTrigger",
             TString::Format("At %u found trigger=%s",idx,path.Data()));
-  idxs.push_back(idx);
+  triggerMenu.AddPath(groupBit,path,idx);
 }
 
 // run
@@ -1765,17 +1818,6 @@ void PandaLeptonicAnalyzer::Run() {
   JetCorrectionUncertainty *uncReaderAK4=0;
   FactorizedJetCorrector *scaleReaderAK4=0;
 
-  std::vector<unsigned int> metTriggers;
-  std::vector<unsigned int> phoTriggers;
-  std::vector<unsigned int> muegTriggers;
-  std::vector<unsigned int> mumuTriggers;
-  std::vector<unsigned int> muTriggers;
-  std::vector<unsigned int> muTagTriggers;
-  std::vector<unsigned int> muFakeTriggers;
-  std::vector<unsigned int> egegTriggers;
-  std::vector<unsigned int> egTriggers;
-  std::vector<unsigned int> egTagTriggers;
-  std::vector<unsigned int> egFakeTriggers;
 
   if (1) {
     std::vector<TString> metTriggerPaths = {
@@ -1882,50 +1924,76 @@ void PandaLeptonicAnalyzer::Run() {
 
     if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::Run","Loading MET triggers");
     for (auto path : metTriggerPaths) {
-      RegisterTrigger(path,metTriggers);
+      RegisterTrigger(path,kMETTrig);
     }
     if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::Run","Loading SinglePhoton triggers");
     for (auto path : phoTriggerPaths) {
-      RegisterTrigger(path,phoTriggers);
+      RegisterTrigger(path,kSinglePhoTrig);
     }
     if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::Run","Loading MuEG triggers");
     for (auto path : muegTriggerPaths) {
-      RegisterTrigger(path,muegTriggers);
+      RegisterTrigger(path,kMuEGTrig);
     }
     if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::Run","Loading MuMu triggers");
     for (auto path : mumuTriggerPaths) {
-      RegisterTrigger(path,mumuTriggers);
+      RegisterTrigger(path,kMuMuTrig);
     }
     if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::Run","Loading Mu triggers");
     for (auto path : muTriggerPaths) {
-      RegisterTrigger(path,muTriggers);
+      RegisterTrigger(path,kMuTrig);
     }
     if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::Run","Loading MuTag triggers");
     for (auto path : muTagTriggerPaths) {
-      RegisterTrigger(path,muTagTriggers);
+      RegisterTrigger(path,kMuTagTrig);
     }
     if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::Run","Loading MuFake triggers");
     for (auto path : muFakeTriggerPaths) {
-      RegisterTrigger(path,muFakeTriggers);
+      RegisterTrigger(path,kMuFakeTrig);
     }
     if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::Run","Loading EGEG triggers");
     for (auto path : egegTriggerPaths) {
-      RegisterTrigger(path,egegTriggers);
+      RegisterTrigger(path,kEGEGTrig);
     }
     if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::Run","Loading EG triggers");
     for (auto path : egTriggerPaths) {
-      RegisterTrigger(path,egTriggers);
+      RegisterTrigger(path,kEGTrig);
     }
     if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::Run","Loading EGTag triggers");
     for (auto path : egTagTriggerPaths) {
-      RegisterTrigger(path,egTagTriggers);
+      RegisterTrigger(path,kEGTagTrig);
     }
     if (DEBUG>1) PDebug("PandaLeptonicAnalyzer::Run","Loading EGFake triggers");
     for (auto path : egFakeTriggerPaths) {
-      RegisterTrigger(path,egFakeTriggers);
-    }
-
-  }
+      RegisterTrigger(path,kEGFakeTrig);
+    }
+
+  }
+
+  // HLT filters for lepton-object matching, looked up once per event
+  muTrigFilters = trigObjMatcher.AddFilters({
+        "hltL3crIsoL1sMu22L1f0L2f10QL3f24QL3trkIsoFiltered0p09", // HLT_IsoMu24
+        "hltL3fL1sMu22L1f0Tkf24QL3trkIsoFiltered0p09",           // HLT_IsoTkMu24
+        "hltL3crIsoL1sMu20L1f0L2f10QL3f22QL3trkIsoFiltered0p09", // HLT_IsoMu22
+        "hltL3fL1sMu20L1f0Tkf22QL3trkIsoFiltered0p09",           // HLT_IsoTkMu22
+        "hltL3fL1sMu22Or25L1f0L2f10QL3Filtered50Q"               // HLT_Mu50
+  });
+  muFakeTrigFilters = trigObjMatcher.AddFilters({
+        "hltL3fL1sMu5L1f0L2f5L3Filtered8TkIsoFiltered0p4",       // HLT_Mu8_TrkIsoVVL
+        "hltL3fL1sMu1lqL1f0L2f10L3Filtered17TkIsoFiltered0p4"    // HLT_Mu17_TrkIsoVVL
+  });
+  eleTrigFilters = trigObjMatcher.AddFilters({
+        "hltEle105CaloIdVTGsfTrkIdTGsfDphiFilter",               // HLT_Ele105_CaloIdVT_GsfTrkIdT
+        "hltEle115CaloIdVTGsfTrkIdTGsfDphiFilter",               // HLT_Ele115_CaloIdVT_GsfTrkIdT
+        "hltEle25erWPTightGsfTrackIsoFilter",                    // HLT_Ele25_eta2p1_WPTight_Gsf
+        "hltEle27WPTightGsfTrackIsoFilter",                      // HLT_Ele27_WPTight_Gsf
+        "hltEle27erWPTightGsfTrackIsoFilter",                    // HLT_Ele27_eta2p1_WPTight_Gsf
+        "hltEle27erWPLooseGsfTrackIsoFilter"                     // HLT_Ele27_eta2p1_WPLoose_Gsf
+  });
+  eleFakeTrigFilters = trigObjMatcher.AddFilters({
+        "hltEle12PFJet30EleCleaned",                             // HLT_Ele12_CaloIdL_TrackIdL_IsoVL_PFJet30
+        "hltEle17PFJet30EleCleaned",                             // HLT_Ele17_CaloIdL_TrackIdL_IsoVL_PFJet30
+        "hltEle23PFJet30EleCleaned"                              // HLT_Ele23_CaloIdL_TrackIdL_IsoVL_PFJet30
+  });
 
   float EGMSCALE = isData ? 1 : 1;
 
@@ -1935,9 +2003,16 @@ void PandaLeptonicAnalyzer::Run() {
   TimeReporter tr("PandaLeptonicAnalyzer::Run",DEBUG);
 
   bool applyJSON = flags["applyJSON"];
+  // on data, entries of lumis failing the JSON are skipped without being read
+  bool skipBadLumis = isData && applyJSON && lumiIndex.Build(tIn,nZero,nEvents);
 
   // EVENTLOOP --------------------------------------------------------------------------
   for (iE=nZero; iE!=nEvents; ++iE) {
+    if (skipBadLumis) {
+      iE = lumiIndex.NextGood(iE,goodLumis);
+      if (iE==nEvents)
+        break;
+    }
     tr.Start();
     pr.Report();
     ResetBranches();
@@ -1986,72 +2061,8 @@ void PandaLeptonicAnalyzer::Run() {
     else                           gt->zPos = 0.0;
 
     // save triggers
-    for (auto iT : metTriggers) {
-     if (event.triggerFired(iT)) {
-      gt->trigger |= kMETTrig;
-      break;
-     }
-    }
-    for (auto iT : phoTriggers) {
-     if (event.triggerFired(iT)) {
-      gt->trigger |= kSinglePhoTrig;
-      break;
-     }
-    }
-    for (auto iT : muegTriggers) {
-     if (event.triggerFired(iT)) {
-      gt->trigger |= kMuEGTrig;
-      break;
-     }
-    }
-    for (auto iT : mumuTriggers) {
-     if (event.triggerFired(iT)) {
-      gt->trigger |= kMuMuTrig;
-      break;
-     }
-    }
-    for (auto iT : muTriggers) {
-     if (event.triggerFired(iT)) {
-      gt->trigger |= kMuTrig;
-      break;
-     }
-    }
-    for (auto iT : muTagTriggers) {
-     if (event.triggerFired(iT)) {
-      gt->trigger |= kMuTagTrig;
-      break;
-     }
-    }
-    for (auto iT : muFakeTriggers) {
-     if (event.triggerFired(iT)) {
-      gt->trigger |= kMuFakeTrig;
-      break;
-     }
-    }
-    for (auto iT : egegTriggers) {
-     if (event.triggerFired(iT)) {
-      gt->trigger |= kEGEGTrig;
-      break;
-     }
-    }
-    for (auto iT : egTriggers) {
-     if (event.triggerFired(iT)) {
-      gt->trigger |= kEGTrig;
-      break;
-     }
-    }
-    for (auto iT : egTagTriggers) {
-     if (event.triggerFired(iT)) {
-      gt->trigger |= kEGTagTrig;
-      break;
-     }
-    }
-    for (auto iT : egFakeTriggers) {
-     if (event.triggerFired(iT)) {
-      gt->trigger |= kEGFakeTrig;
-      break;
-     }
-    }
+    gt->trigger |= triggerMenu.Evaluate(event,event.runNumber);
+    trigObjMatcher.Index(event.triggerObjects);
 
     if (isData) {
       // check the json
@@ -2243,43 +2254,12 @@ void PandaLeptonicAnalyzer::Run() {
         bool isMedium = (mu->medium || mu-> mediumBtoF) && mu->combIso()/mu->pt() < 0.15;
         bool isTight  = mu->tight  && mu->combIso()/mu->pt() < 0.15;
         bool isDxyz   = MuonIP(mu->dxy,mu->dz);
-	bool isTrigger = false;
-
-        for (auto& trigObj : event.triggerObjects.filterObjects("hltL3crIsoL1sMu22L1f0L2f10QL3f24QL3trkIsoFiltered0p09")) { // HLT_IsoMu24
-         if (trigObj->pt() > 0 && mu->pt() > 0 && trigObj->dR(*mu) < 0.1) isTrigger = true;
-        }
-	if(isTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltL3fL1sMu22L1f0Tkf24QL3trkIsoFiltered0p09")) { // HLT_IsoTkMu24
-           if (trigObj->pt() > 0 && mu->pt() > 0 && trigObj->dR(*mu) < 0.1) isTrigger = true;
-          }
-	}
-	if(isTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltL3crIsoL1sMu20L1f0L2f10QL3f22QL3trkIsoFiltered0p09")) { // HLT_IsoMu22
-           if (trigObj->pt() > 0 && mu->pt() > 0 && trigObj->dR(*mu) < 0.1) isTrigger = true;
-          }
-	}
-	if(isTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltL3fL1sMu20L1f0Tkf22QL3trkIsoFiltered0p09")) { // HLT_IsoTkMu22
-           if (trigObj->pt() > 0 && mu->pt() > 0 && trigObj->dR(*mu) < 0.1) isTrigger = true;
-          }
-	}
-	if(isTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltL3fL1sMu22Or25L1f0L2f10QL3Filtered50Q")) { // HLT_Mu50
-           if (trigObj->pt() > 0 && mu->pt() > 0 && trigObj->dR(*mu) < 0.1) isTrigger = true;
-          }
-	}
+        uint64_t passedFilters = trigObjMatcher.Match(*mu);
+        bool isTrigger = (passedFilters & muTrigFilters)!=0;
 
         isTrigger = isTrigger || mu->triggerMatch[panda::Muon::fIsoMu24] || mu->triggerMatch[panda::Muon::fIsoTkMu24] || mu->triggerMatch[panda::Muon::fIsoMu22er] || mu->triggerMatch[panda::Muon::fIsoTkMu22er] || mu->triggerMatch[panda::Muon::fMu50];
 
-	bool isFakeTrigger = false;
-        for (auto& trigObj : event.triggerObjects.filterObjects("hltL3fL1sMu5L1f0L2f5L3Filtered8TkIsoFiltered0p4")) { // HLT_Mu8_TrkIsoVVL
-         if (trigObj->pt() > 0 && mu->pt() > 0 && trigObj->dR(*mu) < 0.1) isFakeTrigger = true;
-        }
-	if(isFakeTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltL3fL1sMu1lqL1f0L2f10L3Filtered17TkIsoFiltered0p4")) { // HLT_Mu17_TrkIsoVVL
-           if (trigObj->pt() > 0 && mu->pt() > 0 && trigObj->dR(*mu) < 0.1) isFakeTrigger = true;
-          }
-	}
+        bool isFakeTrigger = (passedFilters & muFakeTrigFilters)!=0;
 
         if      (lep_counter==1) {
           gt->looseLep1SCEta = mu->pfPt; // sure, it is a hack!
@@ -2340,53 +2320,12 @@ void PandaLeptonicAnalyzer::Run() {
         bool isMedium = ele->medium;
         bool isTight  = ele->tight;
         bool isDxyz   = ElectronIP(ele->eta(),ele->dxy,ele->dz);
-	bool isTrigger = false;
-
-        for (auto& trigObj : event.triggerObjects.filterObjects("hltEle105CaloIdVTGsfTrkIdTGsfDphiFilter")) { // HLT_Ele105_CaloIdVT_GsfTrkIdT
-         if (trigObj->pt() > 0 && ele->pt() > 0 && trigObj->dR(*ele) < 0.1) isTrigger = true;
-        }
-	if(isTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltEle115CaloIdVTGsfTrkIdTGsfDphiFilter")) { // HLT_Ele115_CaloIdVT_GsfTrkIdT
-           if (trigObj->pt() > 0 && ele->pt() > 0 && trigObj->dR(*ele) < 0.1) isTrigger = true;
-          }
-	}
-	if(isTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltEle25erWPTightGsfTrackIsoFilter")) { // HLT_Ele25_eta2p1_WPTight_Gsf
-           if (trigObj->pt() > 0 && ele->pt() > 0 && trigObj->dR(*ele) < 0.1) isTrigger = true;
-          }
-	}
-	if(isTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltEle27WPTightGsfTrackIsoFilter")) { // HLT_Ele27_WPTight_Gsf
-           if (trigObj->pt() > 0 && ele->pt() > 0 && trigObj->dR(*ele) < 0.1) isTrigger = true;
-          }
-	}
-	if(isTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltEle27erWPTightGsfTrackIsoFilter")) { // HLT_Ele27_eta2p1_WPTight_Gsf
-           if (trigObj->pt() > 0 && ele->pt() > 0 && trigObj->dR(*ele) < 0.1) isTrigger = true;
-          }
-	}
-	if(isTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltEle27erWPLooseGsfTrackIsoFilter")) { // HLT_Ele27_eta2p1_WPLoose_Gsf
-           if (trigObj->pt() > 0 && ele->pt() > 0 && trigObj->dR(*ele) < 0.1) isTrigger = true;
-          }
-	}
+        uint64_t passedFilters = trigObjMatcher.Match(*ele);
+        bool isTrigger = (passedFilters & eleTrigFilters)!=0;
 
         isTrigger = isTrigger || ele->triggerMatch[panda::Electron::fEl25Tight] || ele->triggerMatch[panda::Electron::fEl27Tight] || ele->triggerMatch[panda::Electron::fEl27Loose];
 
-	bool isFakeTrigger = false;
-        for (auto& trigObj : event.triggerObjects.filterObjects("hltEle12PFJet30EleCleaned")) { // HLT_Ele12_CaloIdL_TrackIdL_IsoVL_PFJet30
-         if (trigObj->pt() > 0 && ele->pt() > 0 && trigObj->dR(*ele) < 0.1) isFakeTrigger = true;
-        }
-	if(isFakeTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltEle17PFJet30EleCleaned")) { // HLT_Ele17_CaloIdL_TrackIdL_IsoVL_PFJet30
-           if (trigObj->pt() > 0 && ele->pt() > 0 && trigObj->dR(*ele) < 0.1) isFakeTrigger = true;
-          }
-	}
-	if(isFakeTrigger == false){
-          for (auto& trigObj : event.triggerObjects.filterObjects("hltEle23PFJet30EleCleaned")) { // HLT_Ele23_CaloIdL_TrackIdL_IsoVL_PFJet30
-           if (trigObj->pt() > 0 && ele->pt() > 0 && trigObj->dR(*ele) < 0.1) isFakeTrigger = true;
-          }
-	}
+        bool isFakeTrigger = (passedFilters & eleFakeTrigFilters)!=0;
 
 	if(TMath::Abs(ele->eta()-ele->superCluster->eta) > 0.2) printf("Potential issue ele/sc: dist: %f - %f/%f/%f vs. %f/%f/%f\n",TMath::Abs(ele->eta()-ele->superCluster->eta),ele->pt(),ele->eta(),ele->phi(),ele->superCluster->rawPt,ele->superCluster->eta,ele->superCluster->phi);
         if      (lep_counter==1) {
@@ -2449,6 +2388,8 @@ void PandaLeptonicAnalyzer::Run() {
       ++lep_counter;
     }
 
+    lepArrays.Fill(matchLeps);
+
     tr.TriggerEvent("leptons");
 
     // prefiring weights (photon weights only for 2017)
@@ -2456,7 +2397,12 @@ void PandaLeptonicAnalyzer::Run() {
     gt->sf_l1PrefireUnc = 1.0;
     // photons
     gt->nLoosePhoton = 0;
+    objArrays.Fill(event.photons);
+    lepMask.Reset(objArrays.size());
+    drMatrix.Match(objArrays,lepArrays,0.16,lepMask);
+    int pho_counter=-1;
     for (auto& pho : event.photons) {
+      ++pho_counter;
 
       float pt_pho =TMath::Min(pho.pt(),199.999);
       if (!isData && pho.loose && pho.pt() > 20) {
@@ -2474,7 +2420,7 @@ void PandaLeptonicAnalyzer::Run() {
       float eta = pho.eta(), phi = pho.phi();
       if (pt<20 || fabs(eta)>2.5)
         continue;
-      if (IsMatched(&matchLeps,0.16,eta,phi))
+      if (lepMask.Test(pho_counter))
         continue;
       gt->nLoosePhoton++;
       matchPhos.push_back(&pho);
@@ -2485,6 +2431,8 @@ void PandaLeptonicAnalyzer::Run() {
       }
     }
 
+    phoArrays.Fill(matchVeryLoosePhos);
+
     tr.TriggerEvent("photons");
 
     // first identify interesting jets
@@ -2498,9 +2446,16 @@ void PandaLeptonicAnalyzer::Run() {
     float maxJetEta = 4.7;
     unsigned nJetDPhi = 1;
 
+    objArrays.Fill(*jets);
+    lepMask.Reset(objArrays.size());
+    phoMask.Reset(objArrays.size());
+    drMatrix.Match(objArrays,lepArrays,0.16,lepMask);
+    drMatrix.Match(objArrays,phoArrays,0.16,phoMask);
+    int jet_counter=-1;
     for (auto& jet : *jets) {
+      ++jet_counter;
 
-      if (!IsMatched(&matchVeryLoosePhos,0.16,jet.eta(),jet.phi())) {
+      if (!phoMask.Test(jet_counter)) {
         // prefiring weights
         float theL1Corr = GetCorr(cL1PreFiring,abs(jet.eta()),jet.pt());
         gt->sf_l1Prefire *= (1.0 - theL1Corr);
@@ -2510,7 +2465,7 @@ void PandaLeptonicAnalyzer::Run() {
       // only do eta-phi checks here
       if (abs(jet.eta()) > maxJetEta)
          continue;
-      if (IsMatched(&matchLeps,0.16,jet.eta(),jet.phi()))
+      if (lepMask.Test(jet_counter))
          continue;
 
       bool isLoose = jet.loose;
@@ -2673,14 +2628,19 @@ void PandaLeptonicAnalyzer::Run() {
 
     tr.TriggerEvent("jets");
 
+    objArrays.Fill(event.taus);
+    lepMask.Reset(objArrays.size());
+    drMatrix.Match(objArrays,lepArrays,0.16,lepMask);
+    int tau_counter=-1;
     for (auto& tau : event.taus) {
+      ++tau_counter;
       if (!tau.decayMode || !tau.decayModeNew)
         continue;
       if (!tau.looseIsoMVA)
         continue;
       if (tau.pt()<18 || fabs(tau.eta())>2.3)
         continue;
-      if (IsMatched(&matchLeps,0.16,tau.eta(),tau.phi()))
+      if (lepMask.Test(tau_counter))
         continue;
       gt->nTau++;
     }
@@ -2734,6 +2694,9 @@ void PandaLeptonicAnalyzer::Run() {
       maxQCDscale = (TMath::Abs(1+gt->scale[0])+TMath::Abs(1+gt->scale[1])+TMath::Abs(1+gt->scale[2])+
     		     TMath::Abs(1+gt->scale[3])+TMath::Abs(1+gt->scale[4])+TMath::Abs(1+gt->scale[4]))/6.0;
     }
+    // relative weights of the bank columns, see Init
+    double qcdFactors[8] = {1.0,gt->pdfUp};
+    for(int i=0; i<6; i++) qcdFactors[2+i] = TMath::Abs(1+gt->scale[i])/maxQCDscale;
 
     gt->sf_tt = 1;
     gt->genLep1Pt = 0;
@@ -3092,19 +3055,11 @@ void PandaLeptonicAnalyzer::Run() {
 	  weightEWK = valNum / valDen;
 	}
 
-        hDDilHighPtNN->Fill(ZGenPt,event.weight*weightEWK);
-        hDDilHighPtNN_PDF->Fill(ZGenPt,event.weight*gt->pdfUp*weightEWK);
-        for(int i=0; i<6; i++){
-          hDDilHighPtNN_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale*weightEWK);
-        }
+        bDDilHighPtNN->Fill(ZGenPt,event.weight*weightEWK,qcdFactors);
         hDDilHighPtNoEWKNN->Fill(ZGenPt,event.weight);
 
 	if(the_neuP4.Pt() > 250 && nGoodHighPtCentralGenJets >= 1){
-          hDFidHighPtNN->Fill(ZGenPt,event.weight*weightEWK);
-          hDFidHighPtNN_PDF->Fill(ZGenPt,event.weight*gt->pdfUp*weightEWK);
-          for(int i=0; i<6; i++){
-            hDFidHighPtNN_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale*weightEWK);
-          }
+          bDFidHighPtNN->Fill(ZGenPt,event.weight*weightEWK,qcdFactors);
         }
 
       }
@@ -3126,14 +3081,8 @@ void PandaLeptonicAnalyzer::Run() {
 	    if(valNum > 0.0 && valDen > 0.0){
 	      weightEWK = valNum / valDen;
 	    }
-            if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilHighPtIncMM->Fill(ZGenPt,event.weight*weightEWK);
-            else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilHighPtIncEE->Fill(ZGenPt,event.weight*weightEWK);
-            if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilHighPtIncMM_PDF->Fill(ZGenPt,event.weight*gt->pdfUp*weightEWK);
-            else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilHighPtIncEE_PDF->Fill(ZGenPt,event.weight*gt->pdfUp*weightEWK);
-            for(int i=0; i<6; i++){
-              if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilHighPtIncMM_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale*weightEWK);
-              else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilHighPtIncEE_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale*weightEWK);
-            }
+            if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) bDDilHighPtIncMM->Fill(ZGenPt,event.weight*weightEWK,qcdFactors);
+            else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) bDDilHighPtIncEE->Fill(ZGenPt,event.weight*weightEWK,qcdFactors);
 	  }
         }
       }
@@ -3176,106 +3125,40 @@ void PandaLeptonicAnalyzer::Run() {
 	    if(valNum > 0.0 && valDen > 0.0){
 	      weightEWK = valNum / valDen;
 	    }
-            if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilHighPtMM->Fill(ZGenPt,event.weight*weightEWK);
-            else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilHighPtEE->Fill(ZGenPt,event.weight*weightEWK);
-            if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilHighPtMM_PDF->Fill(ZGenPt,event.weight*gt->pdfUp*weightEWK);
-            else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilHighPtEE_PDF->Fill(ZGenPt,event.weight*gt->pdfUp*weightEWK);
-            for(int i=0; i<6; i++){
-              if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilHighPtMM_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale*weightEWK);
-              else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilHighPtEE_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale*weightEWK);
-            }
+            if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) bDDilHighPtMM->Fill(ZGenPt,event.weight*weightEWK,qcdFactors);
+            else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) bDDilHighPtEE->Fill(ZGenPt,event.weight*weightEWK,qcdFactors);
             if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilHighPtNoEWKMM->Fill(ZGenPt,event.weight);
             else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilHighPtNoEWKEE->Fill(ZGenPt,event.weight);
 	  }
 
-	  if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtMM->Fill(ZGenPt,event.weight);
-	  else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtEE->Fill(ZGenPt,event.weight);
-	  if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPhiStarMM->Fill(the_phi_star_eta,event.weight);
-	  else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPhiStarEE->Fill(the_phi_star_eta,event.weight);
-
-	  if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtMM_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-	  else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtEE_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-	  if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPhiStarMM_PDF->Fill(the_phi_star_eta,event.weight*gt->pdfUp);
-	  else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPhiStarEE_PDF->Fill(the_phi_star_eta,event.weight*gt->pdfUp);
-
-          for(int i=0; i<6; i++){
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtMM_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtEE_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPhiStarMM_QCDPart[i]->Fill(the_phi_star_eta,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPhiStarEE_QCDPart[i]->Fill(the_phi_star_eta,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-          }
+	  if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) bDDilPtMM->Fill(ZGenPt,event.weight,qcdFactors);
+	  else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) bDDilPtEE->Fill(ZGenPt,event.weight,qcdFactors);
+	  if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) bDDilPhiStarMM->Fill(the_phi_star_eta,event.weight,qcdFactors);
+	  else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) bDDilPhiStarEE->Fill(the_phi_star_eta,event.weight,qcdFactors);
 
 	  if(ZGenRap < 2.4) {
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilRapMM->Fill(ZGenRap,event.weight);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilRapEE->Fill(ZGenRap,event.weight);
-
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilRapMM_PDF->Fill(ZGenRap,event.weight*gt->pdfUp);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilRapEE_PDF->Fill(ZGenRap,event.weight*gt->pdfUp);
-
-            for(int i=0; i<6; i++){
-	      if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilRapMM_QCDPart[i]->Fill(ZGenRap,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-	      else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilRapEE_QCDPart[i]->Fill(ZGenRap,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) bDDilRapMM->Fill(ZGenRap,event.weight,qcdFactors);
+	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) bDDilRapEE->Fill(ZGenRap,event.weight,qcdFactors);
 	  }
 	  if     (ZGenRap < 0.4) {
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap0MM->Fill(ZGenPt,event.weight);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap0EE->Fill(ZGenPt,event.weight);
-
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap0MM_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap0EE_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-
-            for(int i=0; i<6; i++){
-	      if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap0MM_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-	      else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap0EE_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) bDDilPtRap0MM->Fill(ZGenPt,event.weight,qcdFactors);
+	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) bDDilPtRap0EE->Fill(ZGenPt,event.weight,qcdFactors);
 	  }
 	  else if(ZGenRap < 0.8) {
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap1MM->Fill(ZGenPt,event.weight);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap1EE->Fill(ZGenPt,event.weight);
-
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap1MM_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap1EE_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-
-            for(int i=0; i<6; i++){
-	      if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap1MM_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-	      else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap1EE_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) bDDilPtRap1MM->Fill(ZGenPt,event.weight,qcdFactors);
+	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) bDDilPtRap1EE->Fill(ZGenPt,event.weight,qcdFactors);
 	  }
 	  else if(ZGenRap < 1.2) {
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap2MM->Fill(ZGenPt,event.weight);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap2EE->Fill(ZGenPt,event.weight);
-
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap2MM_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap2EE_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-
-            for(int i=0; i<6; i++){
-	      if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap2MM_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-	      else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap2EE_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) bDDilPtRap2MM->Fill(ZGenPt,event.weight,qcdFactors);
+	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) bDDilPtRap2EE->Fill(ZGenPt,event.weight,qcdFactors);
 	  }
 	  else if(ZGenRap < 1.6) {
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap3MM->Fill(ZGenPt,event.weight);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap3EE->Fill(ZGenPt,event.weight);
-
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap3MM_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap3EE_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-
-            for(int i=0; i<6; i++){
-	      if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap3MM_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-	      else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap3EE_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) bDDilPtRap3MM->Fill(ZGenPt,event.weight,qcdFactors);
+	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) bDDilPtRap3EE->Fill(ZGenPt,event.weight,qcdFactors);
 	  }
 	  else if(ZGenRap < 2.4) {
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap4MM->Fill(ZGenPt,event.weight);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap4EE->Fill(ZGenPt,event.weight);
-
-	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap4MM_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap4EE_PDF->Fill(ZGenPt,event.weight*gt->pdfUp);
-
-            for(int i=0; i<6; i++){
-	      if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) hDDilPtRap4MM_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-	      else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) hDDilPtRap4EE_QCDPart[i]->Fill(ZGenPt,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+	    if     (TMath::Abs(gt->genLep1PdgId) == 13 && TMath::Abs(gt->genLep2PdgId) == 13) bDDilPtRap4MM->Fill(ZGenPt,event.weight,qcdFactors);
+	    else if(TMath::Abs(gt->genLep1PdgId) == 11 && TMath::Abs(gt->genLep2PdgId) == 11) bDDilPtRap4EE->Fill(ZGenPt,event.weight,qcdFactors);
 	  }
 	}
       }
@@ -3298,47 +3181,16 @@ void PandaLeptonicAnalyzer::Run() {
           double mjj = TMath::Min((double)mJJGen,1999.999);
           double ptl1 = TMath::Min(TMath::Max((double)gt->genLep1Pt,(double)gt->genLep2Pt),299.999);
 
-          hDSSWWMJJQCD->Fill(mjj,event.weight*theSSWWEWKCorr[2]);
-          hDSSWWMJJQCD_PDF->Fill(mjj,event.weight*gt->pdfUp*theSSWWEWKCorr[2]);
-          for(int i=0; i<6; i++){
-            hDSSWWMJJQCD_QCDPart[i]->Fill(mjj,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale*theSSWWEWKCorr[2]);
-          }
-
-          hDSSWWMJJ->Fill(mjj,event.weight*theSSWWEWKCorr[0]);
-          hDSSWWMJJ_PDF->Fill(mjj,event.weight*gt->pdfUp*theSSWWEWKCorr[0]);
-          for(int i=0; i<6; i++){
-            hDSSWWMJJ_QCDPart[i]->Fill(mjj,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale*theSSWWEWKCorr[0]);
-          }
-
-          hDSSWWMLL->Fill(mll,event.weight*theSSWWEWKCorr[1]);
-          hDSSWWMLL_PDF->Fill(mll,event.weight*gt->pdfUp*theSSWWEWKCorr[1]);
-          for(int i=0; i<6; i++){
-            hDSSWWMLL_QCDPart[i]->Fill(mll,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale*theSSWWEWKCorr[1]);
-          }
+          bDSSWWMJJQCD->Fill(mjj,event.weight*theSSWWEWKCorr[2],qcdFactors);
+          bDSSWWMJJ->Fill(mjj,event.weight*theSSWWEWKCorr[0],qcdFactors);
 
-          hDSSWWPTL1->Fill(ptl1,event.weight*theSSWWEWKCorr[1]);
-          hDSSWWPTL1_PDF->Fill(ptl1,event.weight*gt->pdfUp*theSSWWEWKCorr[1]);
-          for(int i=0; i<6; i++){
-            hDSSWWPTL1_QCDPart[i]->Fill(ptl1,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale*theSSWWEWKCorr[1]);
-          }
-
-          hDNoEWKCorrSSWWMJJ->Fill(mjj,event.weight);
-          hDNoEWKCorrSSWWMJJ_PDF->Fill(mjj,event.weight*gt->pdfUp);
-          for(int i=0; i<6; i++){
-            hDNoEWKCorrSSWWMJJ_QCDPart[i]->Fill(mjj,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-          }
+          bDSSWWMLL->Fill(mll,event.weight*theSSWWEWKCorr[1],qcdFactors);
+          bDSSWWPTL1->Fill(ptl1,event.weight*theSSWWEWKCorr[1],qcdFactors);
 
-          hDNoEWKCorrSSWWMLL->Fill(mll,event.weight);
-          hDNoEWKCorrSSWWMLL_PDF->Fill(mll,event.weight*gt->pdfUp);
-          for(int i=0; i<6; i++){
-            hDNoEWKCorrSSWWMLL_QCDPart[i]->Fill(mll,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-          }
+          bDNoEWKCorrSSWWMJJ->Fill(mjj,event.weight,qcdFactors);
+          bDNoEWKCorrSSWWMLL->Fill(mll,event.weight,qcdFactors);
 
-          hDNoEWKCorrSSWWPTL1->Fill(ptl1,event.weight);
-          hDNoEWKCorrSSWWPTL1_PDF->Fill(ptl1,event.weight*gt->pdfUp);
-          for(int i=0; i<6; i++){
-            hDNoEWKCorrSSWWPTL1_QCDPart[i]->Fill(ptl1,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-          }
+          bDNoEWKCorrSSWWPTL1->Fill(ptl1,event.weight,qcdFactors);
 	} // mll>20
       }
       double theWZEWKCorr = 1;
@@ -3371,16 +3223,8 @@ void PandaLeptonicAnalyzer::Run() {
         if(fabs(mllZ-91.1876) < 15) {
           double mjj = TMath::Min((double)mJJGen,1999.999);
 
-          hDWZMJJ->Fill(mjj,event.weight*theWZEWKCorr);
-          hDWZMJJ_PDF->Fill(mjj,event.weight*gt->pdfUp*theWZEWKCorr);
-          for(int i=0; i<6; i++){
-            hDWZMJJ_QCDPart[i]->Fill(mjj,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale*theWZEWKCorr);
-          }
-          hDNoEWKCorrWZMJJ->Fill(mjj,event.weight);
-          hDNoEWKCorrWZMJJ_PDF->Fill(mjj,event.weight*gt->pdfUp);
-          for(int i=0; i<6; i++){
-            hDNoEWKCorrWZMJJ_QCDPart[i]->Fill(mjj,event.weight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-          }
+          bDWZMJJ->Fill(mjj,event.weight*theWZEWKCorr,qcdFactors);
+          bDNoEWKCorrWZMJJ->Fill(mjj,event.weight,qcdFactors);
 	} // |mll-mZ|<15
       }
 
@@ -3418,83 +3262,36 @@ void PandaLeptonicAnalyzer::Run() {
 	double dphill = TMath::Abs(genlep1.DeltaPhi(genlep2));
 	double ptll   = TMath::Min((double)dilep.Pt(),299.999);
 	double wwWeight = event.weight * theWWEWKCorr * theWWQCDCorr[0];
+	double wwFactors[12];
+	std::copy(qcdFactors,qcdFactors+8,wwFactors);
+	for(int i=0; i<4; i++) wwFactors[8+i] = theWWQCDCorr[i+1];
 	if(mll > 20.0 && ptll > 30.0) {
           if(the_rhoP4.Pt() >= 0) hDWWPTWW->Fill(the_rhoP4.Pt(),wwWeight);
 	  // MLL
-          hDWWMLL    ->Fill(mll,wwWeight);
-	  hDWWMLL_PDF->Fill(mll,wwWeight*gt->pdfUp);
-	  for(int i=0; i<4; i++) hDWWMLL_NNLOPart[i]->Fill(mll,wwWeight*theWWQCDCorr[i+1]);
-          for(int i=0; i<6; i++){
-	    hDWWMLL_QCDPart[i]->Fill(mll,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-          }
+          bDWWMLL->Fill(mll,wwWeight,wwFactors);
 	  if(targetsJet4p5.size() == 0){
-            hDWWMLL0JET    ->Fill(mll,wwWeight);
-	    hDWWMLL0JET_PDF->Fill(mll,wwWeight*gt->pdfUp);
-	    for(int i=0; i<4; i++) hDWWMLL0JET_NNLOPart[i]->Fill(mll,wwWeight*theWWQCDCorr[i+1]);
-            for(int i=0; i<6; i++){
-	      hDWWMLL0JET_QCDPart[i]->Fill(mll,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+            bDWWMLL0JET->Fill(mll,wwWeight,wwFactors);
 	  }
 	  // PTL1
 	  if(ptl1 > 25.0) {
-            hDWWPTL1    ->Fill(ptl1,wwWeight);
-	    hDWWPTL1_PDF->Fill(ptl1,wwWeight*gt->pdfUp);
-	    for(int i=0; i<4; i++) hDWWPTL1_NNLOPart[i]->Fill(ptl1,wwWeight*theWWQCDCorr[i+1]);
-            for(int i=0; i<6; i++){
-	      hDWWPTL1_QCDPart[i]->Fill(ptl1,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+            bDWWPTL1->Fill(ptl1,wwWeight,wwFactors);
 	    if(targetsJet4p5.size() == 0){
-              hDWWPTL10JET    ->Fill(ptl1,wwWeight);
-	      hDWWPTL10JET_PDF->Fill(ptl1,wwWeight*gt->pdfUp);
-	      for(int i=0; i<4; i++) hDWWPTL10JET_NNLOPart[i]->Fill(ptl1,wwWeight*theWWQCDCorr[i+1]);
-              for(int i=0; i<6; i++){
-		hDWWPTL10JET_QCDPart[i]->Fill(ptl1,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-              }
+              bDWWPTL10JET->Fill(ptl1,wwWeight,wwFactors);
             }
           }
 	  // PTL2
 	  if(ptl2 > 25.0) {
-            hDWWPTL2    ->Fill(ptl2,wwWeight);
-	    hDWWPTL2_PDF->Fill(ptl2,wwWeight*gt->pdfUp);
-	    for(int i=0; i<4; i++) hDWWPTL2_NNLOPart[i]->Fill(ptl2,wwWeight*theWWQCDCorr[i+1]);
-            for(int i=0; i<6; i++){
-	      hDWWPTL2_QCDPart[i]->Fill(ptl2,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+            bDWWPTL2->Fill(ptl2,wwWeight,wwFactors);
 	    if(targetsJet4p5.size() == 0){
-              hDWWPTL20JET    ->Fill(ptl2,wwWeight);
-	      hDWWPTL20JET_PDF->Fill(ptl2,wwWeight*gt->pdfUp);
-	      for(int i=0; i<4; i++) hDWWPTL20JET_NNLOPart[i]->Fill(ptl2,wwWeight*theWWQCDCorr[i+1]);
-              for(int i=0; i<6; i++){
-		hDWWPTL20JET_QCDPart[i]->Fill(ptl2,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-              }
+              bDWWPTL20JET->Fill(ptl2,wwWeight,wwFactors);
             }
 	  }
 	  // DPHILL && PTLL
-          hDWWDPHILL    ->Fill(dphill,wwWeight);
-	  hDWWDPHILL_PDF->Fill(dphill,wwWeight*gt->pdfUp);
-	  for(int i=0; i<4; i++) hDWWDPHILL_NNLOPart[i]->Fill(dphill,wwWeight*theWWQCDCorr[i+1]);
-          for(int i=0; i<6; i++){
-	    hDWWDPHILL_QCDPart[i]->Fill(dphill,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-          }
-          hDWWPTLL    ->Fill(ptll,wwWeight);
-	  hDWWPTLL_PDF->Fill(ptll,wwWeight*gt->pdfUp);
-	  for(int i=0; i<4; i++) hDWWPTLL_NNLOPart[i]->Fill(ptll,wwWeight*theWWQCDCorr[i+1]);
-          for(int i=0; i<6; i++){
-	    hDWWPTLL_QCDPart[i]->Fill(ptll,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-          }
+          bDWWDPHILL->Fill(dphill,wwWeight,wwFactors);
+          bDWWPTLL->Fill(ptll,wwWeight,wwFactors);
 	  if(targetsJet4p5.size() == 0){
-            hDWWDPHILL0JET    ->Fill(dphill,wwWeight);
-	    hDWWDPHILL0JET_PDF->Fill(dphill,wwWeight*gt->pdfUp);
-	    for(int i=0; i<4; i++) hDWWDPHILL0JET_NNLOPart[i]->Fill(dphill,wwWeight*theWWQCDCorr[i+1]);
-            for(int i=0; i<6; i++){
-	      hDWWDPHILL0JET_QCDPart[i]->Fill(dphill,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
-            hDWWPTLL0JET    ->Fill(ptll,wwWeight);
-	    hDWWPTLL0JET_PDF->Fill(ptll,wwWeight*gt->pdfUp);
-	    for(int i=0; i<4; i++) hDWWPTLL0JET_NNLOPart[i]->Fill(ptll,wwWeight*theWWQCDCorr[i+1]);
-            for(int i=0; i<6; i++){
-	      hDWWPTLL0JET_QCDPart[i]->Fill(ptll,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+            bDWWDPHILL0JET->Fill(dphill,wwWeight,wwFactors);
+            bDWWPTLL0JET->Fill(ptll,wwWeight,wwFactors);
           }
 	  // NJET
           hDWWNJET    ->Fill(TMath::Min((double)nGoodCentralGenJets,2.499),wwWeight);
@@ -3504,44 +3301,19 @@ void PandaLeptonicAnalyzer::Run() {
 	    hDWWNJET_QCDPart[i]->Fill(TMath::Min((double)nGoodCentralGenJets,2.499),wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
           }
 	  if(nGoodGenJets[0] == 0) {
-            hDWWN0JET    ->Fill(0.0,wwWeight);
-	    hDWWN0JET_PDF->Fill(0.0,wwWeight*gt->pdfUp);
-	    for(int i=0; i<4; i++) hDWWN0JET_NNLOPart[i]->Fill(0.0,wwWeight*theWWQCDCorr[i+1]);
-            for(int i=0; i<6; i++){
-	      hDWWN0JET_QCDPart[i]->Fill(0.0,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+            bDWWN0JET->Fill(0.0,wwWeight,wwFactors);
 	  }
 	  if(nGoodGenJets[1] == 0) {
-            hDWWN0JET    ->Fill(1.0,wwWeight);
-	    hDWWN0JET_PDF->Fill(1.0,wwWeight*gt->pdfUp);
-	    for(int i=0; i<4; i++) hDWWN0JET_NNLOPart[i]->Fill(1.0,wwWeight*theWWQCDCorr[i+1]);
-            for(int i=0; i<6; i++){
-	      hDWWN0JET_QCDPart[i]->Fill(1.0,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+            bDWWN0JET->Fill(1.0,wwWeight,wwFactors);
 	  }
 	  if(nGoodGenJets[2] == 0) {
-            hDWWN0JET    ->Fill(2.0,wwWeight);
-	    hDWWN0JET_PDF->Fill(2.0,wwWeight*gt->pdfUp);
-	    for(int i=0; i<4; i++) hDWWN0JET_NNLOPart[i]->Fill(2.0,wwWeight*theWWQCDCorr[i+1]);
-            for(int i=0; i<6; i++){
-	      hDWWN0JET_QCDPart[i]->Fill(2.0,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+            bDWWN0JET->Fill(2.0,wwWeight,wwFactors);
 	  }
 	  if(nGoodGenJets[3] == 0) {
-            hDWWN0JET    ->Fill(3.0,wwWeight);
-	    hDWWN0JET_PDF->Fill(3.0,wwWeight*gt->pdfUp);
-	    for(int i=0; i<4; i++) hDWWN0JET_NNLOPart[i]->Fill(3.0,wwWeight*theWWQCDCorr[i+1]);
-            for(int i=0; i<6; i++){
-	      hDWWN0JET_QCDPart[i]->Fill(3.0,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+            bDWWN0JET->Fill(3.0,wwWeight,wwFactors);
 	  }
 	  if(nGoodGenJets[4] == 0) {
-            hDWWN0JET    ->Fill(4.0,wwWeight);
-	    hDWWN0JET_PDF->Fill(4.0,wwWeight*gt->pdfUp);
-	    for(int i=0; i<4; i++) hDWWN0JET_NNLOPart[i]->Fill(4.0,wwWeight*theWWQCDCorr[i+1]);
-            for(int i=0; i<6; i++){
-	      hDWWN0JET_QCDPart[i]->Fill(4.0,wwWeight*TMath::Abs(1+gt->scale[i])/maxQCDscale);
-            }
+            bDWWN0JET->Fill(4.0,wwWeight,wwFactors);
 	  }
 	} // mll > 20
       } // End of filling WW info at gen level
@@ -3640,6 +3412,18 @@ void PandaLeptonicAnalyzer::Run() {
     tr.TriggerEvent("presel");
 
     if (!isData) {
+      // cleaned30Jets is a subset of cleaned20Jets, so one labelling covers both
+      flavourLabeller.SetGhosts(event.genParticles);
+      bool jetConstituents = flags["ghostConstituents"] && event.pfCandidates.size()>0;
+      flavourLabeller.ClearJets();
+      for (auto *jet : cleaned20Jets) {
+        if (jetConstituents)
+          flavourLabeller.AddJet(jet->pt(),jet->eta(),jet->phi(),jet->constituents,false);
+        else
+          flavourLabeller.AddJet(jet->pt(),jet->eta(),jet->phi());
+      }
+      flavourLabeller.Label(0.4,fastjet::antikt_algorithm);
+
       // now get the jet btag SFs
       vector<btagcand> btagcands;
       vector<double> sf_cent, sf_bUp, sf_bDown, sf_mUp, sf_mDown;
@@ -3648,23 +3432,9 @@ void PandaLeptonicAnalyzer::Run() {
       unsigned int nJ = cleaned30Jets.size();
       for (unsigned int iJ=0; iJ!=nJ; ++iJ) {
         panda::Jet *jet = cleaned30Jets.at(iJ);
-        int flavor=0;
-        float genpt=0;
-        for (auto& gen : event.genParticles) {
-          int apdgid = abs(gen.pdgid);
-          if (apdgid==0 || (apdgid>5 && apdgid!=21)) // light quark or gluon
-            continue;
-          double dr2 = DeltaR2(jet->eta(),jet->phi(),gen.eta(),gen.phi());
-          if (dr2<0.09) {
-            genpt = gen.pt();
-            if (apdgid==4 || apdgid==5) {
-              flavor=apdgid;
-              break;
-            } else {
-              flavor=0;
-            }
-          }
-        } // finding the jet flavor
+        unsigned iJ20 = std::find(cleaned20Jets.begin(),cleaned20Jets.end(),jet) - cleaned20Jets.begin();
+        int flavor = flavourLabeller.GetFlavour(iJ20);
+        float genpt = flavourLabeller.GetGenPt(iJ20);
         float pt = jet->pt();
         float btagUncFactor = 1;
         float eta = jet->eta();
@@ -3698,24 +3468,7 @@ void PandaLeptonicAnalyzer::Run() {
       unsigned int nJ20 = cleaned20Jets.size();
       for (unsigned int iJ=0; iJ!=nJ20; ++iJ) {
         panda::Jet *jet = cleaned20Jets.at(iJ);
-        // Need to repeat the operation since these are different jets
-        int flavor=0;
-        float genpt=0;
-        for (auto& gen : event.genParticles) {
-          int apdgid = abs(gen.pdgid);
-          if (apdgid==0 || (apdgid>5 && apdgid!=21)) // light quark or gluon
-            continue;
-          double dr2 = DeltaR2(jet->eta(),jet->phi(),gen.eta(),gen.phi());
-          if (dr2<0.09) {
-            genpt = gen.pt();
-            if (apdgid==4 || apdgid==5) {
-              flavor=apdgid;
-              break;
-            } else {
-              flavor=0;
-            }
-          }
-        } // finding the jet flavor
+        int flavor = flavourLabeller.GetFlavour(iJ);
         float pt = jet->pt();
         float btagUncFactor = 1;
         float eta = jet->eta();
@@ -3757,6 +3510,8 @@ void PandaLeptonicAnalyzer::Run() {
 
   } // entry loop
 
+  if (skipBadLumis)
+    PInfo("PandaLeptonicAnalyzer::Run",TString::Format("Skipped %lld entries in lumis failing the JSON",lumiIndex.GetNSkipped()));
   if (DEBUG) { PDebug("PandaLeptonicAnalyzer::Run","Done with entry loop"); }
 
 } // Run()
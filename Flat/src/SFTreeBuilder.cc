@@ -16,6 +16,7 @@ SFTreeBuilder::~SFTreeBuilder() {
   for (auto *t : taggerTFs)
     delete t;
   delete taggerVals;
+  delete writer;
 }
 
 void SFTreeBuilder::ResetBranches() {
@@ -63,6 +64,8 @@ void SFTreeBuilder::AddTagger(TString inName, TString outName) {
 }
 
 void SFTreeBuilder::Terminate() {
+  if (writer)
+    writer->Finish();
   fOut->WriteTObject(tOut);
   fOut->Close();
 }
@@ -70,6 +73,11 @@ void SFTreeBuilder::Terminate() {
 // run
 void SFTreeBuilder::Run() {
 
+  if (nWriterRows>0 && !writer) {
+    writer = new AsyncTreeWriter(tOut,nWriterRows);
+    writer->Start();
+  }
+
   for (TTree *tIn : processes) {
     pid++;
 
@@ -143,7 +151,10 @@ void SFTreeBuilder::Run() {
 
       tr.TriggerEvent("taggers");
 
-      tOut->Fill();
+      if (writer)
+        writer->Fill();
+      else
+        tOut->Fill();
     }
 
     for (auto *t : taggerTFs)
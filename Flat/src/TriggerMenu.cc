@@ -0,0 +1,72 @@
+#include "../interface/TriggerMenu.h"
+#include <algorithm>
+
+void TriggerMenu::AddPath(unsigned groupBit, TString path, unsigned token)
+{
+	unsigned iP = std::find(paths.begin(),paths.end(),path) - paths.begin();
+	if (iP==paths.size()) {
+		paths.push_back(path);
+		tokens.push_back(token);
+	}
+
+	auto group = std::find_if(groupPaths.begin(),groupPaths.end(),
+	                          [groupBit](const std::pair<unsigned,std::vector<unsigned>> &g)->bool {
+	                            return g.first==groupBit;
+	                          });
+	if (group==groupPaths.end()) {
+		groupPaths.emplace_back(groupBit,std::vector<unsigned>());
+		group = groupPaths.end()-1;
+	}
+	group->second.push_back(iP);
+	compiled = false;
+}
+
+void TriggerMenu::Compile()
+{
+	nWords = (paths.size()+63)/64;
+	fired.assign(nWords,0);
+	groupMasks.clear();
+	for (auto &g : groupPaths) {
+		std::vector<uint64_t> mask(nWords,0);
+		for (auto iP : g.second)
+			mask[iP>>6] |= (uint64_t(1)<<(iP&63));
+		groupMasks.emplace_back(g.first,mask);
+	}
+	for (auto &r : firedPerRun)
+		r.second.resize(nWords,0);
+	compiled = true;
+}
+
+void TriggerMenu::NewRun(int run)
+{
+	currentRun = run;
+	std::vector<uint64_t> &runFired = firedPerRun[run];
+	runFired.resize(nWords,0);
+}
+
+std::vector<TString> TriggerMenu::GetDeadPaths(int run) const
+{
+	std::vector<uint64_t> any(nWords,0);
+	for (auto &r : firedPerRun) {
+		if (run>=0 && r.first!=run)
+			continue;
+		for (unsigned iW=0; iW!=nWords && iW<r.second.size(); ++iW)
+			any[iW] |= r.second[iW];
+	}
+
+	std::vector<TString> dead;
+	unsigned nP = paths.size();
+	for (unsigned iP=0; iP!=nP; ++iP) {
+		if (iP>=nWords*64 || !Test(any,iP))
+			dead.push_back(paths[iP]);
+	}
+	return dead;
+}
+
+std::vector<int> TriggerMenu::GetRuns() const
+{
+	std::vector<int> runs;
+	for (auto &r : firedPerRun)
+		runs.push_back(r.first);
+	return runs;
+}
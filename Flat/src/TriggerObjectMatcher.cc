@@ -0,0 +1,28 @@
+#include "../interface/TriggerObjectMatcher.h"
+#include <algorithm>
+
+unsigned TriggerObjectMatcher::AddFilter(TString name)
+{
+	std::string s(name.Data());
+	unsigned id = std::find(names.begin(),names.end(),s) - names.begin();
+	if (id<names.size())
+		return id;
+	if (id>=maxFilters) {
+		PError("TriggerObjectMatcher::AddFilter",
+		       TString::Format("Cannot add %s, already have %u filters",name.Data(),maxFilters));
+		return maxFilters;
+	}
+	names.push_back(s);
+	return id;
+}
+
+uint64_t TriggerObjectMatcher::AddFilters(std::vector<TString> filterNames)
+{
+	uint64_t mask = 0;
+	for (auto &name : filterNames) {
+		unsigned id = AddFilter(name);
+		if (id<maxFilters)
+			mask |= Bit(id);
+	}
+	return mask;
+}
@@ -0,0 +1,67 @@
+#include "../interface/WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned nWorkers_) :
+	nWorkers(std::max(1u,nWorkers_))
+{
+	for (unsigned iW=1; iW<nWorkers; ++iW)
+		threads.emplace_back(&WorkerPool::Loop,this,iW);
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		stop = true;
+	}
+	cvStart.notify_all();
+	for (auto &t : threads)
+		t.join();
+}
+
+void WorkerPool::Run(unsigned n, std::function<void(unsigned)> job)
+{
+	n = std::min(n,nWorkers);
+	if (n==0)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		current = job;
+		nActive = n;
+		nPending = n-1;
+		++generation;
+	}
+	if (n>1)
+		cvStart.notify_all();
+
+	job(0);
+
+	std::unique_lock<std::mutex> lock(mtx);
+	cvDone.wait(lock,[this]{ return nPending==0; });
+}
+
+void WorkerPool::Loop(unsigned iW)
+{
+	unsigned long seen = 0;
+	while (true) {
+		std::function<void(unsigned)> job;
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			cvStart.wait(lock,[this,seen]{ return stop || generation!=seen; });
+			if (stop)
+				return;
+			seen = generation;
+			if (iW>=nActive)
+				continue;
+			job = current;
+		}
+
+		job(iW);
+
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			--nPending;
+		}
+		cvDone.notify_one();
+	}
+}
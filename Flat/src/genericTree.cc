@@ -1,4 +1,41 @@
 #include "../interface/genericTree.h"
+#include "../interface/AsyncTreeWriter.h"
+#include "../interface/NTupleWriter.h"
+#include "PandaCore/Tools/interface/Common.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "RVersion.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+genericTree::~genericTree()
+{
+
+  delete writer;
+  delete ntuple;
+
+}
+
+void *
+genericTree::operator new(size_t size)
+{
+
+  void *p = 0;
+  if (posix_memalign(&p,blockAlignment,size))
+    throw std::bad_alloc();
+  return p;
+
+}
+
+void
+genericTree::operator delete(void *p)
+{
+
+  free(p);
+
+}
 
 void
 genericTree::RemoveBranches(std::vector<TString> droppable, 
@@ -35,7 +72,370 @@ genericTree::Book(TString bname, void *address, TString leaf)
     }
   }
 
-  treePtr->Branch(bname,address,leaf);
+  // precisionEnabled is never set without TLeafF16, see EnablePrecision
+  if (precisionEnabled && leaf.EndsWith("/F") && !leaf.Contains(":")) {
+    for (unsigned iP=0; iP!=precisions.size(); ++iP) {
+      Precision &p = precisions[iP];
+      if (!bname.Contains(p.r))
+        continue;
+      TString dims = leaf(0,leaf.Length()-2);
+      leaf = dims+TString::Format("/f[%g,%g,%i]",p.min,p.max,p.bits);
+      p.branches.push_back(bname);
+      // variable-length arrays are not validated
+      int n = 1;
+      if (dims.Contains("[")) {
+        TString len = dims(dims.Index("[")+1,dims.Length()-dims.Index("[")-2);
+        n = len.IsDigit() ? len.Atoi() : 0;
+      }
+      if (validatePrecision && n>0)
+        reduced.push_back({static_cast<float*>(address),(unsigned)n,iP});
+      break;
+    }
+  }
+
+  TBranch *b = treePtr->Branch(bname,address,leaf);
+  booked.push_back(bname);
+
+  int settings = compression;
+  for (auto &o : r_compression) {
+    if (bname.Contains(o.first)) {
+      settings = o.second;
+      break;
+    }
+  }
+  if (settings>=0)
+    b->SetCompressionSettings(settings);
+
   return true;
 
 }
+
+bool
+genericTree::IsActive(std::vector<TString> patterns) const
+{
+
+  for (auto &p : patterns) {
+    TRegexp r(p);
+    for (auto &bname : booked) {
+      if (bname.Contains(r))
+        return true;
+    }
+  }
+  return false;
+
+}
+
+int
+genericTree::CompressionSettings(TString algorithm, int level)
+{
+
+  // ROOT::ECompressionAlgorithm
+  int algo = -1;
+  algorithm.ToLower();
+  if (algorithm=="zlib")
+    algo = 1;
+  else if (algorithm=="lzma")
+    algo = 2;
+  else if (algorithm=="lz4")
+    algo = 4;
+  else if (algorithm=="zstd")
+    algo = 5;
+  if (algo<0 || level<0 || level>9) {
+    PError("genericTree::CompressionSettings",
+           TString::Format("Unknown compression %s level %i",algorithm.Data(),level));
+    return -1;
+  }
+#if ROOT_VERSION_CODE < ROOT_VERSION(6,14,0)
+  if (algo==4) {
+    PWarning("genericTree::CompressionSettings",
+             TString::Format("LZ4 needs ROOT 6.14, this is %s: downgrading to zlib level %i, "
+                             "which is slower to write and read",ROOT_RELEASE,level));
+    algo = 1;
+  }
+#endif
+#if ROOT_VERSION_CODE < ROOT_VERSION(6,20,0)
+  if (algo==5) {
+    PWarning("genericTree::CompressionSettings",
+             TString::Format("ZSTD needs ROOT 6.20, this is %s: downgrading to zlib level %i",
+                             ROOT_RELEASE,level));
+    algo = 1;
+  }
+#endif
+  return 100*algo+level;
+
+}
+
+bool
+genericTree::SetOutputProfile(TString profile)
+{
+
+  if (profile=="default") {
+    compression = -1;
+    basketBudget = 0;
+  } else if (profile=="fast") {
+    compression = CompressionSettings("lz4",4);
+    basketBudget = defaultBasketBudget;
+  } else if (profile=="archive") {
+    compression = CompressionSettings("lzma",8);
+    basketBudget = defaultBasketBudget;
+  } else {
+    PError("genericTree::SetOutputProfile","Unknown output profile "+profile);
+    return false;
+  }
+  return true;
+
+}
+
+void
+genericTree::AddCompressionOverride(TString pattern, int settings)
+{
+
+  r_compression.emplace_back(TRegexp(pattern),settings);
+
+}
+
+void
+genericTree::SizeBaskets()
+{
+
+  // called before the first entry, when every branch is booked
+  basketsSized = true;
+  if (basketBudget<=0 || !treePtr || ntuple)
+    return;
+
+  // variable-length arrays are counted as one element per entry
+  std::vector<std::pair<TBranch*,Long64_t>> entryBytes;
+  Long64_t totalBytes = 0;
+  for (auto &bname : booked) {
+    TBranch *b = treePtr->GetBranch(bname);
+    if (!b)
+      continue;
+    Long64_t bytes = 0;
+    TObjArray *leaves = b->GetListOfLeaves();
+    for (int iL=0; iL!=leaves->GetEntriesFast(); ++iL) {
+      TLeaf *l = static_cast<TLeaf*>(leaves->At(iL));
+      bytes += l->GetLenType()*l->GetLenStatic();
+    }
+    entryBytes.emplace_back(b,bytes);
+    totalBytes += bytes;
+  }
+  if (totalBytes==0)
+    return;
+
+  // ROOT resizes the baskets again at the first AutoFlush
+  for (auto &eb : entryBytes) {
+    Long64_t basket = basketBudget*eb.second/totalBytes;
+    basket = std::min(std::max(basket,(Long64_t)minBasket),(Long64_t)maxBasket);
+    eb.first->SetBasketSize(basket);
+  }
+
+}
+
+void
+genericTree::PrintBranchSizes() const
+{
+
+  if (!treePtr || ntuple)
+    return;
+
+  struct Size {
+    TString name;
+    Long64_t tot, zip;
+  };
+  std::vector<Size> sizes;
+  Long64_t tot=0, zip=0;
+  for (auto &bname : booked) {
+    TBranch *b = treePtr->GetBranch(bname);
+    if (!b)
+      continue;
+    sizes.push_back({bname,b->GetTotBytes(),b->GetZipBytes()});
+    tot += sizes.back().tot;
+    zip += sizes.back().zip;
+  }
+  std::sort(sizes.begin(),sizes.end(),
+            [](const Size &a, const Size &b)->bool { return a.zip>b.zip; });
+
+  PInfo("genericTree::PrintBranchSizes",
+        TString::Format("%-40s %14s %14s %7s","branch","uncompressed","compressed","ratio"));
+  for (auto &s : sizes) {
+    PInfo("genericTree::PrintBranchSizes",
+          TString::Format("%-40s %14lld %14lld %7.2f",s.name.Data(),s.tot,s.zip,
+                          s.zip>0 ? (double)s.tot/s.zip : 0.));
+  }
+  PInfo("genericTree::PrintBranchSizes",
+        TString::Format("%-40s %14lld %14lld %7.2f","total",tot,zip,zip>0 ? (double)tot/zip : 0.));
+
+}
+
+bool
+genericTree::StartAsyncWriter(unsigned nRows)
+{
+
+  if (!treePtr || writer || ntuple)
+    return false;
+
+  writer = new AsyncTreeWriter(treePtr,nRows);
+  if (!writer->Start()) {
+    delete writer;
+    writer = 0;
+    return false;
+  }
+  return true;
+
+}
+
+bool
+genericTree::StartNTupleOutput(TFile *f, TString name)
+{
+
+  if (!treePtr || writer || ntuple)
+    return false;
+
+  ntuple = new NTupleWriter(treePtr,f,name);
+  if (!ntuple->Open()) {
+    delete ntuple;
+    ntuple = 0;
+    return false;
+  }
+  return true;
+
+}
+
+void
+genericTree::FinishWriting()
+{
+
+  if (writer)
+    writer->Finish();
+  if (ntuple)
+    ntuple->Close();
+
+}
+
+void
+genericTree::FillTree()
+{
+
+  if (!basketsSized)
+    SizeBaskets();
+
+  for (auto &r : reduced) {
+    Precision &p = precisions[r.iP];
+    for (unsigned i=0; i!=r.n; ++i) {
+      float x = r.address[i];
+      double err = std::fabs(Quantize(x,p.min,p.max,p.bits)-x);
+      p.maxAbsErr = std::max(p.maxAbsErr,err);
+      if (x!=0)
+        p.maxRelErr = std::max(p.maxRelErr,err/std::fabs(x));
+    }
+    p.nValues += r.n;
+  }
+
+  if (ntuple)
+    ntuple->Fill();
+  else if (writer)
+    writer->Fill();
+  else
+    treePtr->Fill();
+
+}
+
+bool
+genericTree::HasFloat16()
+{
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,20,0)
+  return true;
+#else
+  return false;
+#endif
+
+}
+
+void
+genericTree::EnablePrecision(bool on)
+{
+
+  if (on && !HasFloat16()) {
+    PError("genericTree::EnablePrecision","Float16_t leaves need ROOT 6.20 or later, keeping full precision");
+    on = false;
+  }
+  precisionEnabled = on;
+
+}
+
+void
+genericTree::SetPrecision(TString pattern, int mantissaBits)
+{
+
+  SetPrecision(pattern,0,0,mantissaBits);
+
+}
+
+void
+genericTree::SetPrecision(TString pattern, double min, double max, int bits)
+{
+
+  // the sign shares a 16-bit word with at most 14 mantissa bits; a range allows up to 32 bits
+  if (bits<2 || bits>((min==max) ? 14 : 32)) {
+    PError("genericTree::SetPrecision",TString::Format("Cannot store %s with %i bits",pattern.Data(),bits));
+    return;
+  }
+  precisions.push_back({pattern,TRegexp(pattern),min,max,bits,{},0,0,0});
+
+}
+
+float
+genericTree::Quantize(float x, double min, double max, int bits)
+{
+
+  // follows TBufferFile::WriteFloat16 and ReadFloat16
+  if (min==max) {
+    union {
+      float f;
+      int i;
+    } v;
+    v.f = x;
+    int exponent = 0xff & ((v.i<<1)>>24);
+    int mantissa = ((1<<(bits+1))-1) & (v.i>>(23-bits-1));
+    mantissa = (mantissa+1)>>1;
+    if (mantissa & (1<<bits))
+      mantissa = (1<<bits)-1;
+    v.i = (exponent<<23) | (mantissa<<(23-bits));
+    return (x<0) ? -v.f : v.f;
+  }
+  double factor = (bits<32) ? (1u<<bits)/(max-min) : 4294967295./(max-min);
+  double clamped = std::min(std::max((double)x,min),max);
+  unsigned stored = 0.5+factor*(clamped-min);
+  return min+stored/factor;
+
+}
+
+void
+genericTree::PrintPrecisionReport() const
+{
+
+  for (auto &p : precisions) {
+    Long64_t tot=0, zip=0;
+    if (treePtr && !ntuple) {
+      for (auto &bname : p.branches) {
+        TBranch *b = treePtr->GetBranch(bname);
+        if (b) {
+          tot += b->GetTotBytes();
+          zip += b->GetZipBytes();
+        }
+      }
+    }
+    TString spec = (p.min==p.max) ? TString::Format("%i mantissa bits",p.bits)
+                                  : TString::Format("[%g,%g] in %i bits",p.min,p.max,p.bits);
+    PInfo("genericTree::PrintPrecisionReport",
+          TString::Format("%-16s %-24s %4u branches %12lld -> %12lld bytes",
+                          p.pattern.Data(),spec.Data(),(unsigned)p.branches.size(),tot,zip));
+    if (p.nValues>0) {
+      PInfo("genericTree::PrintPrecisionReport",
+            TString::Format("%-16s %lld values, max abs error %g, max rel error %g",
+                            p.pattern.Data(),p.nValues,p.maxAbsErr,p.maxRelErr));
+    }
+  }
+
+}
@@ -33,16 +33,20 @@ skimmer.SetFlag('firstGen',False)
 skimmer.SetFlag('applyEGCorr',False)
 skimmer.SetFlag('applyJSON',False)
 skimmer.SetFlag('pfCands',False)
+#skimmer.reclusterMode = root.PandaAnalyzer.kReclusterCone
+#skimmer.SetFlag('recalcECF',True)
+#skimmer.nThreads = 2
+#skimmer.SetFlag('constituents',True); skimmer.constituentFile = 'constituents.npy'
 #skimmer.SetFlag('monohiggs',True)
+#skimmer.SetFlag('genOnly',True)
+#skimmer.SetFlag('ghostConstituents',True) # b/c labels from the jet constituents; reads pfCandidates in MC
+#skimmer.SetFlag('reducedPrecision',True); skimmer.SetFlag('validatePrecision',True) # Float16_t families (ROOT>=6.20) and their rounding error
 if skimmer.isData and False:
-    with open(getenv('CMSSW_BASE')+'/src/PandaAnalysis/data/certs/Cert_271036-284044_13TeV_23Sep2016ReReco_Collisions16_JSON.txt') as jsonFile:
-        payload = json.load(jsonFile)
-        for run,lumis in payload.iteritems():
-            for l in lumis:
-                skimmer.AddGoodLumiRange(int(run),l[0],l[1])
+    skimmer.LoadGoodLumis(getenv('CMSSW_BASE')+'/src/PandaAnalysis/data/certs/Cert_271036-284044_13TeV_23Sep2016ReReco_Collisions16_JSON.txt')
 #skimmer.processType = root.PandaAnalyzer.kTT
 skimmer.processType = root.PandaAnalyzer.kWEWK
 #skimmer.SetPreselectionBit(root.PandaAnalyzer.kFatjet)
+#skimmer.SetFlag('columnPreselection',True) # skip entries failing the recoil/fatjet columns before getEntry
 #system("pxrdcp %s input.root '!pfCandidates'"%(torun))
 #fin = root.TFile.Open('input.root')
 fin = root.TFile.Open(torun)
@@ -56,7 +60,10 @@ print tree, hweights, weights
 
 skimmer.SetDataDir(getenv('CMSSW_BASE')+'/src/PandaAnalysis/data/')
 skimmer.Init(tree,hweights,weights)
-skimmer.SetOutputFile(output)
+# skimmer.AddCompressionOverride('^fj1Const','lzma',8)
+# skimmer.nWriterRows = 256 # fill the output tree from a background thread
+# skimmer.ntupleOutput = True # write events as an RNTuple (ROOT>=6.32); compare reads with readBench
+skimmer.SetOutputFile(output) # or (output,'fast') for skims that are read again (LZ4 needs ROOT>=6.14, else zlib)
 
 skimmer.Run()
 skimmer.Terminate()
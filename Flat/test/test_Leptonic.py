@@ -31,11 +31,7 @@ skimmer.SetFlag('applyJSON',False)
 skimmer.SetFlag('lepton',True)
 #skimmer.SetFlag('monohiggs',True)
 if skimmer.isData and False:
-    with open(getenv('CMSSW_BASE')+'/src/PandaAnalysis/data/certs/Cert_271036-284044_13TeV_23Sep2016ReReco_Collisions16_JSON.txt') as jsonFile:
-        payload = json.load(jsonFile)
-        for run,lumis in payload.iteritems():
-            for l in lumis:
-                skimmer.AddGoodLumiRange(int(run),l[0],l[1])
+    skimmer.LoadGoodLumis(getenv('CMSSW_BASE')+'/src/PandaAnalysis/data/certs/Cert_271036-284044_13TeV_23Sep2016ReReco_Collisions16_JSON.txt')
 skimmer.processType = root.PandaLeptonicAnalyzer.kNone
 #skimmer.processType = root.PandaLeptonicAnalyzer.kZPtCut
 skimmer.SetPreselectionBit(root.PandaLeptonicAnalyzer.kLepton)
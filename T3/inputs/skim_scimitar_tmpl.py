@@ -114,12 +114,9 @@ def fn(input_name,isData,full_path):
     output_name = input_name.replace('input','output')
     skimmer.SetDataDir(data_dir)
     if isData:
-        with open(data_dir+'/certs/Cert_271036-284044_13TeV_23Sep2016ReReco_Collisions16_JSON.txt') as jsonFile:
-            payload = json.load(jsonFile)
-            for run_str,lumis in payload.iteritems():
-                run = int(run_str)
-                for l in lumis:
-                    skimmer.AddGoodLumiRange(run,l[0],l[1])
+        if not skimmer.LoadGoodLumis(data_dir+'/certs/Cert_271036-284044_13TeV_23Sep2016ReReco_Collisions16_JSON.txt'):
+            PError(sname+'.fn','Failed to load the lumi mask for %s!'%(input_name))
+            return False
     skimmer.SetOutputFile(output_name)
     skimmer.Init(tree,hweights)
 